@@ -5,6 +5,7 @@
 #include "util/asio.h"
 #include "bucket/BucketApplicator.h"
 #include "bucket/Bucket.h"
+#include "database/Database.h"
 #include "ledger/LedgerTxn.h"
 #include "ledger/LedgerTxnEntry.h"
 #include "lib/util/format.h"
@@ -12,49 +13,138 @@
 #include "util/Logging.h"
 #include "util/types.h"
 
+#include <algorithm>
+#include <future>
+
 namespace stellar
 {
 
+// Entries are inserted in larger batches when bulk loading, as each batch
+// then costs one COPY (or INSERT) statement per entry type.
+static const size_t BULK_LOAD_BATCH_SIZE = 16 * LEDGER_ENTRY_BATCH_COMMIT_SIZE;
+
 BucketApplicator::BucketApplicator(Application& app,
                                    uint32_t maxProtocolVersion,
                                    std::shared_ptr<const Bucket> bucket)
-    : mApp(app), mMaxProtocolVersion(maxProtocolVersion), mBucketIter(bucket)
+    : BucketApplicator(app, maxProtocolVersion,
+                       std::vector<std::shared_ptr<const Bucket>>{bucket})
+{
+}
+
+BucketApplicator::BucketApplicator(
+    Application& app, uint32_t maxProtocolVersion,
+    std::vector<std::shared_ptr<const Bucket>> const& buckets, bool bulkLoad)
+    : mApp(app), mMaxProtocolVersion(maxProtocolVersion), mBulkLoad(bulkLoad)
 {
-    auto protocolVersion = mBucketIter.getMetadata().ledgerVersion;
-    if (protocolVersion > mMaxProtocolVersion)
+    if (mBulkLoad)
     {
-        throw std::runtime_error(fmt::format(
-            "bucket protocol version {} exceeds maxProtocolVersion {}",
-            protocolVersion, mMaxProtocolVersion));
+        // Other connections can only write to the tables if they can see
+        // their current state
+        auto& db = mApp.getDatabase();
+        mParallelBulkLoad =
+            !db.isSqlite() && db.canUsePool() && !db.isInTransaction();
+    }
+
+    for (auto const& bucket : buckets)
+    {
+        auto iter = std::make_unique<BucketInputIterator>(bucket);
+        auto protocolVersion = iter->getMetadata().ledgerVersion;
+        if (protocolVersion > mMaxProtocolVersion)
+        {
+            throw std::runtime_error(fmt::format(
+                "bucket protocol version {} exceeds maxProtocolVersion {}",
+                protocolVersion, mMaxProtocolVersion));
+        }
+        mBucketIters.emplace_back(std::move(iter));
     }
 }
 
 BucketApplicator::operator bool() const
 {
-    return (bool)mBucketIter;
+    return std::any_of(mBucketIters.begin(), mBucketIters.end(),
+                       [](std::unique_ptr<BucketInputIterator> const& iter) {
+                           return (bool)*iter;
+                       });
 }
 
 size_t
 BucketApplicator::pos()
 {
-    return mBucketIter.pos();
+    size_t res = 0;
+    for (auto& iter : mBucketIters)
+    {
+        res += iter->pos();
+    }
+    return res;
 }
 
 size_t
 BucketApplicator::size() const
 {
-    return mBucketIter.size();
+    size_t res = 0;
+    for (auto const& iter : mBucketIters)
+    {
+        res += iter->size();
+    }
+    return res;
+}
+
+size_t
+BucketApplicator::shadowed() const
+{
+    return mShadowed;
+}
+
+BucketInputIterator*
+BucketApplicator::nextEntry()
+{
+    // Iterators are ordered from newest to oldest bucket, so on equal keys the
+    // first one found holds the version to apply
+    BucketEntryIdCmp cmp;
+    BucketInputIterator* next = nullptr;
+    for (auto& iter : mBucketIters)
+    {
+        if (*iter && (!next || cmp(**iter, **next)))
+        {
+            next = iter.get();
+        }
+    }
+    return next;
+}
+
+void
+BucketApplicator::advancePast(BucketInputIterator* next)
+{
+    BucketEntryIdCmp cmp;
+    BucketEntry const& e = **next;
+    for (auto& iter : mBucketIters)
+    {
+        if (iter.get() != next && *iter && !cmp(e, **iter))
+        {
+            Bucket::checkProtocolLegality(**iter, mMaxProtocolVersion);
+            ++(*iter);
+            ++mShadowed;
+        }
+    }
+    ++(*next);
 }
 
 size_t
 BucketApplicator::advance(BucketApplicator::Counters& counters)
 {
+    if (mBulkLoad)
+    {
+        return bulkLoad(counters);
+    }
+
     size_t count = 0;
 
     LedgerTxn ltx(mApp.getLedgerTxnRoot(), false);
-    for (; mBucketIter; ++mBucketIter)
+    BucketInputIterator* next;
+    while (count < LEDGER_ENTRY_BATCH_COMMIT_SIZE &&
+           (next = nextEntry()) != nullptr)
     {
-        BucketEntry const& e = *mBucketIter;
+        BucketEntry const& e = **next;
         Bucket::checkProtocolLegality(e, mMaxProtocolVersion);
         counters.mark(e);
         if (e.type() == LIVEENTRY || e.type() == INITENTRY)
@@ -70,18 +160,104 @@ BucketApplicator::advance(BucketApplicator::Counters& counters)
             }
             ltx.eraseWithoutLoading(e.deadEntry());
         }
+        ++count;
+        advancePast(next);
+    }
+    ltx.commit();
 
-        if ((++count > LEDGER_ENTRY_BATCH_COMMIT_SIZE))
+    mCount += count;
+    return count;
+}
+
+size_t
+BucketApplicator::bulkLoad(BucketApplicator::Counters& counters)
+{
+    size_t count = 0;
+
+    std::map<LedgerEntryType, std::vector<LedgerEntry>> entriesByType;
+    BucketInputIterator* next;
+    while (count < BULK_LOAD_BATCH_SIZE && (next = nextEntry()) != nullptr)
+    {
+        BucketEntry const& e = **next;
+        Bucket::checkProtocolLegality(e, mMaxProtocolVersion);
+        counters.mark(e);
+        if (e.type() == LIVEENTRY || e.type() == INITENTRY)
         {
-            break;
+            auto const& entry = e.liveEntry();
+            entriesByType[entry.data.type()].emplace_back(entry);
+        }
+        else if (e.type() != DEADENTRY)
+        {
+            throw std::runtime_error(
+                "Malformed bucket: unexpected non-INIT/LIVE/DEAD entry.");
         }
+        ++count;
+        advancePast(next);
     }
-    ltx.commit();
+    insertEntries(entriesByType);
 
     mCount += count;
     return count;
 }
 
+void
+BucketApplicator::insertEntries(
+    std::map<LedgerEntryType, std::vector<LedgerEntry>> const& entriesByType)
+{
+    auto& root = dynamic_cast<LedgerTxnRoot&>(mApp.getLedgerTxnRoot());
+    auto& db = mApp.getDatabase();
+
+    if (!mParallelBulkLoad)
+    {
+        auto& session = db.getSession();
+        std::unique_ptr<soci::transaction> tx;
+        if (!db.isInTransaction())
+        {
+            tx = std::make_unique<soci::transaction>(session);
+        }
+        for (auto const& kv : entriesByType)
+        {
+            root.bulkInsertEntries(session, kv.second);
+        }
+        if (tx)
+        {
+            tx->commit();
+        }
+        return;
+    }
+
+    // Load each table on its own connection from the pool. The pool is
+    // created lazily by the first call to getPool, which isn't thread-safe,
+    // so get it here rather than on the workers.
+    auto& pool = db.getPool();
+    std::vector<std::future<void>> inserts;
+    for (auto const& kv : entriesByType)
+    {
+        auto const& entries = kv.second;
+        auto task = std::make_shared<std::packaged_task<void()>>(
+            [&root, &pool, &entries]() {
+                soci::session session(pool);
+                soci::transaction tx(session);
+                root.bulkInsertEntries(session, entries);
+                tx.commit();
+            });
+        inserts.emplace_back(task->get_future());
+        mApp.postOnBackgroundThread([task]() { (*task)(); },
+                                    "BucketApplicator: bulk insert");
+    }
+
+    // All inserts refer to `entriesByType`: wait for every one of them before
+    // reporting any failure
+    for (auto& insert : inserts)
+    {
+        insert.wait();
+    }
+    for (auto& insert : inserts)
+    {
+        insert.get();
+    }
+}
+
 BucketApplicator::Counters::Counters(VirtualClock::time_point now)
 {
     reset(now);
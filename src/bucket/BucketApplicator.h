@@ -8,7 +8,9 @@
 #include "bucket/BucketInputIterator.h"
 #include "util/Timer.h"
 #include "util/XDRStream.h"
+#include <map>
 #include <memory>
+#include <vector>
 
 namespace stellar
 {
@@ -18,13 +20,26 @@ class Application;
 // Class that represents a single apply-bucket-to-database operation in
 // progress. Used during history catchup to split up the task of applying
 // bucket into scheduler-friendly, bite-sized pieces.
+//
+// It can also apply several buckets at once, given from newest to oldest. As
+// buckets are sorted by key, it then walks them in lockstep and only applies
+// the newest version of each key, skipping the versions shadowed by newer
+// buckets: each key is written to the database at most once.
+//
+// In bulk load mode, the ledger entry tables must be empty: the newest live
+// entries are then inserted in large batches split by entry type (through
+// COPY on postgres, concurrently on pooled connections when possible), and
+// dead entries are skipped as there is nothing to delete.
 
 class BucketApplicator
 {
     Application& mApp;
     uint32_t mMaxProtocolVersion;
-    BucketInputIterator mBucketIter;
+    std::vector<std::unique_ptr<BucketInputIterator>> mBucketIters;
+    bool const mBulkLoad;
+    bool mParallelBulkLoad{false};
     size_t mCount{0};
+    size_t mShadowed{0};
 
   public:
     class Counters
@@ -57,12 +72,27 @@ class BucketApplicator
                       VirtualClock::time_point now);
     };
 
+  private:
+    BucketInputIterator* nextEntry();
+    void advancePast(BucketInputIterator* next);
+    size_t bulkLoad(Counters& counters);
+    void
+    insertEntries(std::map<LedgerEntryType, std::vector<LedgerEntry>> const&
+                      entriesByType);
+
+  public:
     BucketApplicator(Application& app, uint32_t maxProtocolVersion,
                      std::shared_ptr<const Bucket> bucket);
+    BucketApplicator(Application& app, uint32_t maxProtocolVersion,
+                     std::vector<std::shared_ptr<const Bucket>> const& buckets,
+                     bool bulkLoad = false);
     operator bool() const;
     size_t advance(Counters& counters);
 
     size_t pos();
     size_t size() const;
+
+    // Number of entries skipped so far because a newer bucket shadows them.
+    size_t shadowed() const;
 };
 }
@@ -13,6 +13,7 @@
 #include "util/asio.h"
 #include "bucket/BucketTests.h"
 #include "bucket/Bucket.h"
+#include "bucket/BucketApplicator.h"
 #include "bucket/BucketInputIterator.h"
 #include "ledger/LedgerTxn.h"
 #include "ledger/test/LedgerTestUtils.h"
@@ -931,9 +932,67 @@ TEST_CASE("bucket apply", "[bucket]")
     });
 }
 
+TEST_CASE("bucket bulk load", "[bucket]")
+{
+    VirtualClock clock;
+    Config cfg(getTestConfig());
+    Application::pointer app = createTestApplication(clock, cfg);
+    app->start();
+
+    std::unordered_map<LedgerKey, LedgerEntry> entries;
+    for (auto const& e : LedgerTestUtils::generateValidLedgerEntries(1000))
+    {
+        entries[LedgerEntryKey(e)] = e;
+    }
+    std::vector<LedgerEntry> live;
+    std::vector<LedgerKey> noDead;
+    for (auto const& kv : entries)
+    {
+        live.emplace_back(kv.second);
+    }
+    std::shared_ptr<Bucket> bucket = Bucket::fresh(
+        app->getBucketManager(), getAppLedgerVersion(app), {}, live, noDead,
+        /*countMergeEvents=*/true, /*doFsync=*/true);
+
+    auto& root = app->getLedgerTxnRoot();
+    root.dropAccounts();
+    root.dropTrustLines();
+    root.dropOffers();
+    root.dropData();
+
+    // The bulk load bypasses the caches, which remember that this key was
+    // missing until they are cleared
+    auto missingKey = LedgerEntryKey(live.front());
+    REQUIRE(!root.getNewestVersion(missingKey));
+
+    BucketApplicator applicator(
+        *app, getAppLedgerVersion(app),
+        std::vector<std::shared_ptr<Bucket const>>{bucket}, /*bulkLoad=*/true);
+    BucketApplicator::Counters counters(clock.now());
+    while (applicator)
+    {
+        applicator.advance(counters);
+    }
+
+    uint64_t count = 0;
+    for (auto let : {ACCOUNT, TRUSTLINE, OFFER, DATA})
+    {
+        count += root.countObjects(let);
+    }
+    REQUIRE(count == entries.size());
+    REQUIRE(!root.getNewestVersion(missingKey));
+    dynamic_cast<LedgerTxnRoot&>(root).clearCaches();
+    for (auto const& kv : entries)
+    {
+        auto loaded = root.getNewestVersion(kv.first);
+        REQUIRE(loaded);
+        REQUIRE(*loaded == kv.second);
+    }
+}
+
 TEST_CASE("bucket apply bench", "[bucketbench][!hide]")
 {
-    auto runtest = [](Config::TestDbMode mode) {
+    auto runtest = [](Config::TestDbMode mode, bool bulkLoad) {
         VirtualClock clock;
         Config cfg(getTestConfig(0, mode));
         Application::pointer app = createTestApplication(clock, cfg);
@@ -954,20 +1013,45 @@ TEST_CASE("bucket apply bench", "[bucketbench][!hide]")
             /*countMergeEvents=*/true, /*doFsync=*/true);
 
         CLOG(INFO, "Bucket")
-            << "Applying bucket with " << live.size() << " live entries";
-        // note: we do not wrap the `apply` call inside a transaction
-        // as bucket applicator commits to the database incrementally
-        birth->apply(*app);
+            << "Applying bucket with " << live.size() << " live entries"
+            << (bulkLoad ? " in bulk" : "");
+        if (bulkLoad)
+        {
+            app->getLedgerTxnRoot().dropAccounts();
+            BucketApplicator applicator(
+                *app, getAppLedgerVersion(app),
+                std::vector<std::shared_ptr<Bucket const>>{birth}, true);
+            BucketApplicator::Counters counters(clock.now());
+            while (applicator)
+            {
+                applicator.advance(counters);
+            }
+            counters.logInfo("bulk", 0, clock.now());
+        }
+        else
+        {
+            // note: we do not wrap the `apply` call inside a transaction
+            // as bucket applicator commits to the database incrementally
+            birth->apply(*app);
+        }
     };
 
     SECTION("sqlite")
     {
-        runtest(Config::TESTDB_ON_DISK_SQLITE);
+        runtest(Config::TESTDB_ON_DISK_SQLITE, false);
+    }
+    SECTION("sqlite bulk load")
+    {
+        runtest(Config::TESTDB_ON_DISK_SQLITE, true);
     }
 #ifdef USE_POSTGRES
     SECTION("postgresql")
     {
-        runtest(Config::TESTDB_POSTGRESQL);
+        runtest(Config::TESTDB_POSTGRESQL, false);
+    }
+    SECTION("postgresql bulk load")
+    {
+        runtest(Config::TESTDB_POSTGRESQL, true);
     }
 #endif
 }
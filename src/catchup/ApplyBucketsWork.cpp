@@ -19,9 +19,24 @@
 #include <medida/meter.h>
 #include <medida/metrics_registry.h>
 
+#include <algorithm>
+
 namespace stellar
 {
 
+namespace
+{
+bool
+canApplyNewestFirst(Application& app)
+{
+    // This invariant checks the database against each bucket right after it
+    // is applied, which only holds when applying them from oldest to newest
+    auto invariants = app.getInvariantManager().getEnabledInvariants();
+    return std::find(invariants.begin(), invariants.end(),
+                     "BucketListIsConsistentWithDatabase") == invariants.end();
+}
+}
+
 ApplyBucketsWork::ApplyBucketsWork(
     Application& app,
     std::map<std::string, std::shared_ptr<Bucket>> const& buckets,
@@ -33,6 +48,7 @@ ApplyBucketsWork::ApplyBucketsWork(
     , mTotalSize(0)
     , mLevel(BucketList::kNumLevels - 1)
     , mMaxProtocolVersion(maxProtocolVersion)
+    , mNewestFirst(canApplyNewestFirst(app))
     , mBucketApplyStart(app.getMetrics().NewMeter(
           {"history", "bucket-apply", "start"}, "event"))
     , mBucketApplySuccess(app.getMetrics().NewMeter(
@@ -97,6 +113,24 @@ ApplyBucketsWork::onReset()
     mCurrBucket.reset();
     mSnapApplicator.reset();
     mCurrApplicator.reset();
+    mNewestFirstApplicator.reset();
+    mNewestFirstBuckets = 0;
+    finishBulkLoad();
+}
+
+void
+ApplyBucketsWork::finishBulkLoad()
+{
+    if (mBulkLoading)
+    {
+        CLOG(INFO, "History") << "ApplyBuckets : re-creating indexes";
+        auto& root = dynamic_cast<LedgerTxnRoot&>(mApp.getLedgerTxnRoot());
+        root.createSecondaryIndexes();
+        // Nothing the bulk load wrote went through the caches, which may
+        // have recorded some of those entries as missing in the meantime
+        root.clearCaches();
+        mBulkLoading = false;
+    }
 }
 
 void
@@ -145,6 +179,109 @@ ApplyBucketsWork::startLevel()
     }
 }
 
+void
+ApplyBucketsWork::startNewestFirst()
+{
+    assert(!mApplying);
+
+    // Like startLevel, find the oldest level that differs from the local
+    // bucket list: that level and all newer ones need to be applied
+    bool found = false;
+    bool applySnap = false;
+    for (uint32_t i = BucketList::kNumLevels; i-- > 0;)
+    {
+        auto& level = getBucketLevel(i);
+        HistoryStateBucket const& hsb = mApplyState.currentBuckets.at(i);
+        applySnap = (hsb.snap != binToHex(level.getSnap()->getHash()));
+        if (applySnap || hsb.curr != binToHex(level.getCurr()->getHash()))
+        {
+            mLevel = i;
+            found = true;
+            break;
+        }
+    }
+
+    std::vector<std::shared_ptr<Bucket const>> buckets;
+    if (found)
+    {
+        if (!mApp.getConfig().MODE_USES_IN_MEMORY_LEDGER)
+        {
+            auto ledger = mApplyState.currentLedger;
+            uint32_t oldestLedger =
+                applySnap ? BucketList::oldestLedgerInSnap(ledger, mLevel)
+                          : BucketList::oldestLedgerInCurr(ledger, mLevel);
+            auto& lsRoot = mApp.getLedgerTxnRoot();
+            lsRoot.deleteObjectsModifiedOnOrAfterLedger(oldestLedger);
+
+            // When nothing is left (typically when catching up a new node),
+            // entries can be inserted in bulk rather than upserted one batch
+            // at a time, and indexes only built once they're all in
+            mBulkLoading = true;
+            for (auto let : {ACCOUNT, TRUSTLINE, OFFER, DATA})
+            {
+                mBulkLoading = mBulkLoading && lsRoot.countObjects(let) == 0;
+            }
+            if (mBulkLoading)
+            {
+                CLOG(INFO, "History")
+                    << "ApplyBuckets : bulk loading into empty tables";
+                dynamic_cast<LedgerTxnRoot&>(lsRoot).dropSecondaryIndexes();
+            }
+        }
+
+        for (uint32_t i = 0; i <= mLevel; ++i)
+        {
+            HistoryStateBucket const& hsb = mApplyState.currentBuckets.at(i);
+            buckets.emplace_back(getBucket(hsb.curr));
+            if (i != mLevel || applySnap)
+            {
+                buckets.emplace_back(getBucket(hsb.snap));
+            }
+        }
+        auto isEmpty = [](std::shared_ptr<Bucket const> const& b) {
+            return b->getSize() == 0;
+        };
+        buckets.erase(std::remove_if(buckets.begin(), buckets.end(), isEmpty),
+                      buckets.end());
+    }
+
+    CLOG(DEBUG, "History") << "ApplyBuckets : applying " << buckets.size()
+                           << " buckets newest first, down to level "
+                           << mLevel;
+    mNewestFirstApplicator = std::make_unique<BucketApplicator>(
+        mApp, mMaxProtocolVersion, buckets, mBulkLoading);
+    mNewestFirstBuckets = buckets.size();
+    mBucketApplyStart.Mark(buckets.size());
+    mApplying = true;
+}
+
+BasicWork::State
+ApplyBucketsWork::runNewestFirst()
+{
+    if (!mApplying)
+    {
+        startNewestFirst();
+    }
+
+    if (*mNewestFirstApplicator)
+    {
+        advance("all", *mNewestFirstApplicator);
+        return State::WORK_RUNNING;
+    }
+
+    CLOG(INFO, "History") << "ApplyBuckets : skipped "
+                          << mNewestFirstApplicator->shadowed()
+                          << " shadowed entries";
+    mBucketApplySuccess.Mark(mNewestFirstBuckets);
+    mNewestFirstApplicator.reset();
+    finishBulkLoad();
+
+    CLOG(INFO, "History") << "ApplyBuckets : done, restarting merges";
+    mApp.getBucketManager().assumeState(mApplyState, mMaxProtocolVersion);
+
+    return State::WORK_SUCCESS;
+}
+
 BasicWork::State
 ApplyBucketsWork::onRun()
 {
@@ -158,6 +295,11 @@ ApplyBucketsWork::onRun()
         mHaveCheckedApplyStateValidity = true;
     }
 
+    if (mNewestFirst)
+    {
+        return runNewestFirst();
+    }
+
     // Check if we're at the beginning of the new level
     if (isLevelComplete())
     {
@@ -230,7 +372,7 @@ ApplyBucketsWork::advance(std::string const& bucketName,
     else
     {
         mAppliedSize += (applicator.size() - mLastPos);
-        mAppliedBuckets++;
+        mAppliedBuckets += mNewestFirst ? mNewestFirstBuckets : 1;
         mLastPos = 0;
         log = true;
         mCounters.logInfo(bucketName, mLevel, mApp.getClock().now());
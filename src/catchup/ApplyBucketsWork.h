@@ -42,6 +42,18 @@ class ApplyBucketsWork : public BasicWork
     std::unique_ptr<BucketApplicator> mSnapApplicator;
     std::unique_ptr<BucketApplicator> mCurrApplicator;
 
+    // When set, all the buckets to apply go through a single applicator, from
+    // newest to oldest, so that each key is written once. This is not done
+    // when invariants check the database after each bucket is applied, as
+    // they expect buckets to be applied one at a time from oldest to newest.
+    bool const mNewestFirst;
+    std::unique_ptr<BucketApplicator> mNewestFirstApplicator;
+    size_t mNewestFirstBuckets{0};
+
+    // Set while the buckets are bulk loaded into empty tables, with the
+    // secondary indexes dropped until all entries are in.
+    bool mBulkLoading{false};
+
     medida::Meter& mBucketApplyStart;
     medida::Meter& mBucketApplySuccess;
     medida::Meter& mBucketApplyFailure;
@@ -52,6 +64,9 @@ class ApplyBucketsWork : public BasicWork
     BucketLevel& getBucketLevel(uint32_t level);
     void startLevel();
     bool isLevelComplete();
+    void startNewestFirst();
+    BasicWork::State runNewestFirst();
+    void finishBulkLoad();
 
   public:
     ApplyBucketsWork(
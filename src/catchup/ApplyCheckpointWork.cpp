@@ -24,9 +24,9 @@
 namespace stellar
 {
 
-ApplyCheckpointWork::ApplyCheckpointWork(Application& app,
-                                         TmpDir const& downloadDir,
-                                         LedgerRange const& range)
+ApplyCheckpointWork::ApplyCheckpointWork(
+    Application& app, TmpDir const& downloadDir, LedgerRange const& range,
+    std::shared_ptr<DecodedCheckpoint> decoded)
     : BasicWork(app,
                 "apply-ledgers-" +
                     fmt::format("{}-{}", range.mFirst, range.mLast),
@@ -39,6 +39,7 @@ ApplyCheckpointWork::ApplyCheckpointWork(Application& app,
           {"history", "apply-ledger-chain", "success"}, "event"))
     , mApplyLedgerFailure(app.getMetrics().NewMeter(
           {"history", "apply-ledger-chain", "failure"}, "event"))
+    , mDecoded(decoded)
 {
     // Ledger range check to enforce application of a single checkpoint
     auto const& hm = mApp.getHistoryManager();
@@ -81,6 +82,22 @@ ApplyCheckpointWork::openInputFiles()
 {
     mHdrIn.close();
     mTxIn.close();
+    mTxHistoryEntry = TransactionHistoryEntry();
+    mHeaderHistoryEntry = LedgerHeaderHistoryEntry();
+    mFilesOpen = true;
+    if (mDecoded)
+    {
+        if (!mDecoded->mDecoded)
+        {
+            throw std::runtime_error(fmt::format(
+                "checkpoint {} is not decoded or already applied",
+                mCheckpoint));
+        }
+        mNextDecodedHeader = 0;
+        mNextDecodedTxSet = 0;
+        return;
+    }
+
     FileTransferInfo hi(mDownloadDir, HISTORY_FILE_TYPE_LEDGER, mCheckpoint);
     FileTransferInfo ti(mDownloadDir, HISTORY_FILE_TYPE_TRANSACTIONS,
                         mCheckpoint);
@@ -90,9 +107,38 @@ ApplyCheckpointWork::openInputFiles()
                            << ti.localPath_nogz();
     mHdrIn.open(hi.localPath_nogz());
     mTxIn.open(ti.localPath_nogz());
-    mTxHistoryEntry = TransactionHistoryEntry();
-    mHeaderHistoryEntry = LedgerHeaderHistoryEntry();
-    mFilesOpen = true;
+}
+
+// Decoded entries are moved out as they are read: a checkpoint is applied
+// once, and released right after.
+bool
+ApplyCheckpointWork::readHeader(LedgerHeaderHistoryEntry& out)
+{
+    if (mDecoded)
+    {
+        if (mNextDecodedHeader == mDecoded->mHeaders.size())
+        {
+            return false;
+        }
+        out = std::move(mDecoded->mHeaders[mNextDecodedHeader++]);
+        return true;
+    }
+    return mHdrIn && mHdrIn.readOne(out);
+}
+
+bool
+ApplyCheckpointWork::readTxSet(TransactionHistoryEntry& out)
+{
+    if (mDecoded)
+    {
+        if (mNextDecodedTxSet == mDecoded->mTxSets.size())
+        {
+            return false;
+        }
+        out = std::move(mDecoded->mTxSets[mNextDecodedTxSet++]);
+        return true;
+    }
+    return mTxIn && mTxIn.readOne(out);
 }
 
 TxSetFramePtr
@@ -123,7 +169,7 @@ ApplyCheckpointWork::getCurrentTxSet()
             return std::make_shared<TxSetFrame>(mApp.getNetworkID(),
                                                 mTxHistoryEntry.txSet);
         }
-    } while (mTxIn && mTxIn.readOne(mTxHistoryEntry));
+    } while (readTxSet(mTxHistoryEntry));
 
     CLOG(DEBUG, "History") << "Using empty txset for ledger " << seq;
     return std::make_shared<TxSetFrame>(lm.getLastClosedLedgerHeader().hash);
@@ -132,7 +178,7 @@ ApplyCheckpointWork::getCurrentTxSet()
 std::shared_ptr<LedgerCloseData>
 ApplyCheckpointWork::getNextLedgerCloseData()
 {
-    if (!mHdrIn || !mHdrIn.readOne(mHeaderHistoryEntry))
+    if (!readHeader(mHeaderHistoryEntry))
     {
         throw std::runtime_error("No more ledgers to replay!");
     }
@@ -290,6 +336,10 @@ ApplyCheckpointWork::onRun()
 
         if (done)
         {
+            if (mDecoded)
+            {
+                mDecoded->release(mApp.getClock().now());
+            }
             return State::WORK_SUCCESS;
         }
 
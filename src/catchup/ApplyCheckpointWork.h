@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "catchup/DecodeCheckpointWork.h"
 #include "herder/LedgerCloseData.h"
 #include "herder/TxSetFrame.h"
 #include "ledger/LedgerRange.h"
@@ -42,6 +43,8 @@ struct LedgerHeaderHistoryEntry;
  * * downloadDir - directory containing ledger and transaction files
  * * range - LedgerRange to apply, must be checkpoint-aligned,
  * and cover at most one checkpoint.
+ * * decoded - optionally, the contents of these files already decoded into
+ * memory by DecodeCheckpointWork; they are released once applied.
  */
 
 class ApplyCheckpointWork : public BasicWork
@@ -60,16 +63,23 @@ class ApplyCheckpointWork : public BasicWork
 
     bool mFilesOpen{false};
 
+    std::shared_ptr<DecodedCheckpoint> mDecoded;
+    size_t mNextDecodedHeader{0};
+    size_t mNextDecodedTxSet{0};
+
     std::shared_ptr<ConditionalWork> mConditionalWork;
 
     TxSetFramePtr getCurrentTxSet();
     void openInputFiles();
+    bool readHeader(LedgerHeaderHistoryEntry& out);
+    bool readTxSet(TransactionHistoryEntry& out);
 
     std::shared_ptr<LedgerCloseData> getNextLedgerCloseData();
 
   public:
     ApplyCheckpointWork(Application& app, TmpDir const& downloadDir,
-                        LedgerRange const& range);
+                        LedgerRange const& range,
+                        std::shared_ptr<DecodedCheckpoint> decoded = nullptr);
     ~ApplyCheckpointWork() = default;
     std::string getStatus() const override;
     void shutdown() override;
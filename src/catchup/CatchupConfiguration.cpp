@@ -3,7 +3,9 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "catchup/CatchupConfiguration.h"
+#include "ledger/LedgerManager.h"
 
+#include <algorithm>
 #include <cassert>
 #include <lib/util/format.h>
 
@@ -33,6 +35,61 @@ CatchupConfiguration::resolve(uint32_t remoteCheckpoint) const
                                 mode()};
 }
 
+std::vector<CatchupConfiguration>
+splitCatchupConfiguration(CatchupConfiguration const& cc, uint32_t parts,
+                          uint32_t checkpointFrequency)
+{
+    assert(cc.toLedger() != CatchupConfiguration::CURRENT);
+    assert(parts > 0);
+    auto const genesis = LedgerManager::GENESIS_LEDGER_SEQ;
+    auto const toLedger = cc.toLedger();
+
+    // Largest checkpoint not after `ledger`, or genesis if there is none
+    auto checkpointAtOrBefore = [&](uint32_t ledger) {
+        auto n = (ledger + 1) / checkpointFrequency;
+        return n == 0 ? genesis : n * checkpointFrequency - 1;
+    };
+
+    // State the whole catchup starts from, as computed by CatchupRange from
+    // a fresh database: genesis, or the bucket state of a checkpoint.
+    uint32_t start = genesis;
+    if (cc.count() < toLedger - genesis)
+    {
+        start = checkpointAtOrBefore(toLedger - std::max(1u, cc.count()) + 1);
+    }
+    if (parts == 1 || start >= toLedger)
+    {
+        return {cc};
+    }
+
+    std::vector<uint32_t> ends;
+    for (uint32_t i = 1; i < parts; ++i)
+    {
+        auto target =
+            start + static_cast<uint32_t>(
+                        static_cast<uint64_t>(toLedger - start) * i / parts);
+        auto end = checkpointAtOrBefore(target);
+        if (end > (ends.empty() ? start : ends.back()) && end < toLedger)
+        {
+            ends.emplace_back(end);
+        }
+    }
+    ends.emplace_back(toLedger);
+
+    std::vector<CatchupConfiguration> res;
+    auto from = start;
+    for (auto end : ends)
+    {
+        // Counting `from` itself makes CatchupRange apply buckets at `from`
+        // (a checkpoint) and replay from the ledger after it.
+        auto count = from == genesis ? end - genesis : end - from + 1;
+        auto hash = end == toLedger ? cc.hash() : nullptr;
+        res.emplace_back(LedgerNumHashPair(end, hash), count, cc.mode());
+        from = end;
+    }
+    return res;
+}
+
 uint32_t
 parseLedger(std::string const& str)
 {
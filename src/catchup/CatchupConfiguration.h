@@ -7,6 +7,7 @@
 #include "ledger/LedgerRange.h"
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace stellar
 {
@@ -101,6 +102,15 @@ class CatchupConfiguration
     Mode mMode;
 };
 
+// Splits the offline catchup `cc` (which must have an explicit destination
+// ledger) into at most `parts` catchups of consecutive ledger ranges that can
+// run independently, each on its own fresh ledger: every part but the first
+// starts from the bucket state of the checkpoint the previous part ends on.
+// Together they replay the same ledgers as `cc` from a fresh database.
+std::vector<CatchupConfiguration>
+splitCatchupConfiguration(CatchupConfiguration const& cc, uint32_t parts,
+                          uint32_t checkpointFrequency);
+
 uint32_t parseLedger(std::string const& str);
 uint32_t parseLedgerCount(std::string const& str);
 }
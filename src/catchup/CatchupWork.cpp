@@ -11,7 +11,9 @@
 #include "catchup/DownloadApplyTxsWork.h"
 #include "catchup/VerifyLedgerChainWork.h"
 #include "history/FileTransferInfo.h"
+#include "history/HistoryArchiveManager.h"
 #include "history/HistoryManager.h"
+#include "historywork/AddToHistoryCacheWork.h"
 #include "historywork/BatchDownloadWork.h"
 #include "historywork/DownloadBucketsWork.h"
 #include "historywork/DownloadVerifyTxResultsWork.h"
@@ -123,6 +125,18 @@ CatchupWork::downloadVerifyLedgerChain(CatchupRange const& catchupRange,
         mApp, *mDownloadDir, verifyRange, mLastClosedLedgerHashPair, rangeEnd);
 
     std::vector<std::shared_ptr<BasicWork>> seq{getLedgers, mVerifyLedgers};
+    if (mApp.getHistoryArchiveManager().getCacheArchive())
+    {
+        // Only cache ledger files once the chain is verified
+        std::vector<FileTransferInfo> files;
+        for (auto i = checkpointRange.mFirst; i <= checkpointRange.mLast;
+             i += checkpointRange.mFrequency)
+        {
+            files.emplace_back(*mDownloadDir, HISTORY_FILE_TYPE_LEDGER, i);
+        }
+        seq.push_back(std::make_shared<AddToHistoryCacheWork>(
+            mApp, "add-ledgers-to-cache", files));
+    }
     mDownloadVerifyLedgersSeq =
         addWork<WorkSequence>("download-verify-ledgers-seq", seq);
     mCurrentWork = mDownloadVerifyLedgersSeq;
@@ -0,0 +1,184 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "catchup/DecodeCheckpointWork.h"
+#include "history/FileTransferInfo.h"
+#include "main/Application.h"
+#include "main/ErrorMessages.h"
+#include "util/FileSystemException.h"
+#include "util/Fs.h"
+#include "util/Logging.h"
+#include "util/XDRStream.h"
+
+#include <lib/util/format.h>
+
+namespace stellar
+{
+
+bool
+DecodedCheckpoint::reserve(size_t bytes, bool force)
+{
+    assert(!mDecoded && mBytes == 0);
+    if (mBudget)
+    {
+        if (!force && mBudget->mUsedBytes + bytes > mBudget->mMaxBytes)
+        {
+            return false;
+        }
+        mBudget->mUsedBytes += bytes;
+    }
+    mBytes = bytes;
+    return true;
+}
+
+void
+DecodedCheckpoint::setDecoded(std::vector<LedgerHeaderHistoryEntry>&& headers,
+                              std::vector<TransactionHistoryEntry>&& txSets,
+                              size_t bytes, VirtualClock::time_point now)
+{
+    if (mBudget)
+    {
+        assert(mBudget->mUsedBytes >= mBytes);
+        mBudget->mUsedBytes = mBudget->mUsedBytes - mBytes + bytes;
+    }
+    mBytes = bytes;
+    mHeaders = std::move(headers);
+    mTxSets = std::move(txSets);
+    mDecoded = true;
+    mDecodedAt = now;
+}
+
+void
+DecodedCheckpoint::abandon()
+{
+    if (mBudget)
+    {
+        assert(mBudget->mUsedBytes >= mBytes);
+        mBudget->mUsedBytes -= mBytes;
+    }
+    mBytes = 0;
+}
+
+void
+DecodedCheckpoint::release(VirtualClock::time_point now)
+{
+    abandon();
+    std::vector<LedgerHeaderHistoryEntry>().swap(mHeaders);
+    std::vector<TransactionHistoryEntry>().swap(mTxSets);
+    mApplied = true;
+    mAppliedAt = now;
+}
+
+DecodeCheckpointWork::DecodeCheckpointWork(
+    Application& app, TmpDir const& downloadDir, uint32_t checkpoint,
+    std::shared_ptr<DecodedCheckpoint> decoded)
+    : BasicWork(app, fmt::format("decode-checkpoint-{}", checkpoint),
+                BasicWork::RETRY_NEVER)
+    , mDownloadDir(downloadDir)
+    , mCheckpoint(checkpoint)
+    , mDecoded(decoded)
+{
+    assert(mDecoded);
+}
+
+void
+DecodeCheckpointWork::onReset()
+{
+    mDone = false;
+    mFailed = false;
+}
+
+size_t
+DecodeCheckpointWork::estimateBytes(TmpDir const& downloadDir,
+                                    uint32_t checkpoint)
+{
+    FileTransferInfo hi(downloadDir, HISTORY_FILE_TYPE_LEDGER, checkpoint);
+    FileTransferInfo ti(downloadDir, HISTORY_FILE_TYPE_TRANSACTIONS,
+                        checkpoint);
+    return fs::size(hi.localPath_nogz()) + fs::size(ti.localPath_nogz());
+}
+
+template <typename T>
+static size_t
+readAll(std::string const& path, std::vector<T>& out)
+{
+    XDRInputFileStream in;
+    in.open(path);
+    size_t bytes = 0;
+    T entry;
+    while (in && in.readOne(entry))
+    {
+        bytes += xdr::xdr_size(entry);
+        out.emplace_back(std::move(entry));
+    }
+    return bytes;
+}
+
+BasicWork::State
+DecodeCheckpointWork::onRun()
+{
+    if (mDone)
+    {
+        return mFailed ? State::WORK_FAILURE : State::WORK_SUCCESS;
+    }
+
+    std::weak_ptr<DecodeCheckpointWork> weak(
+        std::static_pointer_cast<DecodeCheckpointWork>(shared_from_this()));
+    FileTransferInfo hi(mDownloadDir, HISTORY_FILE_TYPE_LEDGER, mCheckpoint);
+    FileTransferInfo ti(mDownloadDir, HISTORY_FILE_TYPE_TRANSACTIONS,
+                        mCheckpoint);
+    auto decode = [
+        weak, &app = mApp, dst = mDecoded, hdrPath = hi.localPath_nogz(),
+        txPath = ti.localPath_nogz()
+    ]()
+    {
+        auto decoded = std::make_shared<DecodedCheckpoint>();
+        bool failed = false;
+        try
+        {
+            decoded->mBytes = readAll(hdrPath, decoded->mHeaders) +
+                              readAll(txPath, decoded->mTxSets);
+        }
+        catch (FileSystemException&)
+        {
+            CLOG(ERROR, "History") << POSSIBLY_CORRUPTED_LOCAL_FS;
+            failed = true;
+        }
+        catch (std::exception& e)
+        {
+            CLOG(ERROR, "History")
+                << "Decoding " << txPath << " failed: " << e.what();
+            failed = true;
+        }
+
+        // Results are handed over on the main thread, where the budget is
+        // reconciled even if the work is gone
+        app.postOnMainThread(
+            [weak, &app, dst, decoded, failed]() {
+                auto self = weak.lock();
+                if (failed || !self)
+                {
+                    dst->abandon();
+                }
+                else
+                {
+                    dst->setDecoded(std::move(decoded->mHeaders),
+                                    std::move(decoded->mTxSets),
+                                    decoded->mBytes, app.getClock().now());
+                }
+                if (self)
+                {
+                    self->mDone = true;
+                    self->mFailed = failed;
+                    self->wakeUp();
+                }
+            },
+            "DecodeCheckpoint: finish");
+    };
+
+    mApp.postOnBackgroundThread(decode,
+                                "DecodeCheckpoint: start in background");
+    return State::WORK_WAITING;
+}
+}
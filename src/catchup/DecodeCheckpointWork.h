@@ -0,0 +1,95 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include "util/Timer.h"
+#include "work/BasicWork.h"
+#include "xdr/Stellar-ledger.h"
+
+namespace stellar
+{
+
+class TmpDir;
+
+// Memory held by checkpoints decoded ahead of being applied, shared by the
+// works of a DownloadApplyTxsWork. Memory is reserved before a checkpoint is
+// decoded, so that decodes in flight count against the budget too.
+struct DecodedCheckpointBudget
+{
+    size_t const mMaxBytes;
+    size_t mUsedBytes{0};
+
+    explicit DecodedCheckpointBudget(size_t maxBytes) : mMaxBytes(maxBytes)
+    {
+    }
+};
+
+// Ledger headers and transaction sets of a checkpoint, read from the
+// downloaded files into memory so that ApplyCheckpointWork does not wait on
+// disk reads and XDR decoding.
+struct DecodedCheckpoint
+{
+    std::vector<LedgerHeaderHistoryEntry> mHeaders;
+    std::vector<TransactionHistoryEntry> mTxSets;
+    // Bytes counted against mBudget until released: an estimate reserved
+    // before decoding, then the size of the decoded entries
+    size_t mBytes{0};
+    std::shared_ptr<DecodedCheckpointBudget> mBudget;
+
+    bool mDecoded{false};
+    VirtualClock::time_point mDecodedAt;
+    bool mApplied{false};
+    VirtualClock::time_point mAppliedAt;
+
+    // Reserves `bytes` for decoding this checkpoint if they fit in the
+    // budget, or regardless of the budget if `force` is set. Returns whether
+    // the memory was reserved.
+    bool reserve(size_t bytes, bool force);
+
+    // Called once decoding is done: replaces the reservation with the actual
+    // size of the decoded entries.
+    void setDecoded(std::vector<LedgerHeaderHistoryEntry>&& headers,
+                    std::vector<TransactionHistoryEntry>&& txSets,
+                    size_t bytes, VirtualClock::time_point now);
+
+    // Called if decoding fails: returns the reservation to the budget.
+    void abandon();
+
+    // Called once the checkpoint is applied: frees the decoded entries and
+    // returns their memory to the budget.
+    void release(VirtualClock::time_point now);
+};
+
+// Decodes the ledger header and transaction files of a checkpoint into a
+// DecodedCheckpoint on a background thread.
+class DecodeCheckpointWork : public BasicWork
+{
+    TmpDir const& mDownloadDir;
+    uint32_t const mCheckpoint;
+    std::shared_ptr<DecodedCheckpoint> mDecoded;
+    bool mDone{false};
+    bool mFailed{false};
+
+  public:
+    DecodeCheckpointWork(Application& app, TmpDir const& downloadDir,
+                         uint32_t checkpoint,
+                         std::shared_ptr<DecodedCheckpoint> decoded);
+    ~DecodeCheckpointWork() = default;
+
+    // Upper bound of the memory taken by the decoded entries of a downloaded
+    // checkpoint: the size of its uncompressed files.
+    static size_t estimateBytes(TmpDir const& downloadDir,
+                                uint32_t checkpoint);
+
+  protected:
+    void onReset() override;
+    State onRun() override;
+    bool
+    onAbort() override
+    {
+        return true;
+    };
+};
+}
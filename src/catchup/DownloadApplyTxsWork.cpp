@@ -4,18 +4,30 @@
 
 #include "catchup/DownloadApplyTxsWork.h"
 #include "catchup/ApplyCheckpointWork.h"
+#include "catchup/DecodeCheckpointWork.h"
 #include "history/FileTransferInfo.h"
+#include "history/HistoryArchiveManager.h"
 #include "history/HistoryManager.h"
+#include "historywork/AddToHistoryCacheWork.h"
 #include "historywork/GetAndUnzipRemoteFileWork.h"
 #include "ledger/LedgerManager.h"
 #include "work/ConditionalWork.h"
 #include "work/WorkSequence.h"
 
 #include <lib/util/format.h>
+#include <medida/metrics_registry.h>
+#include <medida/timer.h>
 
 namespace stellar
 {
 
+static std::shared_ptr<DecodedCheckpointBudget>
+makeDecodeBudget(Config const& cfg)
+{
+    return std::make_shared<DecodedCheckpointBudget>(
+        static_cast<size_t>(cfg.CATCHUP_PREFETCH_MEMORY_MB) * 1024 * 1024);
+}
+
 DownloadApplyTxsWork::DownloadApplyTxsWork(
     Application& app, TmpDir const& downloadDir, LedgerRange const& range,
     LedgerHeaderHistoryEntry& lastApplied, bool waitForPublish,
@@ -26,8 +38,11 @@ DownloadApplyTxsWork::DownloadApplyTxsWork(
     , mLastApplied(lastApplied)
     , mCheckpointToQueue(
           app.getHistoryManager().checkpointContainingLedger(range.mFirst))
+    , mDecodeBudget(makeDecodeBudget(app.getConfig()))
     , mWaitForPublish(waitForPublish)
     , mArchive(archive)
+    , mApplyStall(app.getMetrics().NewTimer(
+          {"history", "apply-ledger-chain", "stall"}))
 {
 }
 
@@ -51,17 +66,39 @@ DownloadApplyTxsWork::yieldMoreWork()
     auto low = std::max(LedgerManager::GENESIS_LEDGER_SEQ,
                         hm.prevCheckpointLedger(mCheckpointToQueue));
     auto high = std::min(mCheckpointToQueue, mRange.mLast);
-    auto apply = std::make_shared<ApplyCheckpointWork>(mApp, mDownloadDir,
-                                                       LedgerRange{low, high});
+    auto decoded = std::make_shared<DecodedCheckpoint>();
+    decoded->mBudget = mDecodeBudget;
+    auto decode = std::make_shared<DecodeCheckpointWork>(
+        mApp, mDownloadDir, mCheckpointToQueue, decoded);
+    auto apply = std::make_shared<ApplyCheckpointWork>(
+        mApp, mDownloadDir, LedgerRange{low, high}, decoded);
 
     std::vector<std::shared_ptr<BasicWork>> seq{getAndUnzip};
 
     if (mLastYieldedWork)
     {
         auto prev = mLastYieldedWork;
+
+        // Decode ahead of apply only while the memory budget allows it, but
+        // always decode the next checkpoint to apply. Memory is reserved here,
+        // as the decode starts as soon as this returns true.
+        auto decodePredicate = [
+            prev, decoded, &downloadDir = mDownloadDir,
+            checkpoint = mCheckpointToQueue
+        ]()
+        {
+            return decoded->reserve(
+                DecodeCheckpointWork::estimateBytes(downloadDir, checkpoint),
+                prev->getState() == State::WORK_SUCCESS);
+        };
+        seq.push_back(std::make_shared<ConditionalWork>(
+            mApp, "conditional-" + decode->getName(), decodePredicate,
+            decode));
+
         bool pqFellBehind = false;
         auto predicate = [
-            prev, pqFellBehind, waitForPublish = mWaitForPublish, &hm
+            prev, pqFellBehind, waitForPublish = mWaitForPublish, &hm,
+            prevDecoded = mLastYieldedDecoded, decoded, &stall = mApplyStall
         ]() mutable
         {
             if (!prev)
@@ -91,6 +128,13 @@ DownloadApplyTxsWork::yieldMoreWork()
                 }
                 res = !pqFellBehind;
             }
+
+            // Apply of the previous checkpoint finished before this one was
+            // decoded: apply stalled, waiting on download and decode
+            if (res && prevDecoded->mAppliedAt < decoded->mDecodedAt)
+            {
+                stall.Update(decoded->mDecodedAt - prevDecoded->mAppliedAt);
+            }
             return res;
         };
         seq.push_back(std::make_shared<ConditionalWork>(
@@ -98,14 +142,24 @@ DownloadApplyTxsWork::yieldMoreWork()
     }
     else
     {
+        seq.push_back(decode);
         seq.push_back(apply);
     }
 
+    if (mApp.getHistoryArchiveManager().getCacheArchive())
+    {
+        // Applying checks the transactions against the verified ledger chain
+        seq.push_back(std::make_shared<AddToHistoryCacheWork>(
+            mApp, "add-to-cache-" + apply->getName(),
+            std::vector<FileTransferInfo>{ft}));
+    }
+
     auto nextWork = std::make_shared<WorkSequence>(
         mApp, "download-apply-" + std::to_string(mCheckpointToQueue), seq,
         BasicWork::RETRY_NEVER);
     mCheckpointToQueue += mApp.getHistoryManager().getCheckpointFrequency();
     mLastYieldedWork = nextWork;
+    mLastYieldedDecoded = decoded;
     return nextWork;
 }
 
@@ -115,9 +169,17 @@ DownloadApplyTxsWork::resetIter()
     mCheckpointToQueue =
         mApp.getHistoryManager().checkpointContainingLedger(mRange.mFirst);
     mLastYieldedWork.reset();
+    mLastYieldedDecoded.reset();
+    mDecodeBudget = makeDecodeBudget(mApp.getConfig());
     mLastApplied = mApp.getLedgerManager().getLastClosedLedgerHeader();
 }
 
+size_t
+DownloadApplyTxsWork::getMaxBatchSize() const
+{
+    return static_cast<size_t>(mApp.getConfig().CATCHUP_PREFETCH_CHECKPOINTS);
+}
+
 bool
 DownloadApplyTxsWork::hasNext() const
 {
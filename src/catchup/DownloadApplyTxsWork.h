@@ -11,7 +11,7 @@
 
 namespace medida
 {
-class Meter;
+class Timer;
 }
 
 namespace stellar
@@ -20,7 +20,14 @@ namespace stellar
 class TmpDir;
 class HistoryArchive;
 struct LedgerHeaderHistoryEntry;
-
+struct DecodedCheckpoint;
+struct DecodedCheckpointBudget;
+
+// Downloads, decodes and applies checkpoints of a range. Up to
+// CATCHUP_PREFETCH_CHECKPOINTS checkpoints are downloaded ahead of the one
+// being applied, and decoded into memory as long as they fit in
+// CATCHUP_PREFETCH_MEMORY_MB along with the checkpoints already decoded (or
+// being decoded). The next checkpoint to apply is always decoded.
 class DownloadApplyTxsWork : public BatchWork
 {
     LedgerRange const mRange;
@@ -28,9 +35,13 @@ class DownloadApplyTxsWork : public BatchWork
     LedgerHeaderHistoryEntry& mLastApplied;
     uint32_t mCheckpointToQueue;
     std::shared_ptr<BasicWork> mLastYieldedWork;
+    std::shared_ptr<DecodedCheckpoint> mLastYieldedDecoded;
+    std::shared_ptr<DecodedCheckpointBudget> mDecodeBudget;
     bool const mWaitForPublish;
     std::shared_ptr<HistoryArchive> mArchive;
 
+    medida::Timer& mApplyStall;
+
   public:
     DownloadApplyTxsWork(Application& app, TmpDir const& downloadDir,
                          LedgerRange const& range,
@@ -44,6 +55,7 @@ class DownloadApplyTxsWork : public BatchWork
     bool hasNext() const override;
     std::shared_ptr<BasicWork> yieldMoreWork() override;
     void resetIter() override;
+    size_t getMaxBatchSize() const override;
     void onSuccess() override;
 };
 }
\ No newline at end of file
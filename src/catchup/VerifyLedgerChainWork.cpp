@@ -11,6 +11,7 @@
 #include "util/FileSystemException.h"
 #include "util/XDRStream.h"
 #include "util/types.h"
+#include <algorithm>
 #include <medida/meter.h>
 #include <medida/metrics_registry.h>
 
@@ -86,6 +87,7 @@ VerifyLedgerChainWork::VerifyLedgerChainWork(
     , mRange(range)
     , mCurrCheckpoint(
           mApp.getHistoryManager().checkpointContainingLedger(mRange.mLast))
+    , mNextCheckpointToVerify(mCurrCheckpoint)
     , mLastClosed(lastClosedLedger)
     , mTrustedEndLedger(ledgerRangeEnd)
     , mVerifyLedgerSuccess(app.getMetrics().NewMeter(
@@ -120,65 +122,66 @@ VerifyLedgerChainWork::onReset()
     mVerifiedLedgerRangeStart = {};
     mCurrCheckpoint =
         mApp.getHistoryManager().checkpointContainingLedger(mRange.mLast);
+    mNextCheckpointToVerify = mCurrCheckpoint;
+    mVerified.clear();
+    mVerifying = 0;
+    ++mGeneration;
 }
 
-HistoryManager::LedgerVerificationStatus
-VerifyLedgerChainWork::verifyHistoryOfSingleCheckpoint()
+// Verifies the ledgers of `checkpoint` that fall in `range`, without looking
+// at other checkpoints; runs on a background thread.
+static VerifyLedgerChainWork::CheckpointVerification
+verifyCheckpoint(std::string const& path, uint32_t checkpoint,
+                 LedgerRange const& range, LedgerNumHashPair const& lastClosed)
 {
-    // When verifying a checkpoint, we rely on the fact that the next checkpoint
-    // has been verified (unless there's 1 checkpoint).
-    // Once the end of the range is reached, ensure that the chain agrees with
-    // trusted hash passed in. If LCL is reached, verify that it agrees with
-    // the chain.
-
-    FileTransferInfo ft(mDownloadDir, HISTORY_FILE_TYPE_LEDGER,
-                        mCurrCheckpoint);
+    VerifyLedgerChainWork::CheckpointVerification res;
     XDRInputFileStream hdrIn;
-    hdrIn.open(ft.localPath_nogz());
+    hdrIn.open(path);
 
     bool beginCheckpoint = true;
     LedgerHeaderHistoryEntry prev;
-    LedgerHeaderHistoryEntry curr;
+    LedgerHeaderHistoryEntry& curr = res.mLast;
 
-    CLOG(DEBUG, "History") << "Verifying ledger headers from "
-                           << ft.localPath_nogz() << " for checkpoint "
-                           << mCurrCheckpoint;
+    CLOG(DEBUG, "History") << "Verifying ledger headers from " << path
+                           << " for checkpoint " << checkpoint;
 
-    auto nextCheckpointFirstLedger = mVerifiedAhead;
     while (hdrIn && hdrIn.readOne(curr))
     {
         if (curr.header.ledgerVersion > Config::CURRENT_LEDGER_PROTOCOL_VERSION)
         {
-            return HistoryManager::VERIFY_STATUS_ERR_BAD_LEDGER_VERSION;
+            res.mStatus = HistoryManager::VERIFY_STATUS_ERR_BAD_LEDGER_VERSION;
+            return res;
         }
 
         // Verify ledger with local state by comparing to LCL
-        if (curr.header.ledgerSeq == mLastClosed.first)
+        if (curr.header.ledgerSeq == lastClosed.first)
         {
-            if (sha256(xdr::xdr_to_opaque(curr.header)) != *mLastClosed.second)
+            if (sha256(xdr::xdr_to_opaque(curr.header)) != *lastClosed.second)
             {
                 CLOG(ERROR, "History")
                     << "Bad ledger-header history entry: claimed ledger "
                     << LedgerManager::ledgerAbbrev(curr)
                     << " does not agree with LCL "
-                    << LedgerManager::ledgerAbbrev(mLastClosed.first,
-                                                   *mLastClosed.second);
-                return HistoryManager::VERIFY_STATUS_ERR_BAD_HASH;
+                    << LedgerManager::ledgerAbbrev(lastClosed.first,
+                                                   *lastClosed.second);
+                res.mStatus = HistoryManager::VERIFY_STATUS_ERR_BAD_HASH;
+                return res;
             }
         }
         // Verify LCL that is just before the first ledger in range
-        else if (curr.header.ledgerSeq == mLastClosed.first + 1)
+        else if (curr.header.ledgerSeq == lastClosed.first + 1)
         {
-            auto lclResult = verifyLedgerHistoryLink(*mLastClosed.second, curr);
+            auto lclResult = verifyLedgerHistoryLink(*lastClosed.second, curr);
             if (lclResult != HistoryManager::VERIFY_STATUS_OK)
             {
                 CLOG(ERROR, "History")
                     << "Bad ledger-header history entry: claimed ledger "
                     << LedgerManager::ledgerAbbrev(curr)
                     << " previous hash does not agree with LCL: "
-                    << LedgerManager::ledgerAbbrev(mLastClosed.first,
-                                                   *mLastClosed.second);
-                return lclResult;
+                    << LedgerManager::ledgerAbbrev(lastClosed.first,
+                                                   *lastClosed.second);
+                res.mStatus = lclResult;
+                return res;
             }
         }
 
@@ -190,13 +193,14 @@ VerifyLedgerChainWork::verifyHistoryOfSingleCheckpoint()
             auto hashResult = verifyLedgerHistoryEntry(curr);
             if (hashResult != HistoryManager::VERIFY_STATUS_OK)
             {
-                return hashResult;
+                res.mStatus = hashResult;
+                return res;
             }
 
             // Remember first ledger in the checkpoint that will be used by the
             // next checkpoint
             auto hash = make_optional<Hash>(curr.header.previousLedgerHash);
-            mVerifiedAhead = LedgerNumHashPair(curr.header.ledgerSeq - 1, hash);
+            res.mFirstPrev = LedgerNumHashPair(curr.header.ledgerSeq - 1, hash);
             beginCheckpoint = false;
         }
         else
@@ -208,7 +212,8 @@ VerifyLedgerChainWork::verifyHistoryOfSingleCheckpoint()
                     << "History chain undershot expected ledger seq "
                     << expectedSeq << ", got " << curr.header.ledgerSeq
                     << " instead";
-                return HistoryManager::VERIFY_STATUS_ERR_UNDERSHOT;
+                res.mStatus = HistoryManager::VERIFY_STATUS_ERR_UNDERSHOT;
+                return res;
             }
             else if (curr.header.ledgerSeq > expectedSeq)
             {
@@ -216,36 +221,117 @@ VerifyLedgerChainWork::verifyHistoryOfSingleCheckpoint()
                     << "History chain overshot expected ledger seq "
                     << expectedSeq << ", got " << curr.header.ledgerSeq
                     << " instead";
-                return HistoryManager::VERIFY_STATUS_ERR_OVERSHOT;
+                res.mStatus = HistoryManager::VERIFY_STATUS_ERR_OVERSHOT;
+                return res;
             }
             auto linkResult = verifyLedgerHistoryLink(prev.hash, curr);
             if (linkResult != HistoryManager::VERIFY_STATUS_OK)
             {
-                return linkResult;
+                res.mStatus = linkResult;
+                return res;
             }
         }
 
-        mVerifyLedgerSuccess.Mark();
+        ++res.mVerifiedLedgers;
         prev = curr;
 
         // No need to keep verifying if the range is covered
-        if (curr.header.ledgerSeq == mRange.mLast)
+        if (curr.header.ledgerSeq == range.mLast)
         {
             break;
         }
     }
 
-    if (curr.header.ledgerSeq != mCurrCheckpoint &&
-        curr.header.ledgerSeq != mRange.mLast)
+    if (curr.header.ledgerSeq != checkpoint &&
+        curr.header.ledgerSeq != range.mLast)
     {
-        // We can end at mCurrCheckpoint if checkpoint was valid
-        // or at mRange.mLast if history chain file was valid and we
+        // We can end at checkpoint if checkpoint was valid
+        // or at range.mLast if history chain file was valid and we
         // reached last ledger in the range. Any other ledger here means
         // that file is corrupted.
         CLOG(ERROR, "History") << "History chain did not end with "
-                               << mCurrCheckpoint << " or " << mRange.mLast;
-        return HistoryManager::VERIFY_STATUS_ERR_MISSING_ENTRIES;
+                               << checkpoint << " or " << range.mLast;
+        res.mStatus = HistoryManager::VERIFY_STATUS_ERR_MISSING_ENTRIES;
+    }
+    return res;
+}
+
+void
+VerifyLedgerChainWork::startVerifications()
+{
+    // Keep enough checkpoints in flight to occupy every worker thread, but
+    // bound the results waiting for an older checkpoint to finish.
+    auto const& hm = mApp.getHistoryManager();
+    size_t maxVerifying =
+        2 * static_cast<size_t>(std::max(1, mApp.getConfig().WORKER_THREADS));
+    uint32_t firstCheckpoint = hm.checkpointContainingLedger(mRange.mFirst);
+
+    std::weak_ptr<VerifyLedgerChainWork> weak(
+        std::static_pointer_cast<VerifyLedgerChainWork>(shared_from_this()));
+    while (mNextCheckpointToVerify >= firstCheckpoint &&
+           mVerifying + mVerified.size() < maxVerifying)
+    {
+        uint32_t checkpoint = mNextCheckpointToVerify;
+        FileTransferInfo ft(mDownloadDir, HISTORY_FILE_TYPE_LEDGER,
+                            checkpoint);
+        auto verify = [
+            weak, checkpoint, path = ft.localPath_nogz(), range = mRange,
+            lastClosed = mLastClosed, generation = mGeneration,
+            &app = mApp
+        ]()
+        {
+            CheckpointVerification res;
+            try
+            {
+                res = verifyCheckpoint(path, checkpoint, range, lastClosed);
+            }
+            catch (FileSystemException&)
+            {
+                res.mFileSystemError = true;
+            }
+
+            app.postOnMainThread(
+                [weak, checkpoint, generation, res]() {
+                    auto self = weak.lock();
+                    if (!self || self->mGeneration != generation)
+                    {
+                        return;
+                    }
+                    --self->mVerifying;
+                    self->mVerified.emplace(checkpoint, res);
+                    self->wakeUp();
+                },
+                "VerifyLedgerChain: checkpoint verified");
+        };
+        mApp.postOnBackgroundThread(verify,
+                                    "VerifyLedgerChain: verify checkpoint");
+        ++mVerifying;
+
+        // Checkpoints are never 0, so 0 marks that all have been started
+        auto freq = hm.getCheckpointFrequency();
+        mNextCheckpointToVerify =
+            checkpoint == firstCheckpoint ? 0 : checkpoint - freq;
     }
+}
+
+HistoryManager::LedgerVerificationStatus
+VerifyLedgerChainWork::verifyCheckpointLinks(
+    CheckpointVerification const& verified)
+{
+    // When verifying a checkpoint, we rely on the fact that the next checkpoint
+    // has been verified (unless there's 1 checkpoint).
+    // Once the end of the range is reached, ensure that the chain agrees with
+    // trusted hash passed in. The checkpoint itself, including its agreement
+    // with LCL, has already been verified in the background.
+    mVerifyLedgerSuccess.Mark(verified.mVerifiedLedgers);
+    if (verified.mStatus != HistoryManager::VERIFY_STATUS_OK)
+    {
+        return verified.mStatus;
+    }
+
+    auto const& curr = verified.mLast;
+    auto nextCheckpointFirstLedger = mVerifiedAhead;
+    mVerifiedAhead = verified.mFirstPrev;
 
     if (curr.header.ledgerSeq == mRange.mLast)
     {
@@ -297,14 +383,16 @@ VerifyLedgerChainWork::onRun()
             "Verification undershot first ledger in the range.");
     }
 
-    HistoryManager::LedgerVerificationStatus result;
-
-    // Catch FS-related errors to gracefully fail Work instead of crashing
-    try
+    startVerifications();
+    auto verified = mVerified.find(mCurrCheckpoint);
+    if (verified == mVerified.end())
     {
-        result = verifyHistoryOfSingleCheckpoint();
+        // Woken up once a background verification finishes
+        return BasicWork::State::WORK_WAITING;
     }
-    catch (FileSystemException&)
+
+    // FS-related errors gracefully fail Work instead of crashing
+    if (verified->second.mFileSystemError)
     {
         CLOG(ERROR, "History") << "Catchup material failed verification";
         CLOG(ERROR, "History") << POSSIBLY_CORRUPTED_LOCAL_FS;
@@ -312,6 +400,9 @@ VerifyLedgerChainWork::onRun()
         return BasicWork::State::WORK_FAILURE;
     }
 
+    auto result = verifyCheckpointLinks(verified->second);
+    mVerified.erase(verified);
+
     switch (result)
     {
     case HistoryManager::VERIFY_STATUS_OK:
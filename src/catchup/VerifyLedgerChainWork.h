@@ -8,6 +8,8 @@
 #include "ledger/LedgerRange.h"
 #include "work/Work.h"
 
+#include <map>
+
 namespace medida
 {
 class Meter;
@@ -22,11 +24,40 @@ struct LedgerHeaderHistoryEntry;
 // This class verifies ledger chain of a given range by checking the hashes.
 // Note that verification is done starting with the latest checkpoint in the
 // range, and working its way backwards to the beginning of the range.
+//
+// Each checkpoint is first verified in isolation on a background thread
+// (header hashes, sequence numbers and links between consecutive headers),
+// several checkpoints at a time. Only the link between the last ledger of a
+// checkpoint and the first ledger of the checkpoint ahead of it is checked
+// sequentially, on the main thread, as the results come in.
 class VerifyLedgerChainWork : public BasicWork
 {
+  public:
+    // Outcome of verifying the ledgers of a single checkpoint in isolation.
+    struct CheckpointVerification
+    {
+        HistoryManager::LedgerVerificationStatus mStatus{
+            HistoryManager::VERIFY_STATUS_OK};
+        bool mFileSystemError{false};
+        uint32_t mVerifiedLedgers{0};
+        // Ledger before the first ledger of the checkpoint, along with the
+        // hash the first ledger claims it has
+        LedgerNumHashPair mFirstPrev;
+        LedgerHeaderHistoryEntry mLast;
+    };
+
+  private:
     TmpDir const& mDownloadDir;
     LedgerRange const mRange;
     uint32_t mCurrCheckpoint;
+    // Next (older) checkpoint to hand to a background thread
+    uint32_t mNextCheckpointToVerify;
+    // Results of background verifications not yet linked to the chain
+    std::map<uint32_t, CheckpointVerification> mVerified;
+    size_t mVerifying{0};
+    // Bumped on reset, so that results of verifications started before are
+    // dropped
+    uint64_t mGeneration{0};
     LedgerNumHashPair const& mLastClosed;
     LedgerNumHashPair const mTrustedEndLedger;
 
@@ -42,7 +73,9 @@ class VerifyLedgerChainWork : public BasicWork
     medida::Meter& mVerifyLedgerChainSuccess;
     medida::Meter& mVerifyLedgerChainFailure;
 
-    HistoryManager::LedgerVerificationStatus verifyHistoryOfSingleCheckpoint();
+    void startVerifications();
+    HistoryManager::LedgerVerificationStatus
+    verifyCheckpointLinks(CheckpointVerification const& verified);
 
   public:
     VerifyLedgerChainWork(Application& app, TmpDir const& downloadDir,
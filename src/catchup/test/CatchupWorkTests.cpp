@@ -182,3 +182,58 @@ TEST_CASE("compute CatchupRange from CatchupConfiguration", "[catchup]")
         }
     }
 }
+
+TEST_CASE("split CatchupConfiguration for parallel replay", "[catchup]")
+{
+    VirtualClock clock;
+    auto app = createTestApplication(clock, getTestConfig());
+    auto& historyManager = app->getHistoryManager();
+    auto freq = historyManager.getCheckpointFrequency();
+    auto genesis = LedgerManager::GENESIS_LEDGER_SEQ;
+
+    for (auto const& test : gCatchupRangeCases)
+    {
+        if (test.first != genesis)
+        {
+            continue;
+        }
+        auto configuration = test.second;
+        auto whole = CatchupRange{genesis, configuration, historyManager};
+
+        for (uint32_t parts : {1, 2, 3, 8})
+        {
+            auto name = fmt::format("to ledger = {}, count = {}, parts = {}",
+                                    configuration.toLedger(),
+                                    configuration.count(), parts);
+            LOG(DEBUG) << "Split catchup configuration: " << name;
+
+            auto split =
+                splitCatchupConfiguration(configuration, parts, freq);
+            REQUIRE(!split.empty());
+            REQUIRE(split.size() <= parts);
+
+            // first part starts where the whole catchup would
+            auto first = CatchupRange{genesis, split.front(), historyManager};
+            REQUIRE(first.mApplyBuckets == whole.mApplyBuckets);
+            REQUIRE(first.mLedgers.mFirst == whole.mLedgers.mFirst);
+
+            // each next part starts from the buckets of the checkpoint
+            // where the previous part ends
+            for (size_t i = 1; i < split.size(); ++i)
+            {
+                auto prev =
+                    CatchupRange{genesis, split[i - 1], historyManager};
+                auto curr = CatchupRange{genesis, split[i], historyManager};
+                REQUIRE(curr.mApplyBuckets);
+                REQUIRE(curr.getBucketApplyLedger() == prev.getLast());
+                REQUIRE(historyManager.checkpointContainingLedger(
+                            prev.getLast()) == prev.getLast());
+            }
+
+            // last part finishes where the whole catchup would
+            REQUIRE(split.back().toLedger() == configuration.toLedger());
+            auto last = CatchupRange{genesis, split.back(), historyManager};
+            REQUIRE(last.getLast() == whole.getLast());
+        }
+    }
+}
@@ -328,11 +328,12 @@ PubKeyUtils::verifySig(PublicKey const& key, Signature const& signature,
         }
     }
 
-    ++gVerifyCacheMiss;
     bool ok =
         (crypto_sign_verify_detached(signature.data(), bin.data(), bin.size(),
                                      key.ed25519().data()) == 0);
     std::lock_guard<std::mutex> guard(gVerifySigCacheMutex);
+    // counted under the lock as this can be called from worker threads
+    ++gVerifyCacheMiss;
     gVerifySigCache.put(cacheKey, ok);
     return ok;
 }
@@ -211,9 +211,8 @@ Database::applySchemaUpgrade(unsigned long vers)
     case 11:
         if (!mApp.getConfig().MODE_USES_IN_MEMORY_LEDGER)
         {
-            mSession << "DROP INDEX IF EXISTS bestofferindex;";
-            mSession << "CREATE INDEX bestofferindex ON offers "
-                        "(sellingasset,buyingasset,price,offerid);";
+            LedgerTxnRoot::setBestOfferIndex(mSession, false);
+            LedgerTxnRoot::setBestOfferIndex(mSession, true);
         }
         break;
     case 12:
@@ -285,6 +284,13 @@ Database::upgradeToCurrentSchema()
         applySchemaUpgrade(vers);
         putSchemaVersion(vers);
     }
+
+    // Bulk loading buckets (see ApplyBucketsWork) drops bestofferindex until
+    // the load is done: re-create it in case the load was interrupted
+    if (!mApp.getConfig().MODE_USES_IN_MEMORY_LEDGER)
+    {
+        LedgerTxnRoot::setBestOfferIndex(mSession, true);
+    }
     CLOG(INFO, "Database") << "DB schema is in current version";
     assert(vers == SCHEMA_VERSION);
 }
@@ -324,53 +330,46 @@ Database::getAppSchemaVersion()
 }
 
 medida::TimerContext
-Database::getInsertTimer(std::string const& entityName)
+Database::getTimer(std::string const& queryType, std::string const& entityName)
 {
-    mEntityTypes.insert(entityName);
+    {
+        std::lock_guard<std::mutex> lock(mEntityTypesMutex);
+        mEntityTypes.insert(entityName);
+    }
     mQueryMeter.Mark();
     return mApp.getMetrics()
-        .NewTimer({"database", "insert", entityName})
+        .NewTimer({"database", queryType, entityName})
         .TimeScope();
 }
 
+medida::TimerContext
+Database::getInsertTimer(std::string const& entityName)
+{
+    return getTimer("insert", entityName);
+}
+
 medida::TimerContext
 Database::getSelectTimer(std::string const& entityName)
 {
-    mEntityTypes.insert(entityName);
-    mQueryMeter.Mark();
-    return mApp.getMetrics()
-        .NewTimer({"database", "select", entityName})
-        .TimeScope();
+    return getTimer("select", entityName);
 }
 
 medida::TimerContext
 Database::getDeleteTimer(std::string const& entityName)
 {
-    mEntityTypes.insert(entityName);
-    mQueryMeter.Mark();
-    return mApp.getMetrics()
-        .NewTimer({"database", "delete", entityName})
-        .TimeScope();
+    return getTimer("delete", entityName);
 }
 
 medida::TimerContext
 Database::getUpdateTimer(std::string const& entityName)
 {
-    mEntityTypes.insert(entityName);
-    mQueryMeter.Mark();
-    return mApp.getMetrics()
-        .NewTimer({"database", "update", entityName})
-        .TimeScope();
+    return getTimer("update", entityName);
 }
 
 medida::TimerContext
 Database::getUpsertTimer(std::string const& entityName)
 {
-    mEntityTypes.insert(entityName);
-    mQueryMeter.Mark();
-    return mApp.getMetrics()
-        .NewTimer({"database", "upsert", entityName})
-        .TimeScope();
+    return getTimer("upsert", entityName);
 }
 
 void
@@ -405,6 +404,30 @@ Database::getSimpleCollationClause() const
     }
 }
 
+class IsInTransactionOp : public DatabaseTypeSpecificOperation<bool>
+{
+  public:
+    bool
+    doSqliteSpecificOperation(soci::sqlite3_session_backend* sq) override
+    {
+        return sqlite_api::sqlite3_get_autocommit(sq->conn_) == 0;
+    }
+#ifdef USE_POSTGRES
+    bool
+    doPostgresSpecificOperation(soci::postgresql_session_backend* pg) override
+    {
+        return PQtransactionStatus(pg->conn_) != PQTRANS_IDLE;
+    }
+#endif
+};
+
+bool
+Database::isInTransaction()
+{
+    IsInTransactionOp op;
+    return doDatabaseTypeSpecificOperation(op);
+}
+
 bool
 Database::canUsePool() const
 {
@@ -568,6 +591,20 @@ Database::getPreparedStatement(std::string const& query)
     return sc;
 }
 
+StatementContext
+Database::getPreparedStatement(std::string const& query,
+                               soci::session& session)
+{
+    if (&session == &mSession)
+    {
+        return getPreparedStatement(query);
+    }
+    auto p = std::make_shared<soci::statement>(session);
+    p->alloc();
+    p->prepare(query);
+    return StatementContext(p);
+}
+
 std::shared_ptr<SQLLogContext>
 Database::captureAndLogSQL(std::string contextName)
 {
@@ -585,6 +622,7 @@ Database::totalQueryTime() const
 {
     std::vector<std::string> qtypes = {"insert", "delete", "select", "update"};
     std::chrono::nanoseconds nsq(0);
+    std::lock_guard<std::mutex> lock(mEntityTypesMutex);
     for (auto const& q : qtypes)
     {
         for (auto const& e : mEntityTypes)
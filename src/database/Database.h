@@ -9,6 +9,7 @@
 #include "overlay/StellarXDR.h"
 #include "util/NonCopyable.h"
 #include "util/Timer.h"
+#include <mutex>
 #include <set>
 #include <soci.h>
 #include <string>
@@ -92,8 +93,10 @@ class Database : NonMovableOrCopyable
     medida::Counter& mStatementsSize;
 
     // Helpers for maintaining the total query time and calculating
-    // idle percentage.
+    // idle percentage. mEntityTypes is guarded by mEntityTypesMutex, as the
+    // sessions of the pool time their queries from other threads.
     std::set<std::string> mEntityTypes;
+    mutable std::mutex mEntityTypesMutex;
     std::chrono::nanoseconds mExcludedQueryTime;
     std::chrono::nanoseconds mExcludedTotalTime;
     std::chrono::nanoseconds mLastIdleQueryTime;
@@ -102,6 +105,8 @@ class Database : NonMovableOrCopyable
     static bool gDriversRegistered;
     static void registerDrivers();
     void applySchemaUpgrade(unsigned long vers);
+    medida::TimerContext getTimer(std::string const& queryType,
+                                  std::string const& entityName);
 
   public:
     // Instantiate object and connect to app.getConfig().DATABASE;
@@ -138,6 +143,11 @@ class Database : NonMovableOrCopyable
     // when the statement context is destroyed.
     StatementContext getPreparedStatement(std::string const& query);
 
+    // Same as above, for `session`. Statements of sessions of the pool are
+    // not cached, so that they can be used from any thread.
+    StatementContext getPreparedStatement(std::string const& query,
+                                          soci::session& session);
+
     // Purge all cached prepared statements, closing their handles with the
     // database.
     void clearPreparedStatementCache();
@@ -170,6 +180,16 @@ class Database : NonMovableOrCopyable
     template <typename T>
     T doDatabaseTypeSpecificOperation(DatabaseTypeSpecificOperation<T>& op);
 
+    // Same as above, for the backend of `session`, which may be a session
+    // from the pool rather than the main one.
+    template <typename T>
+    T doDatabaseTypeSpecificOperation(soci::session& session,
+                                      DatabaseTypeSpecificOperation<T>& op);
+
+    // Return true if the main session is inside an explicit transaction, in
+    // which case its changes are not visible to other connections yet.
+    bool isInTransaction();
+
     // Return true if a connection pool is available for worker threads
     // to read from the database through, otherwise false.
     bool canUsePool() const;
@@ -202,7 +222,15 @@ template <typename T>
 T
 Database::doDatabaseTypeSpecificOperation(DatabaseTypeSpecificOperation<T>& op)
 {
-    auto b = mSession.get_backend();
+    return doDatabaseTypeSpecificOperation(mSession, op);
+}
+
+template <typename T>
+T
+Database::doDatabaseTypeSpecificOperation(soci::session& session,
+                                          DatabaseTypeSpecificOperation<T>& op)
+{
+    auto b = session.get_backend();
     if (auto sq = dynamic_cast<soci::sqlite3_session_backend*>(b))
     {
         return op.doSqliteSpecificOperation(sq);
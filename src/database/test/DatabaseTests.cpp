@@ -349,3 +349,33 @@ TEST_CASE("schema test", "[db]")
     auto av = db.getAppSchemaVersion();
     REQUIRE(dbv == av);
 }
+
+TEST_CASE("schema check re-creates bestofferindex", "[db]")
+{
+    Config const& cfg = getTestConfig(0, Config::TESTDB_IN_MEMORY_SQLITE);
+
+    VirtualClock clock;
+    Application::pointer app = createTestApplication(clock, cfg);
+    app->start();
+
+    auto& db = app->getDatabase();
+    auto countIndexes = [&]() {
+        int n = 0;
+        db.getSession() << "SELECT COUNT(*) FROM sqlite_master WHERE "
+                           "type = 'index' AND name = 'bestofferindex'",
+            soci::into(n);
+        return n;
+    };
+    REQUIRE(countIndexes() == 1);
+
+    // as left behind by an interrupted bulk load
+    db.getSession() << "DROP INDEX bestofferindex";
+    REQUIRE(countIndexes() == 0);
+
+    db.upgradeToCurrentSchema();
+    REQUIRE(countIndexes() == 1);
+
+    // and it does nothing when the index exists
+    db.upgradeToCurrentSchema();
+    REQUIRE(countIndexes() == 1);
+}
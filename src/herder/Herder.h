@@ -100,6 +100,13 @@ class Herder
     // We are learning about a new transaction.
     virtual TransactionQueue::AddResult
     recvTransaction(TransactionFrameBasePtr tx) = 0;
+    // Same as recvTransaction, but the checks that do not depend on the ledger
+    // (hashes, signatures) may first be done on a worker thread. onResult is
+    // always called on the main thread. Transactions with the same source
+    // account are added in the order they were received.
+    virtual void recvTransactionAsync(
+        TransactionFrameBasePtr tx,
+        std::function<void(TransactionQueue::AddResult)> onResult) = 0;
     virtual void peerDoesntHave(stellar::MessageType type,
                                 uint256 const& itemID, Peer::pointer peer) = 0;
     virtual TxSetFramePtr getTxSet(Hash const& hash) = 0;
@@ -85,6 +85,13 @@ HerderImpl::HerderImpl(Application& app)
     auto ln = getSCP().getLocalNode();
     mPendingEnvelopes.addSCPQuorumSet(ln->getQuorumSetHash(),
                                       ln->getQuorumSet());
+
+    for (int i = 0; i < app.getConfig().TRANSACTION_ADMISSION_SHARDS; i++)
+    {
+        mTxAdmissionShards.emplace_back(
+            std::make_unique<asio::io_context::strand>(
+                app.getWorkerIOContext()));
+    }
 }
 
 HerderImpl::~HerderImpl()
@@ -321,6 +328,33 @@ HerderImpl::recvTransaction(TransactionFrameBasePtr tx)
     return result;
 }
 
+void
+HerderImpl::recvTransactionAsync(
+    TransactionFrameBasePtr tx,
+    std::function<void(TransactionQueue::AddResult)> onResult)
+{
+    if (mTxAdmissionShards.empty())
+    {
+        onResult(recvTransaction(tx));
+        return;
+    }
+
+    // Only this task touches tx until it is posted back to the main thread,
+    // and all transactions from a given source account go through the same
+    // strand so they reach the main thread in the order they were received.
+    auto shard = std::hash<AccountID>{}(tx->getSourceID()) %
+                 mTxAdmissionShards.size();
+    auto& app = mApp;
+    asio::post(*mTxAdmissionShards[shard], [&app, tx, onResult]() {
+        tx->preverifySignatures();
+        app.postOnMainThread(
+            [&app, tx, onResult]() {
+                onResult(app.getHerder().recvTransaction(tx));
+            },
+            "recvTransactionAsync");
+    });
+}
+
 bool
 HerderImpl::checkCloseTime(SCPEnvelope const& envelope, bool enforceRecent)
 {
@@ -749,14 +783,24 @@ HerderImpl::triggerNextLedger(uint32_t ledgerSeqToTrigger)
         return;
     }
 
-    // our first choice for this round's set is all the tx we have collected
-    // during last few ledger closes
+    // our first choice for this round's set is the best paying tx we have
+    // collected during last few ledger closes, limited to what fits in a
+    // ledger (so surge pricing is applied by the queue).
+    // Only that set is checked: invalid transactions are banned, which
+    // removes them (and those that follow them for the same account) from
+    // the queue, and the set is built again from what is left, until it is
+    // valid. This leaves no room to invalid transactions while only ever
+    // validating what is proposed.
     auto const& lcl = mLedgerManager.getLastClosedLedgerHeader();
-    auto proposedSet = mTransactionQueue.toTxSet(lcl);
-    auto removed = proposedSet->trimInvalid(mApp);
-    mTransactionQueue.ban(removed);
-
-    proposedSet->surgePricingFilter(mApp);
+    auto maxOps = mLedgerManager.getLastMaxTxSetSizeOps();
+    auto proposedSet = mTransactionQueue.toTxSet(lcl, maxOps);
+    for (auto removed = proposedSet->trimInvalid(mApp); !removed.empty();
+         removed = proposedSet->trimInvalid(mApp))
+    {
+        mTransactionQueue.ban(removed);
+        proposedSet = mTransactionQueue.toTxSet(lcl, maxOps);
+    }
+    proposedSet->sortForHash();
 
     if (!proposedSet->checkValid(mApp))
     {
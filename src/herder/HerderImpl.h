@@ -61,6 +61,9 @@ class HerderImpl : public Herder
 
     TransactionQueue::AddResult
     recvTransaction(TransactionFrameBasePtr tx) override;
+    void recvTransactionAsync(
+        TransactionFrameBasePtr tx,
+        std::function<void(TransactionQueue::AddResult)> onResult) override;
 
     EnvelopeStatus recvSCPEnvelope(SCPEnvelope const& envelope) override;
     EnvelopeStatus recvSCPEnvelope(SCPEnvelope const& envelope,
@@ -131,6 +134,10 @@ class HerderImpl : public Herder
 
     TransactionQueue mTransactionQueue;
 
+    // strands on the worker io_context used by recvTransactionAsync, a
+    // transaction always goes to the strand picked by its source account
+    std::vector<std::unique_ptr<asio::io_context::strand>> mTxAdmissionShards;
+
     void
     updateTransactionQueue(std::vector<TransactionFrameBasePtr> const& applied);
 
@@ -11,6 +11,7 @@
 #include "transactions/TransactionBridge.h"
 #include "transactions/TransactionUtils.h"
 #include "util/HashOfHash.h"
+#include "util/Logging.h"
 #include "util/XDROperators.h"
 
 #include <algorithm>
@@ -18,6 +19,7 @@
 #include <medida/meter.h>
 #include <medida/metrics_registry.h>
 #include <numeric>
+#include <queue>
 
 namespace stellar
 {
@@ -28,6 +30,10 @@ TransactionQueue::TransactionQueue(Application& app, int pendingDepth,
     : mApp(app)
     , mPendingDepth(pendingDepth)
     , mBannedTransactions(banDepth)
+    , mAccountHeads(FeeRateCompare{HashUtils::random()})
+    , mAccountTails(mAccountHeads.key_comp())
+    , mEvictedTransactions(app.getMetrics().NewMeter(
+          {"herder", "pending-txs", "evicted"}, "transaction"))
     , mLedgerVersion(app.getLedgerManager()
                          .getLastClosedLedgerHeader()
                          .header.ledgerVersion)
@@ -106,7 +112,8 @@ isDuplicateTx(TransactionFrameBasePtr oldTx, TransactionFrameBasePtr newTx)
 TransactionQueue::AddResult
 TransactionQueue::canAdd(TransactionFrameBasePtr tx,
                          AccountStates::iterator& stateIter,
-                         Transactions::iterator& oldTxIter)
+                         Transactions::iterator& oldTxIter,
+                         Transactions& txsToEvict)
 {
     if (isBanned(tx->getFullHash()))
     {
@@ -173,10 +180,15 @@ TransactionQueue::canAdd(TransactionFrameBasePtr tx,
         }
     }
 
-    if (netOps + mQueueSizeOps > maxQueueSizeOps())
+    auto const maxOps = maxQueueSizeOps();
+    if (netOps + mQueueSizeOps > maxOps)
     {
-        ban({tx});
-        return TransactionQueue::AddResult::ADD_STATUS_TRY_AGAIN_LATER;
+        auto opsToFree = static_cast<size_t>(netOps + mQueueSizeOps - maxOps);
+        if (!findTransactionsToEvict(tx, opsToFree, txsToEvict))
+        {
+            ban({tx});
+            return TransactionQueue::AddResult::ADD_STATUS_TRY_AGAIN_LATER;
+        }
     }
 
     LedgerTxn ltx(mApp.getLedgerTxnRoot());
@@ -201,6 +213,110 @@ TransactionQueue::canAdd(TransactionFrameBasePtr tx,
     return TransactionQueue::AddResult::ADD_STATUS_PENDING;
 }
 
+bool
+TransactionQueue::FeeRateCompare::operator()(
+    TransactionFrameBasePtr const& tx1,
+    TransactionFrameBasePtr const& tx2) const
+{
+    auto cmp = feeRate3WayCompare(tx1, tx2);
+    if (cmp != 0)
+    {
+        return cmp > 0;
+    }
+    // use hash of transaction as a tie breaker
+    return lessThanXored(tx1->getFullHash(), tx2->getFullHash(), mSeed);
+}
+
+void
+TransactionQueue::removeFromIndexes(AccountState const& state)
+{
+    if (!state.mTransactions.empty())
+    {
+        mAccountHeads.erase(state.mTransactions.front());
+        mAccountTails.erase(state.mTransactions.back());
+    }
+}
+
+void
+TransactionQueue::addToIndexes(AccountState const& state)
+{
+    if (!state.mTransactions.empty())
+    {
+        mAccountHeads.emplace(state.mTransactions.front());
+        mAccountTails.emplace(state.mTransactions.back());
+    }
+}
+
+bool
+TransactionQueue::findTransactionsToEvict(TransactionFrameBasePtr tx,
+                                          size_t opsToFree,
+                                          Transactions& txsToEvict) const
+{
+    // A candidate is a position in the queue of some account. The last
+    // transaction of every account comes from mAccountTails (walked from the
+    // lowest fee rate), the previous ones are only considered once the
+    // following one was picked and are kept in a heap with the lowest fee
+    // rate on top.
+    using Candidate = std::pair<Transactions const*, size_t>;
+    auto before = mAccountTails.key_comp();
+    auto better = [&before](Candidate const& c1, Candidate const& c2) {
+        return before((*c1.first)[c1.second], (*c2.first)[c2.second]);
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(better)>
+        predecessors(better);
+
+    auto tailIter = mAccountTails.rbegin();
+    size_t opsFreed = 0;
+    while (opsFreed < opsToFree)
+    {
+        Candidate cur;
+        if (predecessors.empty() ||
+            (tailIter != mAccountTails.rend() &&
+             before((*predecessors.top().first)[predecessors.top().second],
+                    *tailIter)))
+        {
+            if (tailIter == mAccountTails.rend())
+            {
+                return false;
+            }
+            auto stateIter = mAccountStates.find((*tailIter)->getSourceID());
+            assert(stateIter != mAccountStates.end());
+            auto const& transactions = stateIter->second.mTransactions;
+            cur = std::make_pair(&transactions, transactions.size() - 1);
+            ++tailIter;
+        }
+        else
+        {
+            cur = predecessors.top();
+            predecessors.pop();
+        }
+
+        auto const& evicted = (*cur.first)[cur.second];
+        // Candidates are visited by increasing fee rate, so none of the
+        // remaining ones can be evicted either
+        if (feeRate3WayCompare(evicted, tx) >= 0)
+        {
+            return false;
+        }
+
+        // Evicting transactions for the source account of tx could make tx
+        // invalid
+        if (evicted->getSourceID() == tx->getSourceID())
+        {
+            continue;
+        }
+
+        txsToEvict.emplace_back(evicted);
+        opsFreed += evicted->getNumOperations();
+        if (cur.second > 0)
+        {
+            predecessors.emplace(cur.first, cur.second - 1);
+        }
+    }
+
+    return true;
+}
+
 void
 TransactionQueue::releaseFeeMaybeEraseAccountState(TransactionFrameBasePtr tx)
 {
@@ -223,12 +339,38 @@ TransactionQueue::tryAdd(TransactionFrameBasePtr tx)
 {
     AccountStates::iterator stateIter;
     Transactions::iterator oldTxIter;
-    auto const res = canAdd(tx, stateIter, oldTxIter);
+    Transactions txsToEvict;
+    auto const res = canAdd(tx, stateIter, oldTxIter, txsToEvict);
     if (res != TransactionQueue::AddResult::ADD_STATUS_PENDING)
     {
         return res;
     }
 
+    if (!txsToEvict.empty())
+    {
+        // Evicting releases fees, which can erase the AccountState of the
+        // source account of tx if it has no transactions (the transactions
+        // of that account are never evicted).
+        bool const hadTransactions =
+            stateIter != mAccountStates.end() &&
+            !stateIter->second.mTransactions.empty();
+
+        // txsToEvict only contains transactions at the end of their account
+        // queue (or followed by other evicted transactions), so banning them
+        // does not drop anything else
+        ban(txsToEvict);
+        mEvictedTransactions.Mark(txsToEvict.size());
+
+        if (!hadTransactions)
+        {
+            stateIter = mAccountStates.find(tx->getSourceID());
+            if (stateIter != mAccountStates.end())
+            {
+                oldTxIter = stateIter->second.mTransactions.end();
+            }
+        }
+    }
+
     if (stateIter == mAccountStates.end())
     {
         stateIter =
@@ -236,6 +378,8 @@ TransactionQueue::tryAdd(TransactionFrameBasePtr tx)
         oldTxIter = stateIter->second.mTransactions.end();
     }
 
+    removeFromIndexes(stateIter->second);
+
     if (oldTxIter != stateIter->second.mTransactions.end())
     {
         releaseFeeMaybeEraseAccountState(*oldTxIter);
@@ -248,6 +392,9 @@ TransactionQueue::tryAdd(TransactionFrameBasePtr tx)
         stateIter->second.mTransactions.emplace_back(tx);
         mSizeByAge[stateIter->second.mAge]->inc();
     }
+
+    addToIndexes(stateIter->second);
+
     stateIter->second.mQueueSizeOps += tx->getNumOperations();
     mQueueSizeOps += tx->getNumOperations();
     mAccountStates[tx->getFeeSourceID()].mTotalFees += tx->getFeeBid();
@@ -271,8 +418,11 @@ TransactionQueue::dropTransactions(AccountStates::iterator stateIter,
         releaseFeeMaybeEraseAccountState(*iter);
     }
 
-    // Actually erase the transactions to be dropped.
+    // Actually erase the transactions to be dropped, keeping the fee rate
+    // indexes up to date.
+    removeFromIndexes(stateIter->second);
     stateIter->second.mTransactions.erase(begin, end);
+    addToIndexes(stateIter->second);
 
     // If the queue for stateIter is now empty, then (1) erase it if it is not
     // the fee-source for some other transaction or (2) reset the age otherwise.
@@ -483,6 +633,7 @@ TransactionQueue::shift()
             mQueueSizeOps -= it->second.mQueueSizeOps;
             it->second.mQueueSizeOps = 0;
 
+            removeFromIndexes(it->second);
             it->second.mTransactions.clear();
             if (it->second.mTotalFees == 0)
             {
@@ -551,6 +702,86 @@ TransactionQueue::toTxSet(LedgerHeaderHistoryEntry const& lcl) const
     return result;
 }
 
+std::shared_ptr<TxSetFrame>
+TransactionQueue::toTxSet(LedgerHeaderHistoryEntry const& lcl,
+                          size_t maxOps) const
+{
+    auto result = std::make_shared<TxSetFrame>(lcl.hash);
+
+    uint32_t const nextLedgerSeq = lcl.header.ledgerSeq + 1;
+    int64_t const startingSeq = getStartingSequenceNumber(nextLedgerSeq);
+    bool const maxIsOps = lcl.header.ledgerVersion >= 11;
+
+    // A candidate is a position in the queue of some account. The first
+    // candidate of every account comes from mAccountHeads (already sorted),
+    // the following ones are only considered once their predecessor was
+    // selected and are kept in a heap using the same ordering.
+    using Candidate = std::pair<Transactions const*, size_t>;
+    auto before = mAccountHeads.key_comp();
+    auto worse = [&before](Candidate const& c1, Candidate const& c2) {
+        return before((*c2.first)[c2.second], (*c1.first)[c1.second]);
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(worse)>
+        successors(worse);
+
+    auto headIter = mAccountHeads.begin();
+    size_t opsLeft = maxOps;
+    bool surged = false;
+    while (headIter != mAccountHeads.end() || !successors.empty())
+    {
+        if (opsLeft == 0)
+        {
+            surged = true;
+            break;
+        }
+
+        Candidate cur;
+        if (successors.empty() ||
+            (headIter != mAccountHeads.end() &&
+             before(*headIter,
+                    (*successors.top().first)[successors.top().second])))
+        {
+            auto stateIter = mAccountStates.find((*headIter)->getSourceID());
+            assert(stateIter != mAccountStates.end());
+            cur = std::make_pair(&stateIter->second.mTransactions, size_t(0));
+            ++headIter;
+        }
+        else
+        {
+            cur = successors.top();
+            successors.pop();
+        }
+
+        auto const& tx = (*cur.first)[cur.second];
+        size_t opsCount = maxIsOps ? tx->getNumOperations() : MAX_OPS_PER_TX;
+        if (opsCount > opsLeft)
+        {
+            // drop this transaction -> we need to drop the others for this
+            // account as well, which is done by not considering its successor
+            surged = true;
+            continue;
+        }
+
+        result->add(tx);
+        opsLeft -= opsCount;
+
+        // See toTxSet above for the starting sequence number constraint
+        if (tx->getSeqNum() != startingSeq - 1 &&
+            cur.second + 1 < cur.first->size())
+        {
+            successors.emplace(cur.first, cur.second + 1);
+        }
+    }
+
+    if (surged)
+    {
+        CLOG(WARNING, "Herder") << "surge pricing in effect! "
+                                << mQueueSizeOps << " > " << maxOps;
+    }
+
+    return result;
+}
+
 std::vector<TransactionQueue::ReplacedTransaction>
 TransactionQueue::maybeVersionUpgraded()
 {
@@ -575,6 +806,14 @@ TransactionQueue::maybeVersionUpgraded()
                 res.emplace_back(ReplacedTransaction{oldTxFrame, txFrame});
             }
         }
+
+        // the new frames have different hashes, rebuild the indexes
+        mAccountHeads.clear();
+        mAccountTails.clear();
+        for (auto const& kv : mAccountStates)
+        {
+            addToIndexes(kv.second);
+        }
     }
     mLedgerVersion = lcl.header.ledgerVersion;
 
@@ -13,6 +13,7 @@
 
 #include <deque>
 #include <memory>
+#include <set>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -20,6 +21,7 @@
 namespace medida
 {
 class Counter;
+class Meter;
 }
 
 namespace stellar
@@ -51,6 +53,15 @@ class Application;
  *   pendingDepth, all transactions for that source account are banned. It also
  *   unbans any transactions that have been banned for more than banDepth
  *   ledgers.
+ *
+ * The first and last transactions of every non-empty account queue are also
+ * kept in mAccountHeads and mAccountTails, ordered by fee rate. This allows
+ * toTxSet to build a surge priced transaction set by only visiting the
+ * transactions it selects, and tryAdd to evict the transactions with the
+ * lowest fee rate when the queue is full and a better transaction arrives.
+ * Transactions are only evicted from the end of an account queue, so that
+ * the remaining transactions are still valid, and are banned like the ones
+ * that are rejected when the queue is full.
  */
 class TransactionQueue
 {
@@ -125,6 +136,16 @@ class TransactionQueue
     std::shared_ptr<TxSetFrame>
     toTxSet(LedgerHeaderHistoryEntry const& lcl) const;
 
+    /**
+     * Build a transaction set for the ledger following lcl that contains at
+     * most maxOps operations (or maxOps / MAX_OPS_PER_TX transactions before
+     * protocol 11). Transactions are picked by decreasing fee rate the same
+     * way TxSetFrame::surgePricingFilter does, respecting sequence number
+     * order within each account.
+     */
+    std::shared_ptr<TxSetFrame> toTxSet(LedgerHeaderHistoryEntry const& lcl,
+                                        size_t maxOps) const;
+
     struct ReplacedTransaction
     {
         TransactionFrameBasePtr mOld;
@@ -148,19 +169,49 @@ class TransactionQueue
      */
     using BannedTransactions = std::deque<std::unordered_set<Hash>>;
 
+    /**
+     * Orders transactions from the highest to the lowest fee rate. Ties are
+     * broken using the full hash xored with a seed chosen when the queue is
+     * created, so that the order is total but not predictable.
+     */
+    struct FeeRateCompare
+    {
+        Hash mSeed;
+
+        bool operator()(TransactionFrameBasePtr const& tx1,
+                        TransactionFrameBasePtr const& tx2) const;
+    };
+    using FeeRateIndex = std::set<TransactionFrameBasePtr, FeeRateCompare>;
+
     Application& mApp;
     int const mPendingDepth;
     std::vector<medida::Counter*> mSizeByAge;
     AccountStates mAccountStates;
     BannedTransactions mBannedTransactions;
+    FeeRateIndex mAccountHeads;
+    FeeRateIndex mAccountTails;
+    medida::Meter& mEvictedTransactions;
     uint32_t mLedgerVersion;
 
     AddResult canAdd(TransactionFrameBasePtr tx,
                      AccountStates::iterator& stateIter,
-                     Transactions::iterator& oldTxIter);
+                     Transactions::iterator& oldTxIter,
+                     Transactions& txsToEvict);
+
+    // finds transactions with a fee rate strictly lower than the one of tx,
+    // from the end of account queues other than the one of tx, and worth at
+    // least opsToFree operations. Returns false if there are not enough of
+    // them.
+    bool findTransactionsToEvict(TransactionFrameBasePtr tx, size_t opsToFree,
+                                 Transactions& txsToEvict) const;
 
     void releaseFeeMaybeEraseAccountState(TransactionFrameBasePtr tx);
 
+    // must be called before (removeFromIndexes) and after (addToIndexes) any
+    // change to the front or the back of AccountState::mTransactions
+    void removeFromIndexes(AccountState const& state);
+    void addToIndexes(AccountState const& state);
+
     void dropTransactions(AccountStates::iterator stateIter,
                           Transactions::iterator begin,
                           Transactions::iterator end);
@@ -147,6 +147,26 @@ TxSetFrame::sortForApply()
     return retList;
 }
 
+int
+feeRate3WayCompare(TransactionFrameBasePtr const& tx1,
+                   TransactionFrameBasePtr const& tx2)
+{
+    // compare fee/numOps between tx1 and tx2
+    // getNumOperations >= 1 because this can only be used on valid
+    // transactions
+    auto v1 = bigMultiply(tx1->getFeeBid(), tx2->getNumOperations());
+    auto v2 = bigMultiply(tx2->getFeeBid(), tx1->getNumOperations());
+    if (v1 < v2)
+    {
+        return -1;
+    }
+    else if (v1 > v2)
+    {
+        return 1;
+    }
+    return 0;
+}
+
 struct SurgeCompare
 {
     Hash mSeed;
@@ -172,17 +192,10 @@ struct SurgeCompare
         auto& top2 = tx2->front();
 
         // compare fee/numOps between top1 and top2
-        // getNumOperations >= 1 because SurgeCompare can only be used on
-        // valid transactions
-        auto v1 = bigMultiply(top1->getFeeBid(), top2->getNumOperations());
-        auto v2 = bigMultiply(top2->getFeeBid(), top1->getNumOperations());
-        if (v1 < v2)
+        auto cmp = feeRate3WayCompare(top1, top2);
+        if (cmp != 0)
         {
-            return true;
-        }
-        else if (v1 > v2)
-        {
-            return false;
+            return cmp < 0;
         }
         // use hash of transaction as a tie breaker
         return lessThanXored(top1->getFullHash(), top2->getFullHash(), mSeed);
@@ -18,6 +18,12 @@ class Application;
 class TxSetFrame;
 typedef std::shared_ptr<TxSetFrame> TxSetFramePtr;
 
+// compares the fee rates (fee bid per operation) of tx1 and tx2, returns a
+// negative value if tx1 pays less per operation than tx2, 0 if both pay the
+// same and a positive value otherwise
+int feeRate3WayCompare(TransactionFrameBasePtr const& tx1,
+                       TransactionFrameBasePtr const& tx2);
+
 class AbstractTxSetFrameForApply
 {
   public:
@@ -6,6 +6,8 @@
 #include "herder/Herder.h"
 #include "herder/HerderImpl.h"
 #include "herder/TransactionQueue.h"
+#include "medida/meter.h"
+#include "medida/metrics_registry.h"
 #include "test/TestAccount.h"
 #include "test/TestUtils.h"
 #include "test/TxTests.h"
@@ -13,6 +15,7 @@
 #include "transactions/SignatureUtils.h"
 #include "util/Timer.h"
 
+#include <algorithm>
 #include <lib/catch.hpp>
 #include <numeric>
 
@@ -733,6 +736,174 @@ TEST_CASE("transaction queue starting sequence boundary",
     checkTxSet(4, 4);
 }
 
+TEST_CASE("transaction queue surge priced tx set",
+          "[herder][transactionqueue]")
+{
+    VirtualClock clock;
+    auto app = createTestApplication(clock, getTestConfig());
+    auto const minBalance2 = app->getLedgerManager().getLastMinBalance(2);
+
+    auto root = TestAccount::createRoot(*app);
+    auto acc1 = root.create("a1", minBalance2);
+    auto acc2 = root.create("a2", minBalance2);
+    auto acc3 = root.create("a3", minBalance2);
+
+    TransactionQueue tq(*app, 4, 10, 4);
+    std::vector<TransactionFrameBasePtr> txs1, txs2;
+    for (int64_t i = 1; i <= 3; ++i)
+    {
+        txs1.emplace_back(transaction(*app, acc1, i, 1, 100));
+        REQUIRE(tq.tryAdd(txs1.back()) ==
+                TransactionQueue::AddResult::ADD_STATUS_PENDING);
+    }
+    txs2.emplace_back(transaction(*app, acc2, 1, 1, 400));
+    txs2.emplace_back(transaction(*app, acc2, 2, 1, 300));
+    for (auto const& tx : txs2)
+    {
+        REQUIRE(tq.tryAdd(tx) ==
+                TransactionQueue::AddResult::ADD_STATUS_PENDING);
+    }
+    auto tx3 = transaction(*app, acc3, 1, 1, 200);
+    REQUIRE(tq.tryAdd(tx3) == TransactionQueue::AddResult::ADD_STATUS_PENDING);
+
+    auto const& lcl = app->getLedgerManager().getLastClosedLedgerHeader();
+    auto contains = [](TxSetFramePtr const& txSet,
+                       std::vector<TransactionFrameBasePtr> const& txs) {
+        auto const& setTxs = txSet->mTransactions;
+        return setTxs.size() == txs.size() &&
+               std::all_of(txs.begin(), txs.end(), [&](auto const& tx) {
+                   return std::find(setTxs.begin(), setTxs.end(), tx) !=
+                          setTxs.end();
+               });
+    };
+
+    SECTION("everything fits")
+    {
+        auto txSet = tq.toTxSet(lcl, 100);
+        REQUIRE(txSet->getContentsHash() == tq.toTxSet(lcl)->getContentsHash());
+    }
+
+    SECTION("highest fee rates first")
+    {
+        REQUIRE(contains(tq.toTxSet(lcl, 1), {txs2[0]}));
+        REQUIRE(contains(tq.toTxSet(lcl, 3), {txs2[0], txs2[1], tx3}));
+        REQUIRE(contains(tq.toTxSet(lcl, 5),
+                         {txs2[0], txs2[1], tx3, txs1[0], txs1[1]}));
+    }
+
+    SECTION("index follows queue updates")
+    {
+        tq.removeApplied({txs2[0]});
+        REQUIRE(contains(tq.toTxSet(lcl, 2), {txs2[1], tx3}));
+
+        tq.ban({txs2[1]});
+        REQUIRE(contains(tq.toTxSet(lcl, 2), {tx3, txs1[0]}));
+
+        auto fb = feeBump(*app, acc1, txs1[0], 2000);
+        REQUIRE(tq.tryAdd(fb) ==
+                TransactionQueue::AddResult::ADD_STATUS_PENDING);
+        REQUIRE(contains(tq.toTxSet(lcl, 3), {fb, tx3}));
+    }
+
+    SECTION("nothing fits")
+    {
+        REQUIRE(tq.toTxSet(lcl, 0)->mTransactions.empty());
+    }
+}
+
+TEST_CASE("transaction queue eviction", "[herder][transactionqueue]")
+{
+    VirtualClock clock;
+    auto cfg = getTestConfig();
+    cfg.TESTING_UPGRADE_MAX_TX_SET_SIZE = 4;
+    auto app = createTestApplication(clock, cfg);
+    auto const minBalance2 = app->getLedgerManager().getLastMinBalance(2);
+
+    auto root = TestAccount::createRoot(*app);
+    auto acc1 = root.create("a1", minBalance2);
+    auto acc2 = root.create("a2", minBalance2);
+    auto acc3 = root.create("a3", minBalance2);
+
+    auto& evicted = app->getMetrics().NewMeter(
+        {"herder", "pending-txs", "evicted"}, "transaction");
+    auto const evictedBefore = evicted.count();
+
+    // the queue can hold 4 operations
+    TransactionQueue tq(*app, 4, 10, 1);
+    std::vector<TransactionFrameBasePtr> txs1{
+        transaction(*app, acc1, 1, 1, 200),
+        transaction(*app, acc1, 2, 1, 200)};
+    std::vector<TransactionFrameBasePtr> txs2{
+        transaction(*app, acc2, 1, 1, 100),
+        transaction(*app, acc2, 2, 1, 300)};
+    for (auto const& tx : txs1)
+    {
+        REQUIRE(tq.tryAdd(tx) ==
+                TransactionQueue::AddResult::ADD_STATUS_PENDING);
+    }
+    for (auto const& tx : txs2)
+    {
+        REQUIRE(tq.tryAdd(tx) ==
+                TransactionQueue::AddResult::ADD_STATUS_PENDING);
+    }
+    REQUIRE(tq.getQueueSizeOps() == 4);
+
+    SECTION("lower fee is rejected")
+    {
+        auto tx = transaction(*app, acc3, 1, 1, 100);
+        REQUIRE(tq.tryAdd(tx) ==
+                TransactionQueue::AddResult::ADD_STATUS_TRY_AGAIN_LATER);
+        REQUIRE(tq.isBanned(tx->getFullHash()));
+        REQUIRE(evicted.count() == evictedBefore);
+    }
+
+    SECTION("same fee is rejected")
+    {
+        auto tx = transaction(*app, acc3, 1, 1, 200);
+        REQUIRE(tq.tryAdd(tx) ==
+                TransactionQueue::AddResult::ADD_STATUS_TRY_AGAIN_LATER);
+        REQUIRE(evicted.count() == evictedBefore);
+    }
+
+    SECTION("higher fee evicts the lowest account tail")
+    {
+        auto tx = transaction(*app, acc3, 1, 1, 250);
+        REQUIRE(tq.tryAdd(tx) ==
+                TransactionQueue::AddResult::ADD_STATUS_PENDING);
+        REQUIRE(tq.getQueueSizeOps() == 4);
+        REQUIRE(tq.isBanned(txs1[1]->getFullHash()));
+        REQUIRE(tq.getAccountTransactionQueueInfo(acc1).mMaxSeq ==
+                txs1[0]->getSeqNum());
+        REQUIRE(tq.getAccountTransactionQueueInfo(acc2).mMaxSeq ==
+                txs2[1]->getSeqNum());
+        REQUIRE(evicted.count() == evictedBefore + 1);
+    }
+
+    SECTION("higher fee evicts several transactions")
+    {
+        auto tx = transactionFromOperations(
+            *app, acc3, acc3.getLastSequenceNumber() + 1,
+            {payment(acc3, 1), payment(acc3, 1)}, 1000);
+        REQUIRE(tq.tryAdd(tx) ==
+                TransactionQueue::AddResult::ADD_STATUS_PENDING);
+        REQUIRE(tq.getQueueSizeOps() == 4);
+        REQUIRE(tq.isBanned(txs1[0]->getFullHash()));
+        REQUIRE(tq.isBanned(txs1[1]->getFullHash()));
+        REQUIRE(tq.getAccountTransactionQueueInfo(acc1).mQueueSizeOps == 0);
+        REQUIRE(tq.getAccountTransactionQueueInfo(acc2).mQueueSizeOps == 2);
+        REQUIRE(evicted.count() == evictedBefore + 2);
+    }
+
+    SECTION("transactions from the same account are not evicted")
+    {
+        auto tx = transaction(*app, acc1, 3, 1, 250);
+        REQUIRE(tq.tryAdd(tx) ==
+                TransactionQueue::AddResult::ADD_STATUS_TRY_AGAIN_LATER);
+        REQUIRE(tq.getAccountTransactionQueueInfo(acc1).mQueueSizeOps == 2);
+        REQUIRE(evicted.count() == evictedBefore);
+    }
+}
+
 TEST_CASE("transaction queue with fee-bump", "[herder][transactionqueue]")
 {
     VirtualClock clock;
@@ -1174,6 +1345,56 @@ TEST_CASE("replace by fee", "[herder][transactionqueue]")
     }
 }
 
+TEST_CASE("async transaction admission", "[herder][transactionqueue]")
+{
+    // worker threads run in real time
+    VirtualClock clock(VirtualClock::REAL_TIME);
+    auto cfg = getTestConfig();
+    cfg.TRANSACTION_ADMISSION_SHARDS = 2;
+    auto app = createTestApplication(clock, cfg);
+
+    auto& lm = app->getLedgerManager();
+    auto& herder = static_cast<HerderImpl&>(app->getHerder());
+    auto& tq = herder.getTransactionQueue();
+
+    auto root = TestAccount::createRoot(*app);
+    auto acc1 = root.create("a1", lm.getLastMinBalance(2));
+    auto acc2 = root.create("a2", lm.getLastMinBalance(2));
+
+    std::vector<TransactionFrameBasePtr> txs;
+    for (int64_t i = 1; i <= 5; ++i)
+    {
+        txs.emplace_back(transaction(*app, acc1, i, 1, 100));
+        txs.emplace_back(transaction(*app, acc2, i, 1, 100));
+    }
+
+    std::vector<TransactionQueue::AddResult> results;
+    for (auto const& tx : txs)
+    {
+        herder.recvTransactionAsync(tx, [&](TransactionQueue::AddResult res) {
+            results.emplace_back(res);
+        });
+    }
+    // results are only delivered on the main thread
+    REQUIRE(results.empty());
+
+    for (int i = 0; i < 1000 && results.size() < txs.size(); ++i)
+    {
+        clock.crank(true);
+    }
+
+    // transactions for a given account were added in order
+    REQUIRE(results.size() == txs.size());
+    for (auto res : results)
+    {
+        REQUIRE(res == TransactionQueue::AddResult::ADD_STATUS_PENDING);
+    }
+    REQUIRE(tq.getAccountTransactionQueueInfo(acc1).mMaxSeq ==
+            txs[8]->getSeqNum());
+    REQUIRE(tq.getAccountTransactionQueueInfo(acc2).mMaxSeq ==
+            txs[9]->getSeqNum());
+}
+
 TEST_CASE("remove applied", "[herder][transactionqueue]")
 {
     VirtualClock clock;
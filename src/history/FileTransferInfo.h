@@ -57,6 +57,12 @@ class FileTransferInfo
         return mType;
     }
 
+    std::string
+    getHexDigits() const
+    {
+        return mHexDigits;
+    }
+
     std::string
     localPath_nogz() const
     {
@@ -11,6 +11,7 @@
 #include "bucket/BucketList.h"
 #include "bucket/BucketManager.h"
 #include "crypto/Hex.h"
+#include "crypto/Random.h"
 #include "crypto/SHA.h"
 #include "history/HistoryManager.h"
 #include "lib/util/format.h"
@@ -381,6 +382,33 @@ HistoryArchive::~HistoryArchive()
 {
 }
 
+namespace
+{
+std::string const LOCAL_ARCHIVE_PREFIX = "file://";
+
+// Returns the directory named by a "file://" command template, or an empty
+// string if the template is an actual command.
+std::string
+localArchiveDir(std::string const& cmd)
+{
+    if (cmd.compare(0, LOCAL_ARCHIVE_PREFIX.size(), LOCAL_ARCHIVE_PREFIX) != 0)
+    {
+        return "";
+    }
+    auto dir = cmd.substr(LOCAL_ARCHIVE_PREFIX.size());
+    while (dir.size() > 1 && dir.back() == '/')
+    {
+        dir.pop_back();
+    }
+    if (dir.empty())
+    {
+        throw std::runtime_error("empty local history archive path in \"" +
+                                 cmd + "\"");
+    }
+    return dir;
+}
+}
+
 bool
 HistoryArchive::hasGetCmd() const
 {
@@ -431,6 +459,85 @@ HistoryArchive::mkdirCmd(std::string const& remoteDir) const
     return formatString(mConfig.mMkdirCmd, remoteDir);
 }
 
+std::function<void()>
+HistoryArchive::getFileJob(std::string const& remote,
+                           std::string const& local) const
+{
+    auto dir = localArchiveDir(mConfig.mGetCmd);
+    if (dir.empty())
+    {
+        return nullptr;
+    }
+    return [from = dir + "/" + remote, local]() {
+        if (!fs::exists(from))
+        {
+            throw std::runtime_error(from + " not found in archive");
+        }
+        fs::linkOrCopyFile(from, local);
+    };
+}
+
+std::function<void()>
+HistoryArchive::putFileJob(std::string const& local,
+                           std::string const& remote) const
+{
+    auto dir = localArchiveDir(mConfig.mPutCmd);
+    if (dir.empty())
+    {
+        return nullptr;
+    }
+    return [local, to = dir + "/" + remote]() {
+        // Readers of the archive must never see a partially written file,
+        // and an existing file is replaced just as `cp` would do. The
+        // temporary file gets a random name, as other writers (possibly other
+        // processes sharing the archive) may be putting the same file.
+        auto tmp = to + "." + binToHex(randomBytes(8)) + ".tmp";
+        try
+        {
+            fs::linkOrCopyFile(local, tmp);
+        }
+        catch (...)
+        {
+            std::remove(tmp.c_str());
+            throw;
+        }
+        auto slash = to.rfind('/');
+        if (!fs::durableRename(tmp, to, to.substr(0, slash)))
+        {
+            std::remove(tmp.c_str());
+            throw std::runtime_error("failed to rename " + tmp + " to " + to);
+        }
+    };
+}
+
+std::function<void()>
+HistoryArchive::mkdirJob(std::string const& remoteDir) const
+{
+    auto dir = localArchiveDir(mConfig.mPutCmd);
+    if (dir.empty())
+    {
+        return nullptr;
+    }
+    return [path = dir + "/" + remoteDir]() {
+        // Sibling jobs may be creating the same parents concurrently, which
+        // makes mkpath fail on a directory that now exists: just try again.
+        for (int attempt = 0; !fs::mkpath(path); ++attempt)
+        {
+            if (attempt == 3)
+            {
+                throw std::runtime_error("failed to create " + path);
+            }
+        }
+    };
+}
+
+std::string
+HistoryArchive::localFilePath(std::string const& remote) const
+{
+    auto dir = localArchiveDir(mConfig.mGetCmd);
+    return dir.empty() ? dir : dir + "/" + remote;
+}
+
 void
 HistoryArchive::markSuccess()
 {
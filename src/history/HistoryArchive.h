@@ -9,6 +9,7 @@
 #include "xdr/Stellar-types.h"
 
 #include <cereal/cereal.hpp>
+#include <functional>
 #include <memory>
 #include <string>
 #include <system_error>
@@ -151,6 +152,20 @@ class HistoryArchive : public std::enable_shared_from_this<HistoryArchive>
                            std::string const& remote) const;
     std::string mkdirCmd(std::string const& remoteDir) const;
 
+    // A get or put "command" of the form "file:///some/dir" makes the archive
+    // a local directory, read or written in-process instead of by spawning a
+    // command per file. These return the job to run (on a background thread)
+    // in place of the corresponding command, or nullptr if the archive uses
+    // commands.
+    std::function<void()> getFileJob(std::string const& remote,
+                                     std::string const& local) const;
+    std::function<void()> putFileJob(std::string const& local,
+                                     std::string const& remote) const;
+    std::function<void()> mkdirJob(std::string const& remoteDir) const;
+    // Path of `remote` in the directory of a local archive, or an empty
+    // string if the archive is not read from a local directory.
+    std::string localFilePath(std::string const& remote) const;
+
     void markSuccess();
     void markFailure();
 
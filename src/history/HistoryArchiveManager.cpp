@@ -3,6 +3,8 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "history/HistoryArchiveManager.h"
+#include "crypto/Hex.h"
+#include "history/FileTransferInfo.h"
 #include "history/HistoryArchive.h"
 #include "historywork/GetHistoryArchiveStateWork.h"
 #include "historywork/PutHistoryArchiveStateWork.h"
@@ -12,6 +14,7 @@
 #include "util/Math.h"
 #include "work/WorkScheduler.h"
 
+#include <functional>
 #include <vector>
 
 namespace stellar
@@ -22,6 +25,15 @@ HistoryArchiveManager::HistoryArchiveManager(Application& app) : mApp{app}
     for (auto const& archiveConfiguration : mApp.getConfig().HISTORY)
         mArchives.push_back(
             std::make_shared<HistoryArchive>(app, archiveConfiguration.second));
+
+    auto const& cacheDir = mApp.getConfig().HISTORY_CACHE_DIR;
+    if (!cacheDir.empty())
+    {
+        auto url = "file://" + cacheDir;
+        mCache = std::make_shared<HistoryArchive>(
+            app, HistoryArchiveConfiguration{"cache", url, url, ""});
+        mCacheIndexDir = binToHex(mApp.getNetworkID()).substr(0, 16);
+    }
 }
 
 bool
@@ -112,8 +124,8 @@ HistoryArchiveManager::checkSensibleConfig() const
     return true;
 }
 
-std::shared_ptr<HistoryArchive>
-HistoryArchiveManager::selectRandomReadableHistoryArchive() const
+std::vector<std::shared_ptr<HistoryArchive>>
+HistoryArchiveManager::getReadableHistoryArchives() const
 {
     std::vector<std::shared_ptr<HistoryArchive>> archives;
 
@@ -139,7 +151,14 @@ HistoryArchiveManager::selectRandomReadableHistoryArchive() const
     {
         throw std::runtime_error("No GET-enabled history archive in config");
     }
-    else if (archives.size() == 1)
+    return archives;
+}
+
+std::shared_ptr<HistoryArchive>
+HistoryArchiveManager::selectRandomReadableHistoryArchive() const
+{
+    auto archives = getReadableHistoryArchives();
+    if (archives.size() == 1)
     {
         CLOG(DEBUG, "History")
             << "Fetching from sole readable history archive '"
@@ -156,6 +175,35 @@ HistoryArchiveManager::selectRandomReadableHistoryArchive() const
     }
 }
 
+std::shared_ptr<HistoryArchive>
+HistoryArchiveManager::selectStripedReadableHistoryArchive(
+    std::string const& key) const
+{
+    auto archives = getReadableHistoryArchives();
+    auto i = std::hash<std::string>{}(key) % archives.size();
+    CLOG(TRACE, "History") << "Fetching " << key << " from readable archive #"
+                           << i << ", '" << archives[i]->getName() << "'";
+    return archives[i];
+}
+
+std::shared_ptr<HistoryArchive>
+HistoryArchiveManager::getCacheArchive() const
+{
+    return mCache;
+}
+
+std::string
+HistoryArchiveManager::getCacheObjectName(std::string const& hexHash)
+{
+    return "objects/" + hexHash.substr(0, 2) + "/" + hexHash + ".xdr.gz";
+}
+
+std::string
+HistoryArchiveManager::getCacheIndexName(FileTransferInfo const& ft) const
+{
+    return mCacheIndexDir + "/" + ft.remoteName() + ".sha256";
+}
+
 bool
 HistoryArchiveManager::initializeHistoryArchive(std::string const& arch) const
 {
@@ -12,6 +12,7 @@ namespace stellar
 {
 class Application;
 class Config;
+class FileTransferInfo;
 class HistoryArchive;
 
 class HistoryArchiveManager
@@ -26,6 +27,12 @@ class HistoryArchiveManager
     // select one at random.
     std::shared_ptr<HistoryArchive> selectRandomReadableHistoryArchive() const;
 
+    // Select a readable history archive determined by `key`, so that files
+    // fetched by key (e.g. their remote name) are spread evenly across all
+    // the archives rather than all being fetched from the same one.
+    std::shared_ptr<HistoryArchive>
+    selectStripedReadableHistoryArchive(std::string const& key) const;
+
     // Initialize a named history archive by writing
     // .well-known/stellar-history.json to it.
     bool initializeHistoryArchive(std::string const& arch) const;
@@ -45,8 +52,30 @@ class HistoryArchiveManager
 
     double getFailureRate() const;
 
+    // Returns the local directory archive in HISTORY_CACHE_DIR that keeps
+    // downloaded files, or nullptr if there is no cache. It is not one of the
+    // configured archives: it's only read from and written to explicitly.
+    //
+    // The cache is content-addressed: getCacheObjectName gives where a
+    // gzipped file is stored, by the SHA256 of its decompressed content.
+    // Buckets are found by their hash directly. Other files are found
+    // through getCacheIndexName, a file holding the hex hash of their
+    // content, which is only written once that content has been verified.
+    std::shared_ptr<HistoryArchive> getCacheArchive() const;
+    static std::string getCacheObjectName(std::string const& hexHash);
+    std::string getCacheIndexName(FileTransferInfo const& ft) const;
+
   private:
+    // Archives to read from: those that _only_ have a get command if there
+    // are any, or else all those with a get command.
+    std::vector<std::shared_ptr<HistoryArchive>>
+    getReadableHistoryArchives() const;
+
     Application& mApp;
     std::vector<std::shared_ptr<HistoryArchive>> mArchives;
+    std::shared_ptr<HistoryArchive> mCache;
+    // Checkpoint files are only meaningful within one network, so they are
+    // indexed per network
+    std::string mCacheIndexDir;
 };
 }
@@ -209,6 +209,9 @@ class HistoryManager
     // may be different (see ARTIFICIALLY_ACCELERATE_TIME_FOR_TESTING).
     virtual uint32_t getCheckpointFrequency() const = 0;
 
+    // Checkpoint frequency for `cfg`, for use before an Application exists.
+    static uint32_t getCheckpointFrequency(Config const& cfg);
+
     // Return checkpoint that contains given ledger. Checkpoint is identified
     // by last ledger in range. This does not consult the network nor take
     // account of manual checkpoints.
@@ -82,9 +82,9 @@ HistoryManagerImpl::~HistoryManagerImpl()
 }
 
 uint32_t
-HistoryManagerImpl::getCheckpointFrequency() const
+HistoryManager::getCheckpointFrequency(Config const& cfg)
 {
-    if (mApp.getConfig().ARTIFICIALLY_ACCELERATE_TIME_FOR_TESTING)
+    if (cfg.ARTIFICIALLY_ACCELERATE_TIME_FOR_TESTING)
     {
         return 8;
     }
@@ -94,6 +94,12 @@ HistoryManagerImpl::getCheckpointFrequency() const
     }
 }
 
+uint32_t
+HistoryManagerImpl::getCheckpointFrequency() const
+{
+    return HistoryManager::getCheckpointFrequency(mApp.getConfig());
+}
+
 uint32_t
 HistoryManagerImpl::checkpointContainingLedger(uint32_t ledger) const
 {
@@ -59,18 +59,19 @@ StateSnapshot::writeHistoryBlocks() const
     // headers, one TransactionHistoryEntry (which contain txSets),
     // one TransactionHistoryResultEntry containing transaction set results and
     // one (optional) SCPHistoryEntry containing the SCP messages used to close.
-    // All files are streamed out of the database, entry-by-entry.
+    // All files are streamed out of the database, entry-by-entry, and
+    // compressed as they are written: they are ready for upload as is.
     size_t nbSCPMessages;
     uint32_t begin, count;
     size_t nHeaders;
     {
         bool doFsync = !mApp.getConfig().DISABLE_XDR_FSYNC;
-        XDROutputFileStream ledgerOut(doFsync), txOut(doFsync),
-            txResultOut(doFsync), scpHistory(doFsync);
-        ledgerOut.open(mLedgerSnapFile->localPath_nogz());
-        txOut.open(mTransactionSnapFile->localPath_nogz());
-        txResultOut.open(mTransactionResultSnapFile->localPath_nogz());
-        scpHistory.open(mSCPHistorySnapFile->localPath_nogz());
+        XDROutputFileStream ledgerOut(doFsync, true), txOut(doFsync, true),
+            txResultOut(doFsync, true), scpHistory(doFsync, true);
+        ledgerOut.open(mLedgerSnapFile->localPath_gz());
+        txOut.open(mTransactionSnapFile->localPath_gz());
+        txResultOut.open(mTransactionResultSnapFile->localPath_gz());
+        scpHistory.open(mSCPHistorySnapFile->localPath_gz());
 
         // 'mLocalState' describes the LCL, so its currentLedger will usually be
         // 63,
@@ -90,24 +91,24 @@ StateSnapshot::writeHistoryBlocks() const
             copyTransactionsToStream(mApp.getNetworkID(), mApp.getDatabase(),
                                      sess, begin, count, txOut, txResultOut);
         CLOG(DEBUG, "History") << "Wrote " << nHeaders << " ledger headers to "
-                               << mLedgerSnapFile->localPath_nogz();
+                               << mLedgerSnapFile->localPath_gz();
         CLOG(DEBUG, "History")
             << "Wrote " << nTxs << " transactions to "
-            << mTransactionSnapFile->localPath_nogz() << " and "
-            << mTransactionResultSnapFile->localPath_nogz();
+            << mTransactionSnapFile->localPath_gz() << " and "
+            << mTransactionResultSnapFile->localPath_gz();
 
         nbSCPMessages = HerderPersistence::copySCPHistoryToStream(
             mApp.getDatabase(), sess, begin, count, scpHistory);
 
         CLOG(DEBUG, "History")
             << "Wrote " << nbSCPMessages << " SCP messages to "
-            << mSCPHistorySnapFile->localPath_nogz();
+            << mSCPHistorySnapFile->localPath_gz();
     }
 
     if (nbSCPMessages == 0)
     {
         // don't upload empty files
-        std::remove(mSCPHistorySnapFile->localPath_nogz().c_str());
+        std::remove(mSCPHistorySnapFile->localPath_gz().c_str());
     }
 
     // When writing checkpoint 0x3f (63) we will have written 63 headers because
@@ -124,7 +125,7 @@ StateSnapshot::writeHistoryBlocks() const
     {
         CLOG(WARNING, "History")
             << "Only wrote " << nHeaders << " ledger headers for "
-            << mLedgerSnapFile->localPath_nogz() << ", expecting " << count
+            << mLedgerSnapFile->localPath_gz() << ", expecting " << count
             << ", will retry";
         return false;
     }
@@ -136,23 +137,25 @@ std::vector<std::shared_ptr<FileTransferInfo>>
 StateSnapshot::differingHASFiles(HistoryArchiveState const& other)
 {
     std::vector<std::shared_ptr<FileTransferInfo>> files{};
-    auto addIfExists = [&](std::shared_ptr<FileTransferInfo> const& f) {
-        if (f && fs::exists(f->localPath_nogz()))
+    auto addIfExists = [&](std::shared_ptr<FileTransferInfo> const& f,
+                           bool gz) {
+        if (f && fs::exists(gz ? f->localPath_gz() : f->localPath_nogz()))
         {
             files.push_back(f);
         }
     };
 
-    addIfExists(mLedgerSnapFile);
-    addIfExists(mTransactionSnapFile);
-    addIfExists(mTransactionResultSnapFile);
-    addIfExists(mSCPHistorySnapFile);
+    // history blocks are written compressed, see writeHistoryBlocks
+    addIfExists(mLedgerSnapFile, true);
+    addIfExists(mTransactionSnapFile, true);
+    addIfExists(mTransactionResultSnapFile, true);
+    addIfExists(mSCPHistorySnapFile, true);
 
     for (auto const& hash : mLocalState.differingBuckets(other))
     {
         auto b = mApp.getBucketManager().getBucketByHash(hexToBin256(hash));
         assert(b);
-        addIfExists(std::make_shared<FileTransferInfo>(*b));
+        addIfExists(std::make_shared<FileTransferInfo>(*b), false);
     }
 
     return files;
@@ -4,8 +4,13 @@
 
 #include "bucket/BucketManager.h"
 #include "bucket/BucketTests.h"
+#include "catchup/DecodeCheckpointWork.h"
 #include "catchup/test/CatchupWorkTests.h"
+#include "crypto/Hex.h"
+#include "crypto/Random.h"
+#include "crypto/SHA.h"
 #include "history/FileTransferInfo.h"
+#include "history/HistoryArchive.h"
 #include "history/HistoryArchiveManager.h"
 #include "history/HistoryManager.h"
 #include "history/test/HistoryTestsUtils.h"
@@ -32,6 +37,10 @@
 #include <lib/catch.hpp>
 #include <lib/util/format.h>
 
+#include <atomic>
+#include <fstream>
+#include <thread>
+
 using namespace stellar;
 using namespace historytestutils;
 
@@ -72,10 +81,13 @@ TEST_CASE("HistoryManager compress", "[history]")
     REQUIRE(!fs::exists(fname));
     REQUIRE(fs::exists(compressed));
 
-    auto u = wm.executeWork<GunzipFileWork>(compressed);
+    auto contentHash = std::make_shared<uint256>();
+    auto u = wm.executeWork<GunzipFileWork>(
+        compressed, false, BasicWork::RETRY_NEVER, contentHash);
     REQUIRE(u->getState() == BasicWork::State::WORK_SUCCESS);
     REQUIRE(fs::exists(fname));
     REQUIRE(!fs::exists(compressed));
+    REQUIRE(*contentHash == sha256(s));
 }
 
 TEST_CASE("HistoryArchiveState get_put", "[history]")
@@ -415,6 +427,93 @@ TEST_CASE("History publish to multiple archives", "[history]")
     REQUIRE(catchupSimulation.catchupOffline(catchupApp, checkpointLedger));
 }
 
+TEST_CASE("History catchup across archives with a download cache",
+          "[history][catchup]")
+{
+    auto cg =
+        std::make_shared<MultiArchiveHistoryConfigurator>(/* numArchives */ 3);
+    CatchupSimulation catchupSimulation{VirtualClock::VIRTUAL_TIME, cg, false};
+
+    auto& app = catchupSimulation.getApp();
+    for (auto const& cfgtor : cg->getConfigurators())
+    {
+        CHECK(app.getHistoryArchiveManager().initializeHistoryArchive(
+            cfgtor->getArchiveDirName()));
+    }
+
+    app.start();
+    auto checkpointLedger = catchupSimulation.getLastCheckpointLedger(3);
+    catchupSimulation.ensureOfflineCatchupPossible(checkpointLedger);
+
+    TmpDirManager tdm(std::string("history-cache-") +
+                      binToHex(randomBytes(8)));
+    TmpDir cacheDir = tdm.tmpDir("cache");
+    auto catchupWithCache = [&](std::string const& name) {
+        auto catchupApp = catchupSimulation.createCatchupApplication(
+            std::numeric_limits<uint32_t>::max(),
+            Config::TESTDB_IN_MEMORY_SQLITE, name, /* publish */ false,
+            [&](Config& cfg) { cfg.HISTORY_CACHE_DIR = cacheDir.getName(); });
+        REQUIRE(catchupSimulation.catchupOffline(catchupApp, checkpointLedger));
+        return catchupApp;
+    };
+    auto cacheCount = [](Application::pointer app, std::string const& name) {
+        return app->getMetrics()
+            .NewMeter({"history", "cache", name}, "event")
+            .count();
+    };
+
+    // The first catchup downloads everything, spread across the archives
+    auto first = catchupWithCache("first");
+    auto downloaded = cacheCount(first, "miss");
+    REQUIRE(downloaded > 0);
+    REQUIRE(cacheCount(first, "hit") == 0);
+    size_t archivesUsed = 0;
+    for (auto const& cfgtor : cg->getConfigurators())
+    {
+        auto archive = first->getHistoryArchiveManager().getHistoryArchive(
+            cfgtor->getArchiveDirName());
+        archivesUsed += archive->getSuccessCount() > 0 ? 1 : 0;
+    }
+    REQUIRE(archivesUsed > 1);
+
+    // The second one finds the same files in the cache
+    auto second = catchupWithCache("second");
+    REQUIRE(cacheCount(second, "hit") == downloaded);
+    REQUIRE(cacheCount(second, "miss") == 0);
+
+    // Files are stored by the hash of their content, found through an index
+    // for files other than buckets
+    auto const& ham = second->getHistoryArchiveManager();
+    auto cache = ham.getCacheArchive();
+    auto readFile = [](std::string const& path) {
+        std::ifstream in(path, std::ifstream::binary);
+        REQUIRE(in);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+    };
+    auto cachedObject = [&](uint32_t checkpoint) {
+        FileTransferInfo ft(cacheDir, HISTORY_FILE_TYPE_LEDGER, checkpoint);
+        auto index = cache->localFilePath(ham.getCacheIndexName(ft));
+        auto hexHash = readFile(index);
+        REQUIRE(hexHash.size() == 64);
+        return cache->localFilePath(
+            HistoryArchiveManager::getCacheObjectName(hexHash));
+    };
+    auto& hm = second->getHistoryManager();
+    auto corrupted = cachedObject(hm.checkpointContainingLedger(1));
+    auto other = cachedObject(checkpointLedger);
+    REQUIRE(corrupted != other);
+    auto original = readFile(corrupted);
+
+    // A cached file that doesn't match its hash is evicted and downloaded
+    // again, then added back once verified
+    std::remove(corrupted.c_str());
+    fs::linkOrCopyFile(other, corrupted);
+    auto third = catchupWithCache("third");
+    REQUIRE(cacheCount(third, "hit") == downloaded);
+    REQUIRE(cacheCount(third, "miss") == 1);
+    REQUIRE(readFile(corrupted) == original);
+}
+
 TEST_CASE("History catchup with extra validation", "[history][publish]")
 {
     CatchupSimulation catchupSimulation{};
@@ -647,6 +746,157 @@ TEST_CASE("Publish throttles catchup", "[history][catchup][acceptance]")
     REQUIRE(catchupSimulation.catchupOffline(app, checkpointLedger));
 }
 
+TEST_CASE("decoded checkpoints memory budget", "[history][catchup]")
+{
+    auto budget = std::make_shared<DecodedCheckpointBudget>(1000);
+    std::vector<std::shared_ptr<DecodedCheckpoint>> checkpoints(4);
+    for (auto& cp : checkpoints)
+    {
+        cp = std::make_shared<DecodedCheckpoint>();
+        cp->mBudget = budget;
+    }
+    VirtualClock::time_point now;
+
+    // decodes in flight count against the budget
+    REQUIRE(checkpoints[0]->reserve(600, false));
+    REQUIRE(!checkpoints[1]->reserve(600, false));
+    REQUIRE(checkpoints[1]->reserve(400, false));
+    REQUIRE(budget->mUsedBytes == 1000);
+    REQUIRE(!checkpoints[2]->reserve(1, false));
+
+    // decoding replaces the estimate with the actual size
+    checkpoints[0]->setDecoded({}, {}, 500, now);
+    REQUIRE(budget->mUsedBytes == 900);
+    REQUIRE(checkpoints[2]->reserve(100, false));
+    REQUIRE(budget->mUsedBytes == 1000);
+
+    // a failed decode returns its reservation
+    checkpoints[2]->abandon();
+    REQUIRE(budget->mUsedBytes == 900);
+
+    // the next checkpoint to apply is decoded regardless of the budget
+    REQUIRE(checkpoints[3]->reserve(700, true));
+    REQUIRE(budget->mUsedBytes == 1600);
+
+    checkpoints[1]->setDecoded({}, {}, 400, now);
+    checkpoints[3]->setDecoded({}, {}, 700, now);
+    for (auto const& i : {0, 1, 3})
+    {
+        checkpoints[i]->release(now);
+        REQUIRE(checkpoints[i]->mApplied);
+    }
+    REQUIRE(budget->mUsedBytes == 0);
+}
+
+TEST_CASE("History catchup with bounded prefetch", "[history][catchup]")
+{
+    CatchupSimulation catchupSimulation{};
+    auto checkpointLedger = catchupSimulation.getLastCheckpointLedger(5);
+    catchupSimulation.ensureOfflineCatchupPossible(checkpointLedger);
+
+    auto catchupWith = [&](int checkpoints, int memoryMB) {
+        auto app = catchupSimulation.createCatchupApplication(
+            std::numeric_limits<uint32_t>::max(),
+            Config::TESTDB_IN_MEMORY_SQLITE,
+            fmt::format("prefetch {} checkpoints, {}MB", checkpoints,
+                        memoryMB),
+            /* publish */ false, [&](Config& cfg) {
+                cfg.CATCHUP_PREFETCH_CHECKPOINTS = checkpoints;
+                cfg.CATCHUP_PREFETCH_MEMORY_MB = memoryMB;
+            });
+        REQUIRE(catchupSimulation.catchupOffline(app, checkpointLedger));
+    };
+
+    SECTION("one checkpoint at a time")
+    {
+        catchupWith(1, 256);
+    }
+    SECTION("no memory to decode ahead")
+    {
+        catchupWith(4, 0);
+    }
+    SECTION("decode ahead")
+    {
+        catchupWith(4, 256);
+    }
+}
+
+TEST_CASE("History publish and catchup with a local directory archive",
+          "[history][catchup]")
+{
+    auto configurator = std::make_shared<LocalDirHistoryConfigurator>();
+    CatchupSimulation catchupSimulation{VirtualClock::VIRTUAL_TIME,
+                                        configurator};
+    auto checkpointLedger = catchupSimulation.getLastCheckpointLedger(3);
+    catchupSimulation.ensureOfflineCatchupPossible(checkpointLedger);
+
+    auto archive = catchupSimulation.getApp()
+                        .getHistoryArchiveManager()
+                        .getHistoryArchive(configurator->getArchiveDirName());
+    REQUIRE(archive);
+    REQUIRE(archive->getFileJob("a", "b"));
+    REQUIRE(archive->putFileJob("a", "b"));
+    REQUIRE(archive->getFailureCount() == 0);
+
+    {
+        // Writers putting the same file concurrently (such as instances
+        // sharing a cache) don't clobber each other's temporary file
+        auto tmp =
+            catchupSimulation.getApp().getTmpDirManager().tmpDir("put-file");
+        std::vector<std::string> contents{std::string(100000, 'a'),
+                                          std::string(100000, 'b')};
+        std::vector<std::function<void()>> jobs;
+        for (size_t i = 0; i < contents.size(); ++i)
+        {
+            auto local = tmp.getName() + "/" + std::to_string(i);
+            std::ofstream(local, std::ofstream::binary) << contents[i];
+            jobs.emplace_back(archive->putFileJob(local, "concurrent/file"));
+        }
+        archive->mkdirJob("concurrent")();
+
+        std::atomic<int> failures{0};
+        for (int round = 0; round < 20; ++round)
+        {
+            std::vector<std::thread> threads;
+            for (auto const& job : jobs)
+            {
+                threads.emplace_back([&job, &failures]() {
+                    try
+                    {
+                        job();
+                    }
+                    catch (std::exception const&)
+                    {
+                        ++failures;
+                    }
+                });
+            }
+            for (auto& t : threads)
+            {
+                t.join();
+            }
+        }
+        REQUIRE(failures == 0);
+
+        auto path = archive->localFilePath("concurrent/file");
+        std::ifstream in(path, std::ifstream::binary);
+        std::string got((std::istreambuf_iterator<char>(in)),
+                        std::istreambuf_iterator<char>());
+        REQUIRE(std::find(contents.begin(), contents.end(), got) !=
+                contents.end());
+        auto leftovers = fs::findfiles(
+            archive->localFilePath("concurrent"), [](std::string const& name) {
+                return name.find(".tmp") != std::string::npos;
+            });
+        REQUIRE(leftovers.empty());
+    }
+
+    auto app = catchupSimulation.createCatchupApplication(
+        std::numeric_limits<uint32_t>::max(), Config::TESTDB_IN_MEMORY_SQLITE,
+        "local directory archive");
+    REQUIRE(catchupSimulation.catchupOffline(app, checkpointLedger));
+}
+
 TEST_CASE("History catchup with different modes",
           "[history][catchup][acceptance]")
 {
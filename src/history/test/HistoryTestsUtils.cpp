@@ -124,6 +124,16 @@ RealGenesisTmpDirHistoryConfigurator::configure(Config& mCfg,
     return mCfg;
 }
 
+Config&
+LocalDirHistoryConfigurator::configure(Config& cfg, bool writable) const
+{
+    std::string d = getArchiveDirName();
+    std::string url = "file://" + d;
+    cfg.HISTORY[d] =
+        HistoryArchiveConfiguration{d, url, writable ? url : "", ""};
+    return cfg;
+}
+
 BucketOutputIteratorForTesting::BucketOutputIteratorForTesting(
     std::string const& tmpDir, uint32_t protocolVersion, MergeCounters& mc)
     : BucketOutputIterator{tmpDir, true,
@@ -636,10 +646,9 @@ CatchupSimulation::crankUntil(Application::pointer app,
 }
 
 Application::pointer
-CatchupSimulation::createCatchupApplication(uint32_t count,
-                                            Config::TestDbMode dbMode,
-                                            std::string const& appName,
-                                            bool publish)
+CatchupSimulation::createCatchupApplication(
+    uint32_t count, Config::TestDbMode dbMode, std::string const& appName,
+    bool publish, std::function<void(Config&)> const& configure)
 {
     CLOG(INFO, "History") << "****";
     CLOG(INFO, "History") << "**** Create app for catchup: '" << appName << "'";
@@ -650,6 +659,10 @@ CatchupSimulation::createCatchupApplication(uint32_t count,
     mCfgs.back().CATCHUP_COMPLETE =
         count == std::numeric_limits<uint32_t>::max();
     mCfgs.back().CATCHUP_RECENT = count;
+    if (configure)
+    {
+        configure(mCfgs.back());
+    }
     mSpawnedAppsClocks.emplace_front();
     return createTestApplication(
         mSpawnedAppsClocks.front(),
@@ -97,6 +97,14 @@ class RealGenesisTmpDirHistoryConfigurator : public TmpDirHistoryConfigurator
     Config& configure(Config& cfg, bool writable) const override;
 };
 
+// Same archive as TmpDirHistoryConfigurator, but accessed in-process through
+// "file://" URLs rather than by cp / mkdir commands.
+class LocalDirHistoryConfigurator : public TmpDirHistoryConfigurator
+{
+  public:
+    Config& configure(Config& cfg, bool writable) const override;
+};
+
 class BucketOutputIteratorForTesting : public BucketOutputIterator
 {
     const size_t NUM_ITEMS_PER_BUCKET = 5;
@@ -271,10 +279,10 @@ class CatchupSimulation
     void ensureOnlineCatchupPossible(uint32_t targetLedger,
                                      uint32_t bufferLedgers = 0);
 
-    Application::pointer createCatchupApplication(uint32_t count,
-                                                  Config::TestDbMode dbMode,
-                                                  std::string const& appName,
-                                                  bool publish = false);
+    Application::pointer createCatchupApplication(
+        uint32_t count, Config::TestDbMode dbMode, std::string const& appName,
+        bool publish = false,
+        std::function<void(Config&)> const& configure = nullptr);
     bool catchupOffline(Application::pointer app, uint32_t toLedger,
                         bool extraValidation = false);
     bool catchupOnline(Application::pointer app, uint32_t initLedger,
@@ -0,0 +1,150 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "historywork/AddToHistoryCacheWork.h"
+#include "crypto/Hex.h"
+#include "crypto/SHA.h"
+#include "history/HistoryArchive.h"
+#include "history/HistoryArchiveManager.h"
+#include "main/Application.h"
+#include "util/Fs.h"
+#include "util/Logging.h"
+
+#include <fstream>
+
+namespace stellar
+{
+
+namespace
+{
+struct CacheItem
+{
+    std::string mGz;
+    std::string mNoGz;
+    // Known for buckets, computed from mNoGz otherwise
+    std::string mHexHash;
+    // Empty for buckets, which are found by their hash
+    std::string mIndexName;
+};
+
+std::string
+hashFile(std::string const& path)
+{
+    auto hasher = SHA256::create();
+    std::ifstream in(path, std::ifstream::binary);
+    if (!in)
+    {
+        throw std::runtime_error("failed to open " + path);
+    }
+    std::vector<char> buf(64 * 1024);
+    while (in)
+    {
+        in.read(buf.data(), buf.size());
+        if (in.bad())
+        {
+            throw std::runtime_error("failed to read " + path);
+        }
+        hasher->add(ByteSlice(buf.data(), in.gcount()));
+    }
+    return binToHex(hasher->finish());
+}
+
+std::string
+parentDir(std::string const& remoteName)
+{
+    return remoteName.substr(0, remoteName.rfind('/'));
+}
+
+void
+addToCache(HistoryArchive const& cache, CacheItem const& item)
+{
+    if (!item.mIndexName.empty() &&
+        fs::exists(cache.localFilePath(item.mIndexName)))
+    {
+        return;
+    }
+
+    auto hexHash =
+        item.mHexHash.empty() ? hashFile(item.mNoGz) : item.mHexHash;
+    auto object = HistoryArchiveManager::getCacheObjectName(hexHash);
+    if (!fs::exists(cache.localFilePath(object)))
+    {
+        cache.mkdirJob(parentDir(object))();
+        cache.putFileJob(item.mGz, object)();
+    }
+
+    // The index is written last, so that it never refers to a missing object
+    if (!item.mIndexName.empty())
+    {
+        auto local = item.mNoGz + ".sha256";
+        {
+            std::ofstream out(local, std::ofstream::trunc);
+            out << hexHash;
+            if (!out)
+            {
+                throw std::runtime_error("failed to write " + local);
+            }
+        }
+        cache.mkdirJob(parentDir(item.mIndexName))();
+        cache.putFileJob(local, item.mIndexName)();
+        std::remove(local.c_str());
+    }
+}
+}
+
+AddToHistoryCacheWork::AddToHistoryCacheWork(
+    Application& app, std::string const& name,
+    std::vector<FileTransferInfo> files)
+    : RunBackgroundWork(app, name, BasicWork::RETRY_NEVER)
+    , mFiles(std::move(files))
+{
+}
+
+std::function<void()>
+AddToHistoryCacheWork::getJob()
+{
+    auto const& ham = mApp.getHistoryArchiveManager();
+    auto cache = ham.getCacheArchive();
+    if (!cache)
+    {
+        return []() {};
+    }
+
+    std::vector<CacheItem> items;
+    for (auto const& ft : mFiles)
+    {
+        CacheItem item{ft.localPath_gz(), ft.localPath_nogz(), "", ""};
+        if (ft.getType() == HISTORY_FILE_TYPE_BUCKET)
+        {
+            item.mHexHash = ft.getHexDigits();
+        }
+        else
+        {
+            item.mIndexName = ham.getCacheIndexName(ft);
+        }
+        items.emplace_back(std::move(item));
+    }
+
+    return [cache, items]() {
+        for (auto const& item : items)
+        {
+            if (!fs::exists(item.mGz))
+            {
+                // Not downloaded, or already taken from the cache
+                continue;
+            }
+            try
+            {
+                addToCache(*cache, item);
+            }
+            catch (std::exception const& e)
+            {
+                CLOG(DEBUG, "History")
+                    << "Failed to cache " << item.mGz << ": " << e.what();
+            }
+            std::remove(item.mGz.c_str());
+        }
+    };
+}
+}
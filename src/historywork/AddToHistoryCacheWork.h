@@ -0,0 +1,33 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include "history/FileTransferInfo.h"
+#include "historywork/RunBackgroundWork.h"
+
+namespace stellar
+{
+
+/**
+ * Adds downloaded files to HISTORY_CACHE_DIR (see
+ * HistoryArchiveManager::getCacheArchive), then removes their .gz. Files must
+ * only be added once their content is verified: buckets against their hash,
+ * other files by the work that checks them against the ledger chain. Both the
+ * .gz and the decompressed file must still be in the download directory.
+ *
+ * Caching is best effort: this never fails, and files that can't be added are
+ * only downloaded again next time. It does nothing when there is no cache.
+ */
+class AddToHistoryCacheWork : public RunBackgroundWork
+{
+    std::vector<FileTransferInfo> const mFiles;
+    std::function<void()> getJob() override;
+
+  public:
+    AddToHistoryCacheWork(Application& app, std::string const& name,
+                          std::vector<FileTransferInfo> files);
+    ~AddToHistoryCacheWork() = default;
+};
+}
@@ -67,9 +67,13 @@ DownloadBucketsWork::yieldMoreWork()
 
     auto hash = *mNextBucketIter;
     FileTransferInfo ft(mDownloadDir, HISTORY_FILE_TYPE_BUCKET, hash);
-    auto w1 = std::make_shared<GetAndUnzipRemoteFileWork>(mApp, ft, mArchive);
+    // The bucket is hashed while it is decompressed, so that verifying it
+    // does not need to read the (possibly multi-GB) file back from disk.
+    auto computedHash = std::make_shared<uint256>();
+    auto w1 = std::make_shared<GetAndUnzipRemoteFileWork>(mApp, ft, mArchive,
+                                                          computedHash);
     auto w2 = std::make_shared<VerifyBucketWork>(
-        mApp, mBuckets, ft.localPath_nogz(), hexToBin256(hash));
+        mApp, mBuckets, ft.localPath_nogz(), hexToBin256(hash), computedHash);
     std::vector<std::shared_ptr<BasicWork>> seq{w1, w2};
     auto w3 = std::make_shared<WorkSequence>(
         mApp, "download-verify-sequence-" + hash, seq);
@@ -5,10 +5,13 @@
 #include "historywork/DownloadVerifyTxResultsWork.h"
 #include "history/FileTransferInfo.h"
 #include "history/HistoryArchive.h"
+#include "history/HistoryArchiveManager.h"
 #include "history/HistoryManager.h"
+#include "historywork/AddToHistoryCacheWork.h"
 #include "historywork/GetAndUnzipRemoteFileWork.h"
 #include "historywork/Progress.h"
 #include "historywork/VerifyTxResultsWork.h"
+#include "main/Application.h"
 #include "util/format.h"
 #include "work/WorkSequence.h"
 
@@ -65,6 +68,12 @@ DownloadVerifyTxResultsWork::yieldMoreWork()
     auto w2 = std::make_shared<VerifyTxResultsWork>(mApp, mDownloadDir,
                                                     mCurrCheckpoint);
     std::vector<std::shared_ptr<BasicWork>> seq{w1, w2};
+    if (mApp.getHistoryArchiveManager().getCacheArchive())
+    {
+        seq.push_back(std::make_shared<AddToHistoryCacheWork>(
+            mApp, "add-to-cache-" + w2->getName(),
+            std::vector<FileTransferInfo>{ft}));
+    }
     auto w3 = std::make_shared<WorkSequence>(
         mApp, "download-verify-results-" + std::to_string(mCurrCheckpoint),
         seq);
@@ -3,34 +3,53 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "historywork/GetAndUnzipRemoteFileWork.h"
+#include "crypto/Hex.h"
 #include "history/FileTransferInfo.h"
+#include "history/HistoryArchive.h"
+#include "history/HistoryArchiveManager.h"
+#include "historywork/AddToHistoryCacheWork.h"
 #include "historywork/GetRemoteFileWork.h"
 #include "historywork/GunzipFileWork.h"
+#include "main/Application.h"
+#include "util/Fs.h"
 #include "util/Logging.h"
 
+#include <fstream>
+
 namespace stellar
 {
 
 GetAndUnzipRemoteFileWork::GetAndUnzipRemoteFileWork(
     Application& app, FileTransferInfo ft,
-    std::shared_ptr<HistoryArchive> archive)
+    std::shared_ptr<HistoryArchive> archive,
+    std::shared_ptr<uint256> contentHash)
     : Work(app, std::string("get-and-unzip-remote-file ") + ft.remoteName(),
            BasicWork::RETRY_A_LOT)
     , mFt(std::move(ft))
     , mArchive(archive)
+    , mCache(app.getHistoryArchiveManager().getCacheArchive())
+    , mContentHash(contentHash || !mCache ? contentHash
+                                          : std::make_shared<uint256>())
     , mDownloadStart(app.getMetrics().NewMeter(
           {"history", "download-" + mFt.getType(), "start"}, "event"))
     , mDownloadSuccess(app.getMetrics().NewMeter(
           {"history", "download-" + mFt.getType(), "success"}, "event"))
     , mDownloadFailure(app.getMetrics().NewMeter(
           {"history", "download-" + mFt.getType(), "failure"}, "event"))
+    , mCacheHit(app.getMetrics().NewMeter({"history", "cache", "hit"}, "event"))
+    , mCacheMiss(
+          app.getMetrics().NewMeter({"history", "cache", "miss"}, "event"))
 {
 }
 
 std::string
 GetAndUnzipRemoteFileWork::getStatus() const
 {
-    if (mGunzipFileWork)
+    if (mAddToCacheWork)
+    {
+        return mAddToCacheWork->getStatus();
+    }
+    else if (mGunzipFileWork)
     {
         return mGunzipFileWork->getStatus();
     }
@@ -49,6 +68,9 @@ GetAndUnzipRemoteFileWork::doReset()
     std::remove(mFt.localPath_gz_tmp().c_str());
     mGetRemoteFileWork.reset();
     mGunzipFileWork.reset();
+    mAddToCacheWork.reset();
+    mFromCache = false;
+    mCachedHash.clear();
 }
 
 void
@@ -69,7 +91,11 @@ GetAndUnzipRemoteFileWork::onSuccess()
 BasicWork::State
 GetAndUnzipRemoteFileWork::doWork()
 {
-    if (mGunzipFileWork)
+    if (mAddToCacheWork)
+    {
+        return mAddToCacheWork->getState();
+    }
+    else if (mGunzipFileWork)
     {
         // Download completed, unzipping started
         assert(mGetRemoteFileWork);
@@ -81,6 +107,25 @@ GetAndUnzipRemoteFileWork::doWork()
                                    << mFt.remoteName() << ": .xdr not found";
             return State::WORK_FAILURE;
         }
+        if (mFromCache &&
+            (state == State::WORK_FAILURE ||
+             (state == State::WORK_SUCCESS &&
+              binToHex(*mContentHash) != mCachedHash)))
+        {
+            // Evict it, so that the next attempt downloads the file again
+            CLOG(WARNING, "History")
+                << "Removing corrupt " << mFt.remoteName() << " from cache";
+            evictFromCache();
+            return State::WORK_FAILURE;
+        }
+        if (state == State::WORK_SUCCESS && mCache && !mFromCache &&
+            isVerifiedBucket())
+        {
+            mAddToCacheWork = addWork<AddToHistoryCacheWork>(
+                "add-to-cache " + mFt.remoteName(),
+                std::vector<FileTransferInfo>{mFt});
+            return State::WORK_RUNNING;
+        }
         return state;
     }
     else if (mGetRemoteFileWork)
@@ -93,24 +138,93 @@ GetAndUnzipRemoteFileWork::doWork()
             {
                 return State::WORK_FAILURE;
             }
-            mGunzipFileWork = addWork<GunzipFileWork>(mFt.localPath_gz(), false,
-                                                      BasicWork::RETRY_NEVER);
+            // Keep the .gz of downloaded files until they can be added to the
+            // cache (see AddToHistoryCacheWork)
+            bool keepGz = mCache && !mFromCache;
+            mGunzipFileWork = addWork<GunzipFileWork>(
+                mFt.localPath_gz(), keepGz, BasicWork::RETRY_NEVER,
+                mContentHash);
             return State::WORK_RUNNING;
         }
         return state;
     }
     else
     {
+        if (mCache)
+        {
+            mCachedHash = findInCache();
+            mFromCache = !mCachedHash.empty();
+            (mFromCache ? mCacheHit : mCacheMiss).Mark();
+        }
+        auto archive = mArchive;
+        auto remoteName = mFt.remoteName();
+        if (mFromCache)
+        {
+            archive = mCache;
+            remoteName = HistoryArchiveManager::getCacheObjectName(mCachedHash);
+        }
+        else if (!archive && mAttempts == 0)
+        {
+            auto& ham = mApp.getHistoryArchiveManager();
+            archive = ham.selectStripedReadableHistoryArchive(mFt.remoteName());
+        }
+        ++mAttempts;
+
         CLOG(DEBUG, "History")
-            << "Downloading and unzipping " << mFt.remoteName();
+            << "Downloading and unzipping " << mFt.remoteName()
+            << (mFromCache ? " from cache" : "");
         mGetRemoteFileWork =
-            addWork<GetRemoteFileWork>(mFt.remoteName(), mFt.localPath_gz_tmp(),
-                                       mArchive, BasicWork::RETRY_NEVER);
+            addWork<GetRemoteFileWork>(remoteName, mFt.localPath_gz_tmp(),
+                                       archive, BasicWork::RETRY_NEVER);
         mDownloadStart.Mark();
         return State::WORK_RUNNING;
     }
 }
 
+std::string
+GetAndUnzipRemoteFileWork::findInCache() const
+{
+    auto& ham = mApp.getHistoryArchiveManager();
+    std::string hexHash;
+    if (mFt.getType() == HISTORY_FILE_TYPE_BUCKET)
+    {
+        hexHash = mFt.getHexDigits();
+    }
+    else
+    {
+        // Index files are tiny, reading one here is cheaper than going
+        // through a background job
+        std::ifstream in(mCache->localFilePath(ham.getCacheIndexName(mFt)));
+        in >> hexHash;
+        if (!in || hexHash.size() != 2 * sizeof(uint256))
+        {
+            return "";
+        }
+    }
+    auto object = HistoryArchiveManager::getCacheObjectName(hexHash);
+    return fs::exists(mCache->localFilePath(object)) ? hexHash : "";
+}
+
+void
+GetAndUnzipRemoteFileWork::evictFromCache() const
+{
+    auto& ham = mApp.getHistoryArchiveManager();
+    auto object = HistoryArchiveManager::getCacheObjectName(mCachedHash);
+    std::remove(mCache->localFilePath(object).c_str());
+    if (mFt.getType() != HISTORY_FILE_TYPE_BUCKET)
+    {
+        std::remove(mCache->localFilePath(ham.getCacheIndexName(mFt)).c_str());
+    }
+}
+
+bool
+GetAndUnzipRemoteFileWork::isVerifiedBucket() const
+{
+    // Other files are added to the cache by the works verifying them
+    return mFt.getType() == HISTORY_FILE_TYPE_BUCKET &&
+           binToHex(*mContentHash) == mFt.getHexDigits();
+}
+
 bool
 GetAndUnzipRemoteFileWork::validateFile()
 {
@@ -6,6 +6,7 @@
 
 #include "history/FileTransferInfo.h"
 #include "work/Work.h"
+#include "xdr/Stellar-types.h"
 #include <medida/meter.h>
 #include <medida/metrics_registry.h>
 
@@ -18,23 +19,48 @@ class GetAndUnzipRemoteFileWork : public Work
 {
     std::shared_ptr<BasicWork> mGetRemoteFileWork;
     std::shared_ptr<BasicWork> mGunzipFileWork;
+    std::shared_ptr<BasicWork> mAddToCacheWork;
 
     FileTransferInfo mFt;
     std::shared_ptr<HistoryArchive> mArchive;
+    std::shared_ptr<HistoryArchive> mCache;
+    // Always set when there is a cache, to check or add cached files
+    std::shared_ptr<uint256> mContentHash;
+    bool mFromCache{false};
+    // Hash the content of the file taken from the cache must have
+    std::string mCachedHash;
+    size_t mAttempts{0};
 
     medida::Meter& mDownloadStart;
     medida::Meter& mDownloadSuccess;
     medida::Meter& mDownloadFailure;
+    medida::Meter& mCacheHit;
+    medida::Meter& mCacheMiss;
 
     bool validateFile();
+    // Returns the hex hash of the file's content if it's in the cache
+    std::string findInCache() const;
+    void evictFromCache() const;
+    bool isVerifiedBucket() const;
 
   public:
     // Passing `nullptr` for the archive argument will cause the work to
-    // select a new readable history archive at random each time it runs /
-    // retries.
+    // select a readable history archive by the file's name when it first
+    // runs, spreading files across archives, and a new one at random each
+    // time it retries.
+    //
+    // Files are fetched from HISTORY_CACHE_DIR rather than from the archive
+    // when they are there, and evicted from it if their content doesn't
+    // match their hash. Downloaded buckets are added to it once their hash is
+    // checked. Other files are kept gzipped in the download directory, to be
+    // added by an AddToHistoryCacheWork once verified.
+    //
+    // If `contentHash` is not null, the decompressed file is hashed while it
+    // is written and `contentHash` receives the result on success.
     GetAndUnzipRemoteFileWork(
         Application& app, FileTransferInfo ft,
-        std::shared_ptr<HistoryArchive> archive = nullptr);
+        std::shared_ptr<HistoryArchive> archive = nullptr,
+        std::shared_ptr<uint256> contentHash = nullptr);
     ~GetAndUnzipRemoteFileWork() = default;
     std::string getStatus() const override;
 
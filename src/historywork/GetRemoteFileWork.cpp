@@ -15,49 +15,44 @@ GetRemoteFileWork::GetRemoteFileWork(Application& app,
                                      std::string const& local,
                                      std::shared_ptr<HistoryArchive> archive,
                                      size_t maxRetries)
-    : RunCommandWork(app, std::string("get-remote-file ") + remote, maxRetries)
+    : RemoteArchiveWork(app, std::string("get-remote-file ") + remote,
+                        maxRetries)
     , mRemote(remote)
     , mLocal(local)
     , mArchive(archive)
 {
 }
 
-CommandInfo
-GetRemoteFileWork::getCommand()
+std::shared_ptr<HistoryArchive>
+GetRemoteFileWork::selectArchive()
 {
-    mCurrentArchive = mArchive;
-    if (!mCurrentArchive)
+    auto archive = mArchive;
+    if (!archive)
     {
-        mCurrentArchive = mApp.getHistoryArchiveManager()
-                              .selectRandomReadableHistoryArchive();
+        archive = mApp.getHistoryArchiveManager()
+                      .selectRandomReadableHistoryArchive();
     }
-    assert(mCurrentArchive);
-    assert(mCurrentArchive->hasGetCmd());
-    auto cmdLine = mCurrentArchive->getFileCmd(mRemote, mLocal);
-
-    return CommandInfo{cmdLine, std::string()};
+    assert(archive);
+    assert(archive->hasGetCmd());
+    return archive;
 }
 
-void
-GetRemoteFileWork::onReset()
+std::function<void()>
+GetRemoteFileWork::getJob(HistoryArchive const& archive)
 {
-    std::remove(mLocal.c_str());
-    RunCommandWork::onReset();
+    return archive.getFileJob(mRemote, mLocal);
 }
 
-void
-GetRemoteFileWork::onSuccess()
+std::string
+GetRemoteFileWork::getCommand(HistoryArchive const& archive)
 {
-    assert(mCurrentArchive);
-    mCurrentArchive->markSuccess();
-    RunCommandWork::onSuccess();
+    return archive.getFileCmd(mRemote, mLocal);
 }
 
 void
-GetRemoteFileWork::onFailureRaise()
+GetRemoteFileWork::doReset()
 {
-    assert(mCurrentArchive);
-    mCurrentArchive->markFailure();
-    RunCommandWork::onFailureRaise();
+    std::remove(mLocal.c_str());
+    RemoteArchiveWork::doReset();
 }
 }
@@ -4,20 +4,21 @@
 
 #pragma once
 
-#include "historywork/RunCommandWork.h"
+#include "historywork/RemoteArchiveWork.h"
 
 namespace stellar
 {
 
 class HistoryArchive;
 
-class GetRemoteFileWork : public RunCommandWork
+class GetRemoteFileWork : public RemoteArchiveWork
 {
     std::string const mRemote;
     std::string const mLocal;
     std::shared_ptr<HistoryArchive> mArchive;
-    std::shared_ptr<HistoryArchive> mCurrentArchive;
-    CommandInfo getCommand() override;
+    std::shared_ptr<HistoryArchive> selectArchive() override;
+    std::function<void()> getJob(HistoryArchive const& archive) override;
+    std::string getCommand(HistoryArchive const& archive) override;
 
   public:
     // Passing `nullptr` for the archive argument will cause the work to
@@ -30,8 +31,6 @@ class GetRemoteFileWork : public RunCommandWork
     ~GetRemoteFileWork() = default;
 
   protected:
-    void onReset() override;
-    void onSuccess() override;
-    void onFailureRaise() override;
+    void doReset() override;
 };
 }
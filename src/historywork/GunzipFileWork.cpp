@@ -3,37 +3,52 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "historywork/GunzipFileWork.h"
+#include "crypto/SHA.h"
 #include "util/Fs.h"
+#include "util/Gzip.h"
 
 namespace stellar
 {
 
 GunzipFileWork::GunzipFileWork(Application& app, std::string const& filenameGz,
-                               bool keepExisting, size_t maxRetries)
-    : RunCommandWork(app, std::string("gunzip-file ") + filenameGz, maxRetries)
+                               bool keepExisting, size_t maxRetries,
+                               std::shared_ptr<uint256> contentHash)
+    : RunBackgroundWork(app, std::string("gunzip-file ") + filenameGz,
+                        maxRetries)
     , mFilenameGz(filenameGz)
     , mKeepExisting(keepExisting)
+    , mContentHash(contentHash)
 {
     fs::checkGzipSuffix(mFilenameGz);
 }
 
-CommandInfo
-GunzipFileWork::getCommand()
+std::function<void()>
+GunzipFileWork::getJob()
 {
-    std::string cmdLine, outFile;
-    cmdLine = "gzip -d ";
-    if (mKeepExisting)
-    {
-        cmdLine += "-c ";
-        outFile = mFilenameGz.substr(0, mFilenameGz.size() - 3);
-    }
-    cmdLine += mFilenameGz;
-    return CommandInfo{cmdLine, outFile};
+    return [filenameGz = mFilenameGz, keepExisting = mKeepExisting,
+            contentHash = mContentHash]() {
+        std::string filenameNoGz = filenameGz.substr(0, filenameGz.size() - 3);
+        if (contentHash)
+        {
+            auto hasher = SHA256::create();
+            gzip::decompressFile(filenameGz, filenameNoGz, hasher.get());
+            *contentHash = hasher->finish();
+        }
+        else
+        {
+            gzip::decompressFile(filenameGz, filenameNoGz);
+        }
+        if (!keepExisting)
+        {
+            std::remove(filenameGz.c_str());
+        }
+    };
 }
 
 void
 GunzipFileWork::onReset()
 {
+    RunBackgroundWork::onReset();
     std::string filenameNoGz = mFilenameGz.substr(0, mFilenameGz.size() - 3);
     std::remove(filenameNoGz.c_str());
 }
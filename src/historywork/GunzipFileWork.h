@@ -4,21 +4,26 @@
 
 #pragma once
 
-#include "historywork/RunCommandWork.h"
+#include "historywork/RunBackgroundWork.h"
+#include "xdr/Stellar-types.h"
 
 namespace stellar
 {
 
-class GunzipFileWork : public RunCommandWork
+class GunzipFileWork : public RunBackgroundWork
 {
     std::string const mFilenameGz;
     bool const mKeepExisting;
-    CommandInfo getCommand() override;
+    std::shared_ptr<uint256> const mContentHash;
+    std::function<void()> getJob() override;
 
   public:
+    // If `contentHash` is not null, it receives the SHA256 of the
+    // decompressed content once the work succeeds.
     GunzipFileWork(Application& app, std::string const& filenameGz,
                    bool keepExisting = false,
-                   size_t maxRetries = Work::RETRY_NEVER);
+                   size_t maxRetries = Work::RETRY_NEVER,
+                   std::shared_ptr<uint256> contentHash = nullptr);
     ~GunzipFileWork() = default;
 
   protected:
@@ -4,14 +4,15 @@
 
 #include "historywork/GzipFileWork.h"
 #include "util/Fs.h"
+#include "util/Gzip.h"
 
 namespace stellar
 {
 
 GzipFileWork::GzipFileWork(Application& app, std::string const& filenameNoGz,
                            bool keepExisting)
-    : RunCommandWork(app, std::string("gzip-file ") + filenameNoGz,
-                     BasicWork::RETRY_A_LOT)
+    : RunBackgroundWork(app, std::string("gzip-file ") + filenameNoGz,
+                        BasicWork::RETRY_A_LOT)
     , mFilenameNoGz(filenameNoGz)
     , mKeepExisting(keepExisting)
 {
@@ -21,22 +22,20 @@ GzipFileWork::GzipFileWork(Application& app, std::string const& filenameNoGz,
 void
 GzipFileWork::onReset()
 {
+    RunBackgroundWork::onReset();
     std::string filenameGz = mFilenameNoGz + ".gz";
     std::remove(filenameGz.c_str());
 }
 
-CommandInfo
-GzipFileWork::getCommand()
+std::function<void()>
+GzipFileWork::getJob()
 {
-    std::string cmdLine = "gzip ";
-    std::string outFile;
-    if (mKeepExisting)
-    {
-        cmdLine += "-c ";
-        outFile = mFilenameNoGz + ".gz";
-    }
-    cmdLine += mFilenameNoGz;
-
-    return CommandInfo{cmdLine, outFile};
+    return [filenameNoGz = mFilenameNoGz, keepExisting = mKeepExisting]() {
+        gzip::compressFile(filenameNoGz, filenameNoGz + ".gz");
+        if (!keepExisting)
+        {
+            std::remove(filenameNoGz.c_str());
+        }
+    };
 }
 }
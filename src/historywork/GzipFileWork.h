@@ -4,16 +4,16 @@
 
 #pragma once
 
-#include "historywork/RunCommandWork.h"
+#include "historywork/RunBackgroundWork.h"
 
 namespace stellar
 {
 
-class GzipFileWork : public RunCommandWork
+class GzipFileWork : public RunBackgroundWork
 {
     std::string const mFilenameNoGz;
     bool const mKeepExisting;
-    CommandInfo getCommand() override;
+    std::function<void()> getJob() override;
 
   public:
     GzipFileWork(Application& app, std::string const& filenameNoGz,
@@ -11,35 +11,34 @@ namespace stellar
 
 MakeRemoteDirWork::MakeRemoteDirWork(Application& app, std::string const& dir,
                                      std::shared_ptr<HistoryArchive> archive)
-    : RunCommandWork(app, std::string("make-remote-dir ") + dir,
-                     BasicWork::RETRY_A_LOT)
+    : RemoteArchiveWork(app, std::string("make-remote-dir ") + dir,
+                        BasicWork::RETRY_A_LOT)
     , mDir(dir)
     , mArchive(archive)
 {
     assert(mArchive);
 }
 
-CommandInfo
-MakeRemoteDirWork::getCommand()
+std::shared_ptr<HistoryArchive>
+MakeRemoteDirWork::selectArchive()
 {
-    std::string cmdLine;
-    if (mArchive->hasMkdirCmd())
-    {
-        cmdLine = mArchive->mkdirCmd(mDir);
-    }
-    return CommandInfo{cmdLine, std::string()};
+    return mArchive;
 }
 
-void
-MakeRemoteDirWork::onSuccess()
+std::function<void()>
+MakeRemoteDirWork::getJob(HistoryArchive const& archive)
 {
-    mArchive->markSuccess();
+    return archive.mkdirJob(mDir);
 }
 
-void
-MakeRemoteDirWork::onFailureRaise()
+std::string
+MakeRemoteDirWork::getCommand(HistoryArchive const& archive)
 {
-    mArchive->markFailure();
-    RunCommandWork::onFailureRaise();
+    std::string cmdLine;
+    if (archive.hasMkdirCmd())
+    {
+        cmdLine = archive.mkdirCmd(mDir);
+    }
+    return cmdLine;
 }
 }
@@ -4,25 +4,24 @@
 
 #pragma once
 
-#include "historywork/RunCommandWork.h"
+#include "historywork/RemoteArchiveWork.h"
 
 namespace stellar
 {
 
 class HistoryArchive;
 
-class MakeRemoteDirWork : public RunCommandWork
+class MakeRemoteDirWork : public RemoteArchiveWork
 {
     std::string const mDir;
     std::shared_ptr<HistoryArchive> mArchive;
-    CommandInfo getCommand() override;
+    std::shared_ptr<HistoryArchive> selectArchive() override;
+    std::function<void()> getJob(HistoryArchive const& archive) override;
+    std::string getCommand(HistoryArchive const& archive) override;
 
   public:
     MakeRemoteDirWork(Application& app, std::string const& dir,
                       std::shared_ptr<HistoryArchive> archive);
     ~MakeRemoteDirWork() = default;
-
-    void onSuccess() override;
-    void onFailureRaise() override;
 };
 }
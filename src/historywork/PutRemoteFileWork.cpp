@@ -11,8 +11,8 @@ namespace stellar
 PutRemoteFileWork::PutRemoteFileWork(Application& app, std::string const& local,
                                      std::string const& remote,
                                      std::shared_ptr<HistoryArchive> archive)
-    : RunCommandWork(app, std::string("put-remote-file ") + remote,
-                     BasicWork::RETRY_A_LOT)
+    : RemoteArchiveWork(app, std::string("put-remote-file ") + remote,
+                        BasicWork::RETRY_A_LOT)
     , mLocal(local)
     , mRemote(remote)
     , mArchive(archive)
@@ -21,24 +21,21 @@ PutRemoteFileWork::PutRemoteFileWork(Application& app, std::string const& local,
     assert(mArchive->hasPutCmd());
 }
 
-CommandInfo
-PutRemoteFileWork::getCommand()
+std::shared_ptr<HistoryArchive>
+PutRemoteFileWork::selectArchive()
 {
-    auto cmdLine = mArchive->putFileCmd(mLocal, mRemote);
-    return CommandInfo{cmdLine, std::string()};
+    return mArchive;
 }
 
-void
-PutRemoteFileWork::onSuccess()
+std::function<void()>
+PutRemoteFileWork::getJob(HistoryArchive const& archive)
 {
-    mArchive->markSuccess();
-    RunCommandWork::onSuccess();
+    return archive.putFileJob(mLocal, mRemote);
 }
 
-void
-PutRemoteFileWork::onFailureRaise()
+std::string
+PutRemoteFileWork::getCommand(HistoryArchive const& archive)
 {
-    mArchive->markFailure();
-    RunCommandWork::onFailureRaise();
+    return archive.putFileCmd(mLocal, mRemote);
 }
 }
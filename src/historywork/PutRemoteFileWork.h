@@ -4,28 +4,26 @@
 
 #pragma once
 
-#include "historywork/RunCommandWork.h"
+#include "historywork/RemoteArchiveWork.h"
 
 namespace stellar
 {
 
 class HistoryArchive;
 
-class PutRemoteFileWork : public RunCommandWork
+class PutRemoteFileWork : public RemoteArchiveWork
 {
     std::string const mLocal;
     std::string const mRemote;
     std::shared_ptr<HistoryArchive> mArchive;
-    CommandInfo getCommand() override;
+    std::shared_ptr<HistoryArchive> selectArchive() override;
+    std::function<void()> getJob(HistoryArchive const& archive) override;
+    std::string getCommand(HistoryArchive const& archive) override;
 
   public:
     PutRemoteFileWork(Application& app, std::string const& local,
                       std::string const& remote,
                       std::shared_ptr<HistoryArchive> archive);
     ~PutRemoteFileWork() = default;
-
-  protected:
-    void onSuccess() override;
-    void onFailureRaise() override;
 };
 }
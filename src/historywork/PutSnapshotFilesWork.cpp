@@ -11,6 +11,7 @@
 #include "historywork/PutFilesWork.h"
 #include "historywork/PutHistoryArchiveStateWork.h"
 #include "main/Application.h"
+#include "util/Fs.h"
 #include "work/WorkSequence.h"
 #include <util/format.h>
 
@@ -36,7 +37,7 @@ PutSnapshotFilesWork::doWork()
         return WorkUtils::getWorkStatus(mUploadSeqs);
     }
 
-    if (!mGzipFilesWorks.empty())
+    if (mZipping)
     {
         if (WorkUtils::getWorkStatus(mGzipFilesWorks) == State::WORK_SUCCESS)
         {
@@ -75,6 +76,7 @@ PutSnapshotFilesWork::doWork()
             {
                 mGzipFilesWorks.emplace_back(addWork<GzipFileWork>(f, true));
             }
+            mZipping = true;
             return State::WORK_RUNNING;
         }
         else
@@ -99,6 +101,7 @@ PutSnapshotFilesWork::doReset()
 {
     mGetStateWorks.clear();
     mGzipFilesWorks.clear();
+    mZipping = false;
     mUploadSeqs.clear();
 }
 
@@ -118,7 +121,11 @@ PutSnapshotFilesWork::getFilesToZip()
         for (auto const& f :
              mSnapshot->differingHASFiles(getState->getHistoryArchiveState()))
         {
-            filesToZip.insert(f->localPath_nogz());
+            // Files written compressed in the first place are left alone
+            if (fs::exists(f->localPath_nogz()))
+            {
+                filesToZip.insert(f->localPath_nogz());
+            }
         }
     }
 
@@ -133,7 +140,7 @@ PutSnapshotFilesWork::getStatus() const
         return fmt::format("{}:uploading files", getName());
     }
 
-    if (!mGzipFilesWorks.empty())
+    if (mZipping)
     {
         return fmt::format("{}:zipping files", getName());
     }
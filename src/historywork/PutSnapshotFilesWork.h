@@ -21,6 +21,7 @@ class PutSnapshotFilesWork : public Work
     // Keep track of each step
     std::list<std::shared_ptr<GetHistoryArchiveStateWork>> mGetStateWorks;
     std::list<std::shared_ptr<BasicWork>> mGzipFilesWorks;
+    bool mZipping{false};
     std::list<std::shared_ptr<BasicWork>> mUploadSeqs;
 
     std::unordered_set<std::string> getFilesToZip();
@@ -0,0 +1,97 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "historywork/RemoteArchiveWork.h"
+#include "history/HistoryArchive.h"
+#include "historywork/RunCommandWork.h"
+#include "historywork/RunJobWork.h"
+
+namespace stellar
+{
+
+namespace
+{
+class RunArchiveCommandWork : public RunCommandWork
+{
+    std::string const mCommand;
+
+    CommandInfo
+    getCommand() override
+    {
+        return CommandInfo{mCommand, std::string()};
+    }
+
+  public:
+    RunArchiveCommandWork(Application& app, std::string const& name,
+                          std::string command)
+        : RunCommandWork(app, name, BasicWork::RETRY_NEVER)
+        , mCommand(std::move(command))
+    {
+    }
+    ~RunArchiveCommandWork() = default;
+};
+}
+
+RemoteArchiveWork::RemoteArchiveWork(Application& app,
+                                     std::string const& name,
+                                     size_t maxRetries)
+    : Work(app, name, maxRetries)
+{
+}
+
+std::string
+RemoteArchiveWork::getStatus() const
+{
+    if (mRunWork)
+    {
+        return mRunWork->getStatus();
+    }
+    return BasicWork::getStatus();
+}
+
+BasicWork::State
+RemoteArchiveWork::doWork()
+{
+    if (mRunWork)
+    {
+        return mRunWork->getState();
+    }
+
+    mCurrentArchive = selectArchive();
+    assert(mCurrentArchive);
+    auto job = getJob(*mCurrentArchive);
+    if (job)
+    {
+        mRunWork = addWork<RunJobWork>("run-job " + getName(), job);
+    }
+    else
+    {
+        mRunWork = addWork<RunArchiveCommandWork>("run-command " + getName(),
+                                                  getCommand(*mCurrentArchive));
+    }
+    return State::WORK_RUNNING;
+}
+
+void
+RemoteArchiveWork::doReset()
+{
+    mRunWork.reset();
+}
+
+void
+RemoteArchiveWork::onSuccess()
+{
+    assert(mCurrentArchive);
+    mCurrentArchive->markSuccess();
+    Work::onSuccess();
+}
+
+void
+RemoteArchiveWork::onFailureRaise()
+{
+    assert(mCurrentArchive);
+    mCurrentArchive->markFailure();
+    Work::onFailureRaise();
+}
+}
@@ -0,0 +1,47 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include "work/Work.h"
+#include <functional>
+
+namespace stellar
+{
+
+class HistoryArchive;
+
+/**
+ * Runs one operation against a history archive. Each attempt selects the
+ * archive, then runs the archive's in-process job for the operation in a
+ * RunJobWork when it has one, or its command in a RunCommandWork otherwise.
+ * The archive is marked according to the outcome.
+ */
+class RemoteArchiveWork : public Work
+{
+    std::shared_ptr<HistoryArchive> mCurrentArchive;
+    std::shared_ptr<BasicWork> mRunWork;
+
+    // Returns the archive to use for this attempt
+    virtual std::shared_ptr<HistoryArchive> selectArchive() = 0;
+    // Returns the in-process job for the operation, or an empty function if
+    // the archive needs a command
+    virtual std::function<void()> getJob(HistoryArchive const& archive) = 0;
+    // Returns the command line for the operation; an empty one means there
+    // is nothing to do
+    virtual std::string getCommand(HistoryArchive const& archive) = 0;
+
+  public:
+    RemoteArchiveWork(Application& app, std::string const& name,
+                      size_t maxRetries = BasicWork::RETRY_A_LOT);
+    ~RemoteArchiveWork() = default;
+    std::string getStatus() const override;
+
+  protected:
+    State doWork() override;
+    void doReset() override;
+    void onSuccess() override;
+    void onFailureRaise() override;
+};
+}
@@ -0,0 +1,77 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "historywork/RunBackgroundWork.h"
+#include "main/Application.h"
+#include "util/Logging.h"
+
+namespace stellar
+{
+
+RunBackgroundWork::RunBackgroundWork(Application& app, std::string const& name,
+                                     size_t maxRetries)
+    : BasicWork(app, name, maxRetries)
+{
+}
+
+BasicWork::State
+RunBackgroundWork::onRun()
+{
+    if (mDone)
+    {
+        return mFailed ? State::WORK_FAILURE : State::WORK_SUCCESS;
+    }
+
+    auto job = getJob();
+    Application& app = mApp;
+    std::weak_ptr<RunBackgroundWork> weak(
+        std::static_pointer_cast<RunBackgroundWork>(shared_from_this()));
+    mJobRunning = true;
+    app.postOnBackgroundThread(
+        [&app, job, weak, name = getName()]() {
+            bool failed = false;
+            try
+            {
+                job();
+            }
+            catch (std::exception const& e)
+            {
+                CLOG(WARNING, "History") << name << " failed: " << e.what();
+                failed = true;
+            }
+
+            // BasicWork's state is not thread-safe, report back on the main
+            // thread
+            app.postOnMainThread(
+                [weak, failed]() {
+                    auto self = weak.lock();
+                    if (self)
+                    {
+                        self->mJobRunning = false;
+                        self->mFailed = failed;
+                        self->mDone = true;
+                        self->wakeUp();
+                    }
+                },
+                "RunBackgroundWork: finish");
+        },
+        "RunBackgroundWork: start in background");
+    return State::WORK_WAITING;
+}
+
+void
+RunBackgroundWork::onReset()
+{
+    mDone = false;
+    mFailed = false;
+}
+
+bool
+RunBackgroundWork::onAbort()
+{
+    // Wait for the job to finish so it doesn't write files after the work is
+    // reset or its caller moves on
+    return !mJobRunning;
+}
+}
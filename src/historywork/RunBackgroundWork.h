@@ -0,0 +1,38 @@
+#pragma once
+
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "work/Work.h"
+#include <functional>
+
+namespace stellar
+{
+
+/**
+ * Runs a job in-process on a background thread. The work is not scheduled
+ * while the job runs, and wakes up when it's done. Jobs can't be interrupted,
+ * so aborting the work waits for the running job to finish.
+ */
+class RunBackgroundWork : public BasicWork
+{
+    bool mDone{false};
+    bool mFailed{false};
+    bool mJobRunning{false};
+
+    // Returns the job to run on a background thread. The job must not refer
+    // to the work itself (copy whatever it needs), and fails by throwing.
+    virtual std::function<void()> getJob() = 0;
+
+  public:
+    RunBackgroundWork(Application& app, std::string const& name,
+                      size_t maxRetries = BasicWork::RETRY_A_FEW);
+    ~RunBackgroundWork() = default;
+
+  protected:
+    void onReset() override;
+    BasicWork::State onRun() override;
+    bool onAbort() override;
+};
+}
@@ -0,0 +1,22 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "historywork/RunJobWork.h"
+
+namespace stellar
+{
+
+RunJobWork::RunJobWork(Application& app, std::string const& name,
+                       std::function<void()> job, size_t maxRetries)
+    : RunBackgroundWork(app, name, maxRetries), mJob(std::move(job))
+{
+    assert(mJob);
+}
+
+std::function<void()>
+RunJobWork::getJob()
+{
+    return mJob;
+}
+}
@@ -0,0 +1,28 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include "historywork/RunBackgroundWork.h"
+
+namespace stellar
+{
+
+/**
+ * Runs a given job on a background thread, for archive operations that are
+ * done in-process rather than by spawning a command (see
+ * HistoryArchive::getFileJob).
+ */
+class RunJobWork : public RunBackgroundWork
+{
+    std::function<void()> const mJob;
+    std::function<void()> getJob() override;
+
+  public:
+    RunJobWork(Application& app, std::string const& name,
+               std::function<void()> job,
+               size_t maxRetries = BasicWork::RETRY_NEVER);
+    ~RunJobWork() = default;
+};
+}
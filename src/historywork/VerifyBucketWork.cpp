@@ -22,11 +22,13 @@ namespace stellar
 
 VerifyBucketWork::VerifyBucketWork(
     Application& app, std::map<std::string, std::shared_ptr<Bucket>>& buckets,
-    std::string const& bucketFile, uint256 const& hash)
+    std::string const& bucketFile, uint256 const& hash,
+    std::shared_ptr<uint256 const> computedHash)
     : BasicWork(app, "verify-bucket-hash-" + bucketFile, BasicWork::RETRY_NEVER)
     , mBuckets(buckets)
     , mBucketFile(bucketFile)
     , mHash(hash)
+    , mComputedHash(computedHash)
     , mVerifyBucketSuccess(app.getMetrics().NewMeter(
           {"history", "verify-bucket", "success"}, "event"))
     , mVerifyBucketFailure(app.getMetrics().NewMeter(
@@ -50,10 +52,37 @@ VerifyBucketWork::onRun()
         return State::WORK_SUCCESS;
     }
 
+    if (mComputedHash)
+    {
+        checkComputedHash();
+        return State::WORK_RUNNING;
+    }
+
     spawnVerifier();
     return State::WORK_WAITING;
 }
 
+void
+VerifyBucketWork::checkComputedHash()
+{
+    assert(mComputedHash);
+    if (*mComputedHash == mHash)
+    {
+        CLOG(DEBUG, "History") << "Verified hash (" << hexAbbrev(mHash)
+                               << ") for " << mBucketFile;
+    }
+    else
+    {
+        CLOG(WARNING, "History") << "FAILED verifying hash for " << mBucketFile;
+        CLOG(WARNING, "History") << "expected hash: " << binToHex(mHash);
+        CLOG(WARNING, "History")
+            << "computed hash: " << binToHex(*mComputedHash);
+        CLOG(WARNING, "History") << POSSIBLY_CORRUPTED_HISTORY;
+        mEc = std::make_error_code(std::errc::io_error);
+    }
+    mDone = true;
+}
+
 void
 VerifyBucketWork::adoptBucket()
 {
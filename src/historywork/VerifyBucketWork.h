@@ -22,19 +22,25 @@ class VerifyBucketWork : public BasicWork
     std::map<std::string, std::shared_ptr<Bucket>>& mBuckets;
     std::string mBucketFile;
     uint256 mHash;
+    std::shared_ptr<uint256 const> mComputedHash;
     bool mDone{false};
     std::error_code mEc;
 
     void adoptBucket();
     void spawnVerifier();
+    void checkComputedHash();
 
     medida::Meter& mVerifyBucketSuccess;
     medida::Meter& mVerifyBucketFailure;
 
   public:
+    // If `computedHash` is not null, it must hold the hash of `bucketFile`
+    // by the time the work runs (typically computed while the file was
+    // decompressed), and the file is not read again.
     VerifyBucketWork(Application& app,
                      std::map<std::string, std::shared_ptr<Bucket>>& buckets,
-                     std::string const& bucketFile, uint256 const& hash);
+                     std::string const& bucketFile, uint256 const& hash,
+                     std::shared_ptr<uint256 const> computedHash = nullptr);
     ~VerifyBucketWork() = default;
 
   protected:
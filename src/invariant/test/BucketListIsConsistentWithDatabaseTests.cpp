@@ -29,6 +29,17 @@ using namespace stellar;
 namespace BucketListIsConsistentWithDatabaseTests
 {
 
+Config
+getApplyConfig(bool checkInvariants)
+{
+    Config cfg = getTestConfig(1);
+    if (!checkInvariants)
+    {
+        cfg.INVARIANT_CHECKS = {};
+    }
+    return cfg;
+}
+
 struct BucketListGenerator
 {
     VirtualClock mClock;
@@ -39,9 +50,10 @@ struct BucketListGenerator
     std::unordered_set<LedgerKey> mLiveKeys;
 
   public:
-    BucketListGenerator()
+    BucketListGenerator(bool checkInvariants = true)
         : mAppGenerate(createTestApplication(mClock, getTestConfig(0)))
-        , mAppApply(createTestApplication(mApplyClock, getTestConfig(1)))
+        , mAppApply(createTestApplication(mApplyClock,
+                                          getApplyConfig(checkInvariants)))
         , mLedgerSeq(1)
     {
         auto skey = SecretKey::fromSeed(mAppGenerate->getNetworkID());
@@ -66,6 +78,28 @@ struct BucketListGenerator
                           std::forward<Args>(args)...);
     }
 
+    // Checks that the entries in the database of the apply application are
+    // exactly those in the database of the generating one.
+    void
+    checkAppliedDatabase()
+    {
+        auto& rootGenerate = mAppGenerate->getLedgerTxnRoot();
+        auto& rootApply = mAppApply->getLedgerTxnRoot();
+        for (auto let : {ACCOUNT, TRUSTLINE, OFFER, DATA})
+        {
+            REQUIRE(rootApply.countObjects(let) ==
+                    rootGenerate.countObjects(let));
+        }
+        for (auto const& key : mLiveKeys)
+        {
+            auto expected = rootGenerate.getNewestVersion(key);
+            auto applied = rootApply.getNewestVersion(key);
+            REQUIRE(expected);
+            REQUIRE(applied);
+            REQUIRE(*applied == *expected);
+        }
+    }
+
     void
     generateLedger()
     {
@@ -508,6 +542,20 @@ TEST_CASE("BucketListIsConsistentWithDatabase multiple applies",
     REQUIRE_NOTHROW(blg.applyBuckets());
 }
 
+TEST_CASE("BucketListIsConsistentWithDatabase newest first apply",
+          "[invariant][bucketlistconsistent]")
+{
+    // Without the invariant, all buckets are applied at once from newest to
+    // oldest, writing only the newest version of each entry
+    BucketListGenerator blg(false);
+    for (size_t j = 0; j < 3; ++j)
+    {
+        blg.generateLedgers(100);
+        REQUIRE_NOTHROW(blg.applyBuckets());
+        blg.checkAppliedDatabase();
+    }
+}
+
 TEST_CASE("BucketListIsConsistentWithDatabase test root account",
           "[invariant][bucketlistconsistent]")
 {
@@ -122,6 +122,12 @@ InMemoryLedgerTxnRoot::getPrefetchHitRate() const
     return 0.0;
 }
 
+std::map<LedgerEntryType, EntryCacheStats>
+InMemoryLedgerTxnRoot::getEntryCacheStats() const
+{
+    return {};
+}
+
 uint32_t
 InMemoryLedgerTxnRoot::prefetch(std::unordered_set<LedgerKey> const& keys)
 {
@@ -55,6 +55,8 @@ class InMemoryLedgerTxnRoot : public AbstractLedgerTxnParent
     void dropOffers() override;
     void dropTrustLines() override;
     double getPrefetchHitRate() const override;
+    std::map<LedgerEntryType, EntryCacheStats>
+    getEntryCacheStats() const override;
     uint32_t prefetch(std::unordered_set<LedgerKey> const& keys) override;
 };
 }
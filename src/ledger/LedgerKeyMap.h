@@ -0,0 +1,394 @@
+#pragma once
+
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "ledger/LedgerHashUtils.h"
+#include "xdr/Stellar-ledger-entries.h"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace stellar
+{
+
+// Hash map from LedgerKey to T using open addressing with linear probing.
+// The hash of every key is stored next to it in a flat array, which is probed
+// before comparing any key, so that lookups usually touch a single cache line
+// and no key is ever hashed twice. Unlike std::unordered_map, it allocates
+// nothing per entry and nothing at all until the first insertion, which suits
+// the many short-lived maps of nested LedgerTxn.
+//
+// It provides the subset of the std::unordered_map interface used with
+// LedgerKey, with the following differences:
+// - iterators only give const access to the entries, and mutable access to
+//   the mapped values through iterator::value(),
+// - inserting or erasing an entry invalidates all iterators, as entries are
+//   moved around within the array.
+// Erasing does not throw, as it only moves LedgerKey and T, neither of which
+// allocates when moved. Other modifications have the strong exception safety
+// guarantee.
+template <typename T> class LedgerKeyMap
+{
+  public:
+    typedef LedgerKey key_type;
+    typedef T mapped_type;
+    typedef std::pair<LedgerKey, T> value_type;
+
+    class iterator
+    {
+        friend class LedgerKeyMap;
+
+        LedgerKeyMap const* mMap;
+        size_t mIndex;
+
+        iterator(LedgerKeyMap const* map, size_t index)
+            : mMap(map), mIndex(index)
+        {
+        }
+
+        void
+        skipEmpty()
+        {
+            while (mIndex < mMap->capacity() && mMap->mHashes[mIndex] == EMPTY)
+            {
+                ++mIndex;
+            }
+        }
+
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef LedgerKeyMap::value_type const value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef value_type* pointer;
+        typedef value_type& reference;
+
+        iterator() : mMap(nullptr), mIndex(0)
+        {
+        }
+
+        reference operator*() const
+        {
+            return *mMap->slot(mIndex);
+        }
+
+        pointer operator->() const
+        {
+            return mMap->slot(mIndex);
+        }
+
+        T&
+        value() const
+        {
+            return mMap->slot(mIndex)->second;
+        }
+
+        iterator&
+        operator++()
+        {
+            ++mIndex;
+            skipEmpty();
+            return *this;
+        }
+
+        iterator
+        operator++(int)
+        {
+            auto res = *this;
+            ++*this;
+            return res;
+        }
+
+        bool
+        operator==(iterator const& other) const
+        {
+            return mIndex == other.mIndex;
+        }
+
+        bool
+        operator!=(iterator const& other) const
+        {
+            return mIndex != other.mIndex;
+        }
+    };
+    typedef iterator const_iterator;
+
+  private:
+    // Marks empty slots in mHashes, so hashes equal to it are replaced by 1
+    static size_t const EMPTY = 0;
+    static size_t const MIN_CAPACITY = 8;
+
+    typedef typename std::aligned_storage<sizeof(value_type),
+                                          alignof(value_type)>::type Storage;
+
+    std::unique_ptr<size_t[]> mHashes;
+    std::unique_ptr<Storage[]> mSlots;
+    // Capacity is 0 or a power of 2, in which case mMask is capacity - 1
+    size_t mMask{0};
+    size_t mSize{0};
+
+    static size_t
+    hashOf(LedgerKey const& key)
+    {
+        size_t hash = std::hash<LedgerKey>()(key);
+        return hash == EMPTY ? 1 : hash;
+    }
+
+    value_type*
+    slot(size_t i) const
+    {
+        return reinterpret_cast<value_type*>(&mSlots[i]);
+    }
+
+    size_t
+    capacity() const
+    {
+        return mHashes ? mMask + 1 : 0;
+    }
+
+    // Returns capacity() if key is not in the map
+    size_t
+    findIndex(LedgerKey const& key, size_t hash) const
+    {
+        if (mSize == 0)
+        {
+            return capacity();
+        }
+        for (size_t i = hash & mMask;; i = (i + 1) & mMask)
+        {
+            auto h = mHashes[i];
+            if (h == EMPTY)
+            {
+                return capacity();
+            }
+            if (h == hash && slot(i)->first == key)
+            {
+                return i;
+            }
+        }
+    }
+
+    // Requires that the map has room for one more entry
+    size_t
+    emptyIndex(size_t hash) const
+    {
+        size_t i = hash & mMask;
+        while (mHashes[i] != EMPTY)
+        {
+            i = (i + 1) & mMask;
+        }
+        return i;
+    }
+
+    void
+    rehash(size_t newCapacity)
+    {
+        std::unique_ptr<size_t[]> hashes(new size_t[newCapacity]());
+        std::unique_ptr<Storage[]> slots(new Storage[newCapacity]);
+        size_t const oldCapacity = capacity();
+
+        std::swap(mHashes, hashes);
+        std::swap(mSlots, slots);
+        mMask = newCapacity - 1;
+        for (size_t i = 0; i < oldCapacity; ++i)
+        {
+            if (hashes[i] != EMPTY)
+            {
+                auto old = reinterpret_cast<value_type*>(&slots[i]);
+                auto j = emptyIndex(hashes[i]);
+                new (slot(j)) value_type(std::move(*old));
+                mHashes[j] = hashes[i];
+                old->~value_type();
+            }
+        }
+    }
+
+    void
+    destroyAll()
+    {
+        for (size_t i = 0; i < capacity() && mSize > 0; ++i)
+        {
+            if (mHashes[i] != EMPTY)
+            {
+                slot(i)->~value_type();
+                mHashes[i] = EMPTY;
+                --mSize;
+            }
+        }
+    }
+
+    void
+    eraseIndex(size_t i)
+    {
+        slot(i)->~value_type();
+        mHashes[i] = EMPTY;
+        --mSize;
+
+        // Shift back the entries that follow in the same run, so that lookups
+        // never need tombstones
+        for (size_t j = (i + 1) & mMask; mHashes[j] != EMPTY;
+             j = (j + 1) & mMask)
+        {
+            size_t ideal = mHashes[j] & mMask;
+            if (((j - ideal) & mMask) >= ((j - i) & mMask))
+            {
+                new (slot(i)) value_type(std::move(*slot(j)));
+                mHashes[i] = mHashes[j];
+                slot(j)->~value_type();
+                mHashes[j] = EMPTY;
+                i = j;
+            }
+        }
+    }
+
+  public:
+    LedgerKeyMap() = default;
+
+    LedgerKeyMap(LedgerKeyMap const& other)
+    {
+        if (other.mSize > 0)
+        {
+            reserve(other.mSize);
+            for (auto const& kv : other)
+            {
+                emplace(kv.first, kv.second);
+            }
+        }
+    }
+
+    LedgerKeyMap(LedgerKeyMap&& other) noexcept
+    {
+        swap(other);
+    }
+
+    LedgerKeyMap&
+    operator=(LedgerKeyMap other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~LedgerKeyMap()
+    {
+        destroyAll();
+    }
+
+    void
+    swap(LedgerKeyMap& other) noexcept
+    {
+        std::swap(mHashes, other.mHashes);
+        std::swap(mSlots, other.mSlots);
+        std::swap(mMask, other.mMask);
+        std::swap(mSize, other.mSize);
+    }
+
+    iterator
+    begin() const
+    {
+        iterator res(this, 0);
+        res.skipEmpty();
+        return res;
+    }
+
+    iterator
+    end() const
+    {
+        return iterator(this, capacity());
+    }
+
+    size_t
+    size() const
+    {
+        return mSize;
+    }
+
+    bool
+    empty() const
+    {
+        return mSize == 0;
+    }
+
+    // Makes room for n entries without rehashing. The map is at most 3/4 full.
+    void
+    reserve(size_t n)
+    {
+        if (n * 4 > capacity() * 3)
+        {
+            size_t newCapacity = MIN_CAPACITY;
+            while (n * 4 > newCapacity * 3)
+            {
+                newCapacity *= 2;
+            }
+            rehash(newCapacity);
+        }
+    }
+
+    void
+    clear()
+    {
+        destroyAll();
+    }
+
+    iterator
+    find(LedgerKey const& key) const
+    {
+        return iterator(this, findIndex(key, hashOf(key)));
+    }
+
+    size_t
+    count(LedgerKey const& key) const
+    {
+        return findIndex(key, hashOf(key)) != capacity() ? 1 : 0;
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool>
+    emplace(LedgerKey const& key, Args&&... args)
+    {
+        size_t hash = hashOf(key);
+        size_t i = findIndex(key, hash);
+        if (i != capacity())
+        {
+            return {iterator(this, i), false};
+        }
+
+        reserve(mSize + 1);
+        i = emptyIndex(hash);
+        new (slot(i))
+            value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+        mHashes[i] = hash;
+        ++mSize;
+        return {iterator(this, i), true};
+    }
+
+    T& operator[](LedgerKey const& key)
+    {
+        return emplace(key).first.value();
+    }
+
+    void
+    erase(iterator const& iter)
+    {
+        eraseIndex(iter.mIndex);
+    }
+
+    size_t
+    erase(LedgerKey const& key)
+    {
+        size_t i = findIndex(key, hashOf(key));
+        if (i == capacity())
+        {
+            return 0;
+        }
+        eraseIndex(i);
+        return 1;
+    }
+};
+}
@@ -21,6 +21,7 @@
 #include "ledger/LedgerTxn.h"
 #include "ledger/LedgerTxnEntry.h"
 #include "ledger/LedgerTxnHeader.h"
+#include "ledger/LookaheadPrefetcher.h"
 #include "main/Application.h"
 #include "main/Config.h"
 #include "main/ErrorMessages.h"
@@ -41,7 +42,11 @@
 #include "xdrpp/printer.h"
 #include "xdrpp/types.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <numeric>
 #include <regex>
 #include <sstream>
@@ -111,6 +116,10 @@ LedgerManagerImpl::LedgerManagerImpl(Application& app)
     : mApp(app)
     , mTransactionApply(
           app.getMetrics().NewTimer({"ledger", "transaction", "apply"}))
+    , mTransactionPreverify(
+          app.getMetrics().NewTimer({"ledger", "transaction", "preverify"}))
+    , mTransactionPreverifiedByWorker(app.getMetrics().NewMeter(
+          {"ledger", "transaction", "preverified-by-worker"}, "transaction"))
     , mTransactionCount(
           app.getMetrics().NewHistogram({"ledger", "transaction", "count"}))
     , mOperationCount(
@@ -599,6 +608,8 @@ LedgerManagerImpl::closeLedger(LedgerCloseData const& ledgerData)
     // sorted such that sequence numbers are respected
     vector<TransactionFrameBasePtr> txs = ledgerData.getTxSet()->sortForApply();
 
+    preverifyTransactions(txs);
+
     // first, prefetch source accounts fot txset, then charge fees
     prefetchTxSourceIds(txs);
     processFeesSeqNums(txs, ltx, txSet->getBaseFee(header.current()),
@@ -878,6 +889,72 @@ LedgerManagerImpl::prefetchTransactionData(
     }
 }
 
+void
+LedgerManagerImpl::preverifyTransactions(
+    std::vector<TransactionFrameBasePtr> const& txs)
+{
+    size_t helpers = std::min<size_t>(mApp.getConfig().APPLY_VERIFY_THREADS,
+                                      txs.size());
+    if (helpers == 0)
+    {
+        return;
+    }
+
+    auto timer = mTransactionPreverify.TimeScope();
+
+    // Transactions are handed out through a counter, and the main thread
+    // verifies them too: it never waits for a worker that did not start yet
+    // (for example because all workers are merging buckets), only for the
+    // transactions that workers already picked.
+    struct Work
+    {
+        std::vector<TransactionFrameBasePtr> const mTxs;
+        std::atomic<size_t> mNext{0};
+        std::mutex mMutex;
+        std::condition_variable mDoneCV;
+        size_t mDone{0};
+        size_t mDoneByWorkers{0};
+
+        explicit Work(std::vector<TransactionFrameBasePtr> const& txs)
+            : mTxs(txs)
+        {
+        }
+
+        void
+        run(bool worker)
+        {
+            size_t done = 0;
+            for (size_t i = mNext++; i < mTxs.size(); i = mNext++)
+            {
+                // the results are cached by PubKeyUtils::verifySig
+                mTxs[i]->preverifySignatures();
+                ++done;
+            }
+            if (done > 0)
+            {
+                std::lock_guard<std::mutex> guard(mMutex);
+                mDone += done;
+                mDoneByWorkers += worker ? done : 0;
+                mDoneCV.notify_all();
+            }
+        }
+    };
+
+    auto work = std::make_shared<Work>(txs);
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        mApp.postOnBackgroundThread([work]() { work->run(true); },
+                                    "LedgerManager: preverify");
+    }
+    work->run(false);
+
+    // Transactions cache their hashes, so none of them may be used before
+    // the workers are done with it
+    std::unique_lock<std::mutex> lock(work->mMutex);
+    work->mDoneCV.wait(lock, [&]() { return work->mDone == txs.size(); });
+    mTransactionPreverifiedByWorker.Mark(work->mDoneByWorkers);
+}
+
 void
 LedgerManagerImpl::applyTransactions(
     std::vector<TransactionFrameBasePtr>& txs, AbstractLedgerTxn& ltx,
@@ -903,10 +980,25 @@ LedgerManagerImpl::applyTransactions(
                                         numTxs, numOps);
     }
 
-    prefetchTransactionData(txs);
+    std::unique_ptr<LookaheadPrefetcher> prefetcher;
+    auto root = dynamic_cast<LedgerTxnRoot*>(&mApp.getLedgerTxnRoot());
+    if (root && mApp.getConfig().PREFETCH_BATCH_SIZE > 0 &&
+        mApp.getConfig().PREFETCH_LOOKAHEAD > 0 &&
+        mApp.getDatabase().canUsePool())
+    {
+        prefetcher = std::make_unique<LookaheadPrefetcher>(mApp, *root, txs);
+    }
+    else
+    {
+        prefetchTransactionData(txs);
+    }
 
     for (auto tx : txs)
     {
+        if (prefetcher)
+        {
+            prefetcher->beforeApply(index);
+        }
         auto txTime = mTransactionApply.TimeScope();
         TransactionMeta tm(mApp.getConfig().SUPPORTED_META_VERSION);
         CLOG(DEBUG, "Tx") << " tx#" << index << " = "
@@ -969,6 +1061,18 @@ LedgerManagerImpl::logTxApplyMetrics(AbstractLedgerTxn& ltx, size_t numTxs,
 
     // We lose a bit of precision here, as medida only accepts int64_t
     mPrefetchHitRate.Update(std::llround(hitRate));
+
+    auto& metrics = mApp.getMetrics();
+    for (auto const& kv : mApp.getLedgerTxnRoot().getEntryCacheStats())
+    {
+        std::string type =
+            xdr::xdr_traits<LedgerEntryType>::enum_name(kv.first);
+        std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+        metrics.NewMeter({"ledger", "entry-cache", type + "-hit"}, "entry")
+            .Mark(kv.second.hits);
+        metrics.NewMeter({"ledger", "entry-cache", type + "-miss"}, "entry")
+            .Mark(kv.second.misses);
+    }
 }
 
 void
@@ -43,6 +43,8 @@ class LedgerManagerImpl : public LedgerManager
 
   private:
     medida::Timer& mTransactionApply;
+    medida::Timer& mTransactionPreverify;
+    medida::Meter& mTransactionPreverifiedByWorker;
     medida::Histogram& mTransactionCount;
     medida::Histogram& mOperationCount;
     medida::Histogram& mPrefetchHitRate;
@@ -69,6 +71,8 @@ class LedgerManagerImpl : public LedgerManager
     void storeCurrentLedger(LedgerHeader const& header);
     void prefetchTransactionData(std::vector<TransactionFrameBasePtr>& txs);
     void prefetchTxSourceIds(std::vector<TransactionFrameBasePtr>& txs);
+    void
+    preverifyTransactions(std::vector<TransactionFrameBasePtr> const& txs);
 
     enum class CloseLedgerIfResult
     {
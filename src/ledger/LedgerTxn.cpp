@@ -127,6 +127,12 @@ EntryIterator::entry() const
     return getImpl()->entry();
 }
 
+std::shared_ptr<LedgerEntry> const&
+EntryIterator::entryPtr() const
+{
+    return getImpl()->entryPtr();
+}
+
 bool
 EntryIterator::entryExists() const
 {
@@ -212,6 +218,7 @@ LedgerTxn::Impl::Impl(LedgerTxn& self, AbstractLedgerTxnParent& parent,
     : mParent(parent)
     , mChild(nullptr)
     , mHeader(std::make_unique<LedgerHeader>(mParent.getHeader()))
+    , mArena(getArena(parent))
     , mShouldUpdateLastModified(shouldUpdateLastModified)
     , mIsSealed(false)
     , mConsistency(LedgerTxnConsistency::EXACT)
@@ -325,6 +332,37 @@ LedgerTxn::commitChild(EntryIterator iter, LedgerTxnConsistency cons)
     getImpl()->commitChild(std::move(iter), cons);
 }
 
+std::shared_ptr<Arena>
+LedgerTxn::Impl::getArena(AbstractLedgerTxnParent& parent)
+{
+    auto ltx = dynamic_cast<LedgerTxn*>(&parent);
+    if (ltx && ltx->mImpl)
+    {
+        return ltx->mImpl->mArena;
+    }
+    return std::make_shared<Arena>();
+}
+
+std::shared_ptr<LedgerEntry>
+LedgerTxn::Impl::makeEntry(LedgerEntry const& entry) const
+{
+    return std::allocate_shared<LedgerEntry>(
+        ArenaAllocator<LedgerEntry>(mArena), entry);
+}
+
+// Returns the entry that iter refers to, copying it only if something other
+// than the child being committed references it (such as a LedgerTxnDelta)
+std::shared_ptr<LedgerEntry>
+LedgerTxn::Impl::takeEntry(EntryIterator const& iter) const
+{
+    auto const& ptr = iter.entryPtr();
+    if (ptr.use_count() == 1)
+    {
+        return ptr;
+    }
+    return makeEntry(*ptr);
+}
+
 static LedgerTxnConsistency
 joinConsistencyLevels(LedgerTxnConsistency c1, LedgerTxnConsistency c2)
 {
@@ -356,7 +394,7 @@ LedgerTxn::Impl::commitChild(EntryIterator iter, LedgerTxnConsistency cons)
 
             if (iter.entryExists())
             {
-                updateEntry(key, std::make_shared<LedgerEntry>(iter.entry()));
+                updateEntry(key, takeEntry(iter));
             }
             else
             {
@@ -475,7 +513,7 @@ LedgerTxn::Impl::create(LedgerTxn& self, LedgerEntry const& entry)
         throw std::runtime_error("Key already exists");
     }
 
-    auto current = std::make_shared<LedgerEntry>(entry);
+    auto current = makeEntry(entry);
     auto impl = LedgerTxnEntry::makeSharedImpl(self, *current);
 
     // Set the key to active before constructing the LedgerTxnEntry, as this
@@ -509,7 +547,7 @@ LedgerTxn::Impl::createOrUpdateWithoutLoading(LedgerTxn& self,
         throw std::runtime_error("Key is already active");
     }
 
-    updateEntry(key, std::make_shared<LedgerEntry>(entry));
+    updateEntry(key, makeEntry(entry));
 }
 
 void
@@ -529,8 +567,7 @@ LedgerTxn::Impl::deactivate(LedgerKey const& key)
 
     updateEntryIfRecorded(key, false);
 
-    // C++14 requirements for exception safety of containers guarantee that
-    // erase(iter) does not throw
+    // LedgerKeyMap<...>::erase does not throw
     mActive.erase(iter);
 }
 
@@ -575,8 +612,7 @@ LedgerTxn::Impl::erase(LedgerKey const& key)
     // Note: Cannot throw after this point because the entry will not be
     // deactivated in that case
 
-    // C++14 requirements for exception safety of containers guarantee that
-    // erase(iter) does not throw
+    // LedgerKeyMap<...>::erase does not throw
     if (isActive)
     {
         mActive.erase(activeIter);
@@ -604,8 +640,7 @@ LedgerTxn::Impl::eraseWithoutLoading(LedgerKey const& key)
 
     if (isActive)
     {
-        // C++14 requirements for exception safety of containers guarantee that
-        // erase(iter) does not throw
+        // LedgerKeyMap<...>::erase does not throw
         mActive.erase(activeIter);
     }
     mConsistency = LedgerTxnConsistency::EXTRA_DELETES;
@@ -1194,7 +1229,7 @@ LedgerTxn::Impl::load(LedgerTxn& self, LedgerKey const& key)
         return {};
     }
 
-    auto current = std::make_shared<LedgerEntry>(*newest);
+    auto current = makeEntry(*newest);
     auto impl = LedgerTxnEntry::makeSharedImpl(self, *current);
 
     // Set the key to active before constructing the LedgerTxnEntry, as this
@@ -1254,6 +1289,13 @@ LedgerTxn::loadBestOffer(Asset const& buying, Asset const& selling)
     return getImpl()->loadBestOffer(*this, buying, selling);
 }
 
+LedgerTxnEntry
+LedgerTxn::loadBestOffer(Asset const& buying, Asset const& selling,
+                         std::shared_ptr<LedgerEntry const> const& bestOffer)
+{
+    return getImpl()->loadBestOffer(*this, buying, selling, bestOffer);
+}
+
 LedgerTxnEntry
 LedgerTxn::Impl::loadBestOffer(LedgerTxn& self, Asset const& buying,
                                Asset const& selling)
@@ -1261,7 +1303,17 @@ LedgerTxn::Impl::loadBestOffer(LedgerTxn& self, Asset const& buying,
     throwIfSealed();
     throwIfChild();
 
-    auto le = getBestOffer(buying, selling);
+    return loadBestOffer(self, buying, selling, getBestOffer(buying, selling));
+}
+
+LedgerTxnEntry
+LedgerTxn::Impl::loadBestOffer(LedgerTxn& self, Asset const& buying,
+                               Asset const& selling,
+                               std::shared_ptr<LedgerEntry const> const& le)
+{
+    throwIfSealed();
+    throwIfChild();
+
     auto res = le ? load(self, LedgerEntryKey(*le)) : LedgerTxnEntry();
 
     try
@@ -1550,6 +1602,18 @@ LedgerTxn::Impl::getPrefetchHitRate() const
     return mParent.getPrefetchHitRate();
 }
 
+std::map<LedgerEntryType, EntryCacheStats>
+LedgerTxn::getEntryCacheStats() const
+{
+    return getImpl()->getEntryCacheStats();
+}
+
+std::map<LedgerEntryType, EntryCacheStats>
+LedgerTxn::Impl::getEntryCacheStats() const
+{
+    return mParent.getEntryCacheStats();
+}
+
 uint32_t
 LedgerTxn::prefetch(std::unordered_set<LedgerKey> const& keys)
 {
@@ -1562,31 +1626,30 @@ LedgerTxn::Impl::prefetch(std::unordered_set<LedgerKey> const& keys)
     return mParent.prefetch(keys);
 }
 
-LedgerTxn::Impl::EntryMap
-LedgerTxn::Impl::maybeUpdateLastModified() const
+std::vector<std::pair<LedgerEntry*, uint32_t>>
+LedgerTxn::Impl::maybeUpdateLastModified()
 {
     throwIfSealed();
     throwIfChild();
 
-    // Note: We do a deep copy here since a shallow copy would not be exception
-    // safe.
-    EntryMap entries;
-    entries.reserve(mEntry.size());
-    for (auto const& kv : mEntry)
+    // Note: We update the entries in place rather than copy them, which is
+    // exception safe because only reserve can throw, before any update.
+    std::vector<std::pair<LedgerEntry*, uint32_t>> previous;
+    if (mShouldUpdateLastModified)
     {
-        auto const& key = kv.first;
-        std::shared_ptr<LedgerEntry> entry;
-        if (kv.second)
+        previous.reserve(mEntry.size());
+        for (auto const& kv : mEntry)
         {
-            entry = std::make_shared<LedgerEntry>(*kv.second);
-            if (mShouldUpdateLastModified)
+            auto const& entry = kv.second;
+            if (entry && entry->lastModifiedLedgerSeq != mHeader->ledgerSeq)
             {
+                previous.emplace_back(entry.get(),
+                                      entry->lastModifiedLedgerSeq);
                 entry->lastModifiedLedgerSeq = mHeader->ledgerSeq;
             }
         }
-        entries.emplace(key, entry);
     }
-    return entries;
+    return previous;
 }
 
 void
@@ -1596,14 +1659,21 @@ LedgerTxn::Impl::maybeUpdateLastModifiedThenInvokeThenSeal(
     if (!mIsSealed)
     {
         // Invokes throwIfChild and throwIfSealed
-        auto entries = maybeUpdateLastModified();
-
-        f(entries);
+        auto previous = maybeUpdateLastModified();
 
-        // For associative containers, swap does not throw unless the exception
-        // is thrown by the swap of the Compare object (which is of type
-        // std::less<LedgerKey>, so this should not throw when swapped)
-        mEntry.swap(entries);
+        try
+        {
+            f(mEntry);
+        }
+        catch (...)
+        {
+            // Assigning integers does not throw
+            for (auto const& p : previous)
+            {
+                p.first->lastModifiedLedgerSeq = p.second;
+            }
+            throw;
+        }
 
         // std::multiset<...>::clear does not throw
         // std::set<...>::clear does not throw
@@ -1670,9 +1740,8 @@ LedgerTxn::Impl::updateEntry(LedgerKey const& key,
                              bool effectiveActive, bool eraseIfNull)
 {
     // recordEntry has the strong exception safety guarantee because
-    // - std::unordered_map<...>::erase has the strong exception safety
-    //   guarantee
-    // - std::unordered_map<...>::operator[] has the strong exception safety
+    // - LedgerKeyMap<...>::erase does not throw
+    // - LedgerKeyMap<...>::operator[] has the strong exception safety
     //   guarantee
     // - std::shared_ptr<...>::operator= does not throw
     auto recordEntry = [&]() {
@@ -1852,6 +1921,12 @@ LedgerTxn::Impl::EntryIteratorImpl::entry() const
     return *(mIter->second);
 }
 
+std::shared_ptr<LedgerEntry> const&
+LedgerTxn::Impl::EntryIteratorImpl::entryPtr() const
+{
+    return mIter->second;
+}
+
 bool
 LedgerTxn::Impl::EntryIteratorImpl::entryExists() const
 {
@@ -1913,18 +1988,20 @@ size_t const LedgerTxnRoot::Impl::MAX_BEST_OFFERS_BATCH_SIZE = 1024;
 
 LedgerTxnRoot::LedgerTxnRoot(Database& db, size_t entryCacheSize,
                              size_t bestOfferCacheSize,
-                             size_t prefetchBatchSize)
+                             size_t prefetchBatchSize, bool inMemoryOrderBook)
     : mImpl(std::make_unique<Impl>(db, entryCacheSize, bestOfferCacheSize,
-                                   prefetchBatchSize))
+                                   prefetchBatchSize, inMemoryOrderBook))
 {
 }
 
 LedgerTxnRoot::Impl::Impl(Database& db, size_t entryCacheSize,
-                          size_t bestOfferCacheSize, size_t prefetchBatchSize)
+                          size_t bestOfferCacheSize, size_t prefetchBatchSize,
+                          bool inMemoryOrderBook)
     : mDatabase(db)
     , mHeader(std::make_unique<LedgerHeader>())
     , mEntryCache(entryCacheSize)
     , mBestOffersCache(bestOfferCacheSize)
+    , mInMemoryOrderBook(inMemoryOrderBook)
     , mMaxCacheSize(entryCacheSize)
     , mBulkLoadBatchSize(prefetchBatchSize)
     , mChild(nullptr)
@@ -1947,8 +2024,7 @@ LedgerTxnRoot::Impl::~Impl()
 void
 LedgerTxnRoot::Impl::resetForFuzzer()
 {
-    mBestOffersCache.clear();
-    mEntryCache.clear();
+    clearCaches();
 }
 
 void
@@ -1973,6 +2049,7 @@ LedgerTxnRoot::Impl::addChild(AbstractLedgerTxn& child)
     }
     mTransaction = std::make_unique<soci::transaction>(mDatabase.getSession());
     mChild = &child;
+    ++mChildGeneration;
 }
 
 void
@@ -2084,11 +2161,43 @@ LedgerTxnRoot::Impl::commitChild(EntryIterator iter, LedgerTxnConsistency cons)
     // guarantee, so use std::unique_ptr<...>::swap to achieve it
     auto childHeader = std::make_unique<LedgerHeader>(mChild->getHeader());
 
+    // Committed versions of the entries that are in the entry cache, to write
+    // through once the database commit succeeded. Entries that are not cached
+    // are not added, so that committing many entries (such as when applying
+    // buckets) does not evict the entries that are used in every ledger.
+    std::vector<std::pair<LedgerKey, std::shared_ptr<LedgerEntry const>>>
+        cacheUpdates;
+    // Committed offers, to apply to the order book if it is loaded
+    std::vector<std::pair<LedgerKey, std::shared_ptr<LedgerEntry const>>>
+        offerUpdates;
+    bool offersChanged = false;
+
     auto bleca = BulkLedgerEntryChangeAccumulator();
     try
     {
         while ((bool)iter)
         {
+            auto const& key = iter.key();
+            bool isOffer = key.type() == OFFER;
+            bool cached = mEntryCache.exists(key, false);
+            if (cached || (isOffer && mOrderBook))
+            {
+                // Copied to the heap, as keeping the entry of the child would
+                // keep the Arena of its LedgerTxn tree alive
+                auto entry =
+                    iter.entryExists()
+                        ? std::make_shared<LedgerEntry const>(iter.entry())
+                        : nullptr;
+                if (cached)
+                {
+                    cacheUpdates.emplace_back(key, entry);
+                }
+                if (isOffer && mOrderBook)
+                {
+                    offerUpdates.emplace_back(key, entry);
+                }
+            }
+            offersChanged = offersChanged || isOffer;
             bleca.accumulate(iter);
             ++iter;
             size_t bufferThreshold =
@@ -2113,9 +2222,42 @@ LedgerTxnRoot::Impl::commitChild(EntryIterator iter, LedgerTxnConsistency cons)
             "unknown fatal error during commit to LedgerTxnRoot");
     }
 
-    // Clearing the cache does not throw
-    mBestOffersCache.clear();
-    mEntryCache.clear();
+    // Clearing the caches does not throw, and failing to write through
+    // clears the entry cache, which keeps it an image of the database
+    if (offersChanged)
+    {
+        mBestOffersCache.clear();
+    }
+    try
+    {
+        for (auto const& kv : cacheUpdates)
+        {
+            mEntryCache.put(kv.first, {kv.second, LoadType::IMMEDIATE});
+        }
+    }
+    catch (...)
+    {
+        mEntryCache.clear();
+    }
+    // Likewise, failing to update the order book discards it
+    if (mOrderBook)
+    {
+        try
+        {
+            for (auto const& kv : offerUpdates)
+            {
+                mOrderBook->remove(kv.first);
+                if (kv.second)
+                {
+                    mOrderBook->add(kv.second);
+                }
+            }
+        }
+        catch (...)
+        {
+            mOrderBook.reset();
+        }
+    }
 
     // std::unique_ptr<...>::reset does not throw
     mTransaction.reset();
@@ -2126,6 +2268,8 @@ LedgerTxnRoot::Impl::commitChild(EntryIterator iter, LedgerTxnConsistency cons)
 
     mPrefetchHits = 0;
     mPrefetchMisses = 0;
+    mEntryCacheStats.clear();
+    mEntriesCachedSinceCommit = 0;
 }
 
 std::string
@@ -2202,6 +2346,7 @@ LedgerTxnRoot::Impl::deleteObjectsModifiedOnOrAfterLedger(uint32_t ledger) const
     throwIfChild();
     mEntryCache.clear();
     mBestOffersCache.clear();
+    mOrderBook.reset();
 
     for (auto let : {ACCOUNT, DATA, TRUSTLINE, OFFER})
     {
@@ -2235,6 +2380,123 @@ LedgerTxnRoot::dropTrustLines()
     mImpl->dropTrustLines();
 }
 
+void
+LedgerTxnRoot::bulkInsertEntries(soci::session& session,
+                                 std::vector<LedgerEntry> const& entries)
+{
+    mImpl->bulkInsertEntries(session, entries);
+}
+
+void
+LedgerTxnRoot::Impl::bulkInsertEntries(soci::session& session,
+                                       std::vector<LedgerEntry> const& entries)
+{
+    if (entries.empty())
+    {
+        return;
+    }
+    assert(!mDatabase.isSqlite() || &session == &mDatabase.getSession());
+
+    switch (entries.front().data.type())
+    {
+    case ACCOUNT:
+        bulkInsertAccounts(session, entries);
+        break;
+    case TRUSTLINE:
+        bulkInsertTrustLines(session, entries);
+        break;
+    case OFFER:
+        bulkInsertOffers(session, entries);
+        break;
+    case DATA:
+        bulkInsertAccountData(session, entries);
+        break;
+    default:
+        abort();
+    }
+}
+
+void
+LedgerTxnRoot::dropSecondaryIndexes()
+{
+    mImpl->dropSecondaryIndexes();
+}
+
+void
+LedgerTxnRoot::Impl::dropSecondaryIndexes()
+{
+    throwIfChild();
+    LedgerTxnRoot::setBestOfferIndex(mDatabase.getSession(), false);
+}
+
+void
+LedgerTxnRoot::createSecondaryIndexes()
+{
+    mImpl->createSecondaryIndexes();
+}
+
+void
+LedgerTxnRoot::Impl::createSecondaryIndexes()
+{
+    throwIfChild();
+    LedgerTxnRoot::setBestOfferIndex(mDatabase.getSession(), true);
+}
+
+void
+LedgerTxnRoot::clearCaches()
+{
+    mImpl->clearCaches();
+}
+
+void
+LedgerTxnRoot::Impl::clearCaches()
+{
+    mEntryCache.clear();
+    mBestOffersCache.clear();
+    mOrderBook.reset();
+}
+
+#ifdef USE_POSTGRES
+void
+PGCopyRows::copyTo(PGconn* conn, std::string const& target)
+{
+    auto fail = [conn]() {
+        throw std::runtime_error(std::string("Could not copy data in SQL: ") +
+                                 PQerrorMessage(conn));
+    };
+
+    std::string query = "COPY " + target + " FROM STDIN";
+    PGresult* res = PQexec(conn, query.c_str());
+    auto status = PQresultStatus(res);
+    PQclear(res);
+    if (status != PGRES_COPY_IN)
+    {
+        fail();
+    }
+
+    std::string rows = mRows.str();
+    bool sent =
+        PQputCopyData(conn, rows.data(), static_cast<int>(rows.size())) == 1;
+    if (PQputCopyEnd(conn, sent ? nullptr : "failed to send rows") != 1)
+    {
+        fail();
+    }
+
+    // Collect the final result of the COPY, leaving the connection ready for
+    // the next query even on failure
+    status = PGRES_FATAL_ERROR;
+    while ((res = PQgetResult(conn)) != nullptr)
+    {
+        status = PQresultStatus(res);
+        PQclear(res);
+    }
+    if (!sent || status != PGRES_COMMAND_OK)
+    {
+        fail();
+    }
+}
+#endif
+
 uint32_t
 LedgerTxnRoot::prefetch(std::unordered_set<LedgerKey> const& keys)
 {
@@ -2245,6 +2507,7 @@ uint32_t
 LedgerTxnRoot::Impl::prefetch(std::unordered_set<LedgerKey> const& keys)
 {
     uint32_t total = 0;
+    auto& session = mDatabase.getSession();
 
     std::unordered_set<LedgerKey> accounts;
     std::unordered_set<LedgerKey> offers;
@@ -2271,7 +2534,7 @@ LedgerTxnRoot::Impl::prefetch(std::unordered_set<LedgerKey> const& keys)
 
     for (auto const& key : keys)
     {
-        if ((static_cast<double>(mEntryCache.size()) / mMaxCacheSize) >=
+        if ((static_cast<double>(mEntriesCachedSinceCommit) / mMaxCacheSize) >=
             ENTRY_CACHE_FILL_RATIO)
         {
             return total;
@@ -2283,15 +2546,20 @@ LedgerTxnRoot::Impl::prefetch(std::unordered_set<LedgerKey> const& keys)
             insertIfNotLoaded(accounts, key);
             if (accounts.size() == mBulkLoadBatchSize)
             {
-                cacheResult(bulkLoadAccounts(accounts));
+                cacheResult(bulkLoadAccounts(session, accounts));
                 accounts.clear();
             }
             break;
         case OFFER:
+            if (mInMemoryOrderBook)
+            {
+                // offers are never loaded from the database
+                break;
+            }
             insertIfNotLoaded(offers, key);
             if (offers.size() == mBulkLoadBatchSize)
             {
-                cacheResult(bulkLoadOffers(offers));
+                cacheResult(bulkLoadOffers(session, offers));
                 offers.clear();
             }
             break;
@@ -2299,7 +2567,7 @@ LedgerTxnRoot::Impl::prefetch(std::unordered_set<LedgerKey> const& keys)
             insertIfNotLoaded(trustlines, key);
             if (trustlines.size() == mBulkLoadBatchSize)
             {
-                cacheResult(bulkLoadTrustLines(trustlines));
+                cacheResult(bulkLoadTrustLines(session, trustlines));
                 trustlines.clear();
             }
             break;
@@ -2307,7 +2575,7 @@ LedgerTxnRoot::Impl::prefetch(std::unordered_set<LedgerKey> const& keys)
             insertIfNotLoaded(data, key);
             if (data.size() == mBulkLoadBatchSize)
             {
-                cacheResult(bulkLoadData(data));
+                cacheResult(bulkLoadData(session, data));
                 data.clear();
             }
             break;
@@ -2315,14 +2583,137 @@ LedgerTxnRoot::Impl::prefetch(std::unordered_set<LedgerKey> const& keys)
     }
 
     //  Prefetch whatever is remaining
-    cacheResult(bulkLoadAccounts(accounts));
-    cacheResult(bulkLoadOffers(offers));
-    cacheResult(bulkLoadTrustLines(trustlines));
-    cacheResult(bulkLoadData(data));
+    cacheResult(bulkLoadAccounts(session, accounts));
+    cacheResult(bulkLoadOffers(session, offers));
+    cacheResult(bulkLoadTrustLines(session, trustlines));
+    cacheResult(bulkLoadData(session, data));
 
     return total;
 }
 
+std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
+LedgerTxnRoot::Impl::bulkLoad(soci::session& session,
+                              std::unordered_set<LedgerKey> const& keys) const
+{
+    std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>> res;
+    std::map<LedgerEntryType, std::unordered_set<LedgerKey>> batches;
+
+    auto load = [&](LedgerEntryType type,
+                    std::unordered_set<LedgerKey>& batch) {
+        std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
+            loaded;
+        switch (type)
+        {
+        case ACCOUNT:
+            loaded = bulkLoadAccounts(session, batch);
+            break;
+        case OFFER:
+            loaded = bulkLoadOffers(session, batch);
+            break;
+        case TRUSTLINE:
+            loaded = bulkLoadTrustLines(session, batch);
+            break;
+        case DATA:
+            loaded = bulkLoadData(session, batch);
+            break;
+        }
+        res.insert(loaded.begin(), loaded.end());
+        batch.clear();
+    };
+
+    for (auto const& key : keys)
+    {
+        auto& batch = batches[key.type()];
+        batch.insert(key);
+        if (batch.size() == mBulkLoadBatchSize)
+        {
+            load(key.type(), batch);
+        }
+    }
+    for (auto& kv : batches)
+    {
+        load(kv.first, kv.second);
+    }
+    return res;
+}
+
+std::function<PrefetchedEntries()>
+LedgerTxnRoot::makeAsyncPrefetch(std::unordered_set<LedgerKey> const& keys)
+{
+    return mImpl->makeAsyncPrefetch(keys);
+}
+
+std::function<PrefetchedEntries()>
+LedgerTxnRoot::Impl::makeAsyncPrefetch(
+    std::unordered_set<LedgerKey> const& keys)
+{
+    if (!mChild || !mDatabase.canUsePool())
+    {
+        return {};
+    }
+
+    // Like prefetch, stop before the entries cached since the last commit
+    // reach the fill ratio of the cache
+    double room =
+        ENTRY_CACHE_FILL_RATIO * mMaxCacheSize - mEntriesCachedSinceCommit;
+    std::unordered_set<LedgerKey> toLoad;
+    for (auto const& key : keys)
+    {
+        if (toLoad.size() >= room)
+        {
+            break;
+        }
+        if ((key.type() == OFFER && mInMemoryOrderBook) ||
+            mEntryCache.exists(key, false))
+        {
+            continue;
+        }
+        toLoad.insert(key);
+    }
+    if (toLoad.empty())
+    {
+        return {};
+    }
+
+    // The pool must be created on the main thread
+    auto& pool = mDatabase.getPool();
+    auto generation = mChildGeneration;
+    return [this, &pool, generation, toLoad]() {
+        soci::session session(pool);
+        PrefetchedEntries res;
+        res.generation = generation;
+        res.entries = bulkLoad(session, toLoad);
+        return res;
+    };
+}
+
+uint32_t
+LedgerTxnRoot::cachePrefetched(PrefetchedEntries const& prefetched)
+{
+    return mImpl->cachePrefetched(prefetched);
+}
+
+uint32_t
+LedgerTxnRoot::Impl::cachePrefetched(PrefetchedEntries const& prefetched)
+{
+    if (!mChild || prefetched.generation != mChildGeneration)
+    {
+        return 0;
+    }
+
+    uint32_t total = 0;
+    for (auto const& kv : prefetched.entries)
+    {
+        // Whatever got loaded since comes from the same database state
+        if (!mEntryCache.exists(kv.first, false))
+        {
+            putInEntryCache(kv.first, kv.second, LoadType::PREFETCH);
+            ++total;
+        }
+    }
+    return total;
+}
+
 double
 LedgerTxnRoot::getPrefetchHitRate() const
 {
@@ -2340,6 +2731,18 @@ LedgerTxnRoot::Impl::getPrefetchHitRate() const
            (mPrefetchMisses + mPrefetchHits);
 }
 
+std::map<LedgerEntryType, EntryCacheStats>
+LedgerTxnRoot::getEntryCacheStats() const
+{
+    return mImpl->getEntryCacheStats();
+}
+
+std::map<LedgerEntryType, EntryCacheStats>
+LedgerTxnRoot::Impl::getEntryCacheStats() const
+{
+    return mEntryCacheStats;
+}
+
 std::unordered_map<LedgerKey, LedgerEntry>
 LedgerTxnRoot::getAllOffers()
 {
@@ -2349,6 +2752,17 @@ LedgerTxnRoot::getAllOffers()
 std::unordered_map<LedgerKey, LedgerEntry>
 LedgerTxnRoot::Impl::getAllOffers()
 {
+    if (mInMemoryOrderBook)
+    {
+        auto const& byKey = loadOrderBook().byKey;
+        std::unordered_map<LedgerKey, LedgerEntry> offersByKey(byKey.size());
+        for (auto const& kv : byKey)
+        {
+            offersByKey.emplace(kv.first, *kv.second);
+        }
+        return offersByKey;
+    }
+
     std::vector<LedgerEntry> offers;
     try
     {
@@ -2383,6 +2797,17 @@ LedgerTxnRoot::getBestOffer(Asset const& buying, Asset const& selling)
 std::shared_ptr<LedgerEntry const>
 LedgerTxnRoot::Impl::getBestOffer(Asset const& buying, Asset const& selling)
 {
+    if (mInMemoryOrderBook)
+    {
+        auto const& byAssets = loadOrderBook().byAssets;
+        auto iter = byAssets.find({buying, selling});
+        if (iter == byAssets.end() || iter->second.empty())
+        {
+            return nullptr;
+        }
+        return iter->second.begin()->second;
+    }
+
     // Note: Elements of mBestOffersCache are properly sorted lists of the best
     // offers for a certain asset pair. This function maintaints the invariant
     // that the lists of best offers remain properly sorted. The sort order is
@@ -2432,6 +2857,24 @@ std::shared_ptr<LedgerEntry const>
 LedgerTxnRoot::Impl::getBestOffer(Asset const& buying, Asset const& selling,
                                   OfferDescriptor const& worseThan)
 {
+    if (mInMemoryOrderBook)
+    {
+        auto const& byAssets = loadOrderBook().byAssets;
+        auto iter = byAssets.find({buying, selling});
+        if (iter == byAssets.end())
+        {
+            return nullptr;
+        }
+        auto const& offers = iter->second;
+        auto offerIter = offers.upper_bound(worseThan);
+        if (offerIter == offers.end())
+        {
+            return nullptr;
+        }
+        prefetchSellers(offerIter, offers.end());
+        return offerIter->second;
+    }
+
     // Note: Elements of mBestOffersCache are properly sorted lists of the best
     // offers for a certain asset pair. This function maintaints the invariant
     // that the lists of best offers remain properly sorted. The sort order is
@@ -2506,6 +2949,26 @@ std::unordered_map<LedgerKey, LedgerEntry>
 LedgerTxnRoot::Impl::getOffersByAccountAndAsset(AccountID const& account,
                                                 Asset const& asset)
 {
+    if (mInMemoryOrderBook)
+    {
+        auto const& book = loadOrderBook();
+        std::unordered_map<LedgerKey, LedgerEntry> res;
+        auto iter = book.bySeller.find(account);
+        if (iter != book.bySeller.end())
+        {
+            for (auto const& key : iter->second)
+            {
+                auto const& le = *book.byKey.at(key);
+                auto const& oe = le.data.offer();
+                if (oe.buying == asset || oe.selling == asset)
+                {
+                    res.emplace(key, le);
+                }
+            }
+        }
+        return res;
+    }
+
     std::vector<LedgerEntry> offers;
     try
     {
@@ -2578,12 +3041,22 @@ LedgerTxnRoot::getNewestVersion(LedgerKey const& key) const
 std::shared_ptr<LedgerEntry const>
 LedgerTxnRoot::Impl::getNewestVersion(LedgerKey const& key) const
 {
+    if (mInMemoryOrderBook && key.type() == OFFER)
+    {
+        auto const& byKey = loadOrderBook().byKey;
+        auto iter = byKey.find(key);
+        return iter == byKey.end() ? nullptr : iter->second;
+    }
+
+    auto& stats = mEntryCacheStats[key.type()];
     if (mEntryCache.exists(key))
     {
+        ++stats.hits;
         return getFromEntryCache(key);
     }
     else
     {
+        ++stats.misses;
         ++mPrefetchMisses;
     }
 
@@ -2652,6 +3125,8 @@ LedgerTxnRoot::Impl::rollbackChild()
     mChild = nullptr;
     mPrefetchHits = 0;
     mPrefetchMisses = 0;
+    mEntryCacheStats.clear();
+    mEntriesCachedSinceCommit = 0;
 }
 
 std::shared_ptr<LedgerEntry const>
@@ -2681,6 +3156,7 @@ LedgerTxnRoot::Impl::putInEntryCache(
     try
     {
         mEntryCache.put(key, {entry, type});
+        ++mEntriesCachedSinceCommit;
     }
     catch (...)
     {
@@ -2689,6 +3165,105 @@ LedgerTxnRoot::Impl::putInEntryCache(
     }
 }
 
+void
+LedgerTxnRoot::Impl::InMemoryOrderBook::add(
+    std::shared_ptr<LedgerEntry const> const& offer)
+{
+    auto const& oe = offer->data.offer();
+    auto key = LedgerEntryKey(*offer);
+    byAssets[AssetPair{oe.buying, oe.selling}].emplace(
+        OfferDescriptor{oe.price, oe.offerID}, offer);
+    byKey.emplace(key, offer);
+    bySeller[oe.sellerID].emplace(key);
+}
+
+void
+LedgerTxnRoot::Impl::InMemoryOrderBook::remove(LedgerKey const& key)
+{
+    auto iter = byKey.find(key);
+    if (iter == byKey.end())
+    {
+        return;
+    }
+    auto const& oe = iter->second->data.offer();
+
+    auto assetsIter = byAssets.find(AssetPair{oe.buying, oe.selling});
+    assetsIter->second.erase(OfferDescriptor{oe.price, oe.offerID});
+    if (assetsIter->second.empty())
+    {
+        byAssets.erase(assetsIter);
+    }
+
+    auto sellerIter = bySeller.find(oe.sellerID);
+    sellerIter->second.erase(key);
+    if (sellerIter->second.empty())
+    {
+        bySeller.erase(sellerIter);
+    }
+
+    byKey.erase(iter);
+}
+
+LedgerTxnRoot::Impl::InMemoryOrderBook&
+LedgerTxnRoot::Impl::loadOrderBook() const
+{
+    if (!mOrderBook)
+    {
+        auto book = std::make_unique<InMemoryOrderBook>();
+        try
+        {
+            auto offers = loadAllOffers();
+            for (auto& le : offers)
+            {
+                book->add(std::make_shared<LedgerEntry const>(std::move(le)));
+            }
+        }
+        catch (std::exception& e)
+        {
+            printErrorAndAbort(
+                "fatal error when loading order book in LedgerTxnRoot: ",
+                e.what());
+        }
+        catch (...)
+        {
+            printErrorAndAbort(
+                "unknown fatal error when loading order book in LedgerTxnRoot");
+        }
+        mOrderBook = std::move(book);
+    }
+    return *mOrderBook;
+}
+
+void
+LedgerTxnRoot::Impl::prefetchSellers(
+    InMemoryOrderBook::Offers::const_iterator iter,
+    InMemoryOrderBook::Offers::const_iterator const& end)
+{
+    // Offers are crossed in order, so when the seller of an offer is not
+    // cached, load the sellers of this offer and the next ones in one batch
+    auto const& sellerID = iter->second->data.offer().sellerID;
+    if (mEntryCache.exists(accountKey(sellerID), false))
+    {
+        return;
+    }
+
+    std::unordered_set<LedgerKey> toPrefetch;
+    for (size_t n = 0; iter != end && n < mBulkLoadBatchSize; ++iter, ++n)
+    {
+        auto const& oe = iter->second->data.offer();
+        toPrefetch.emplace(accountKey(oe.sellerID));
+        if (oe.buying.type() != ASSET_TYPE_NATIVE)
+        {
+            toPrefetch.emplace(trustlineKey(oe.sellerID, oe.buying));
+        }
+        if (oe.selling.type() != ASSET_TYPE_NATIVE)
+        {
+            toPrefetch.emplace(trustlineKey(oe.sellerID, oe.selling));
+        }
+    }
+    prefetch(toPrefetch);
+}
+
 LedgerTxnRoot::Impl::BestOffersCacheEntryPtr
 LedgerTxnRoot::Impl::getFromBestOffersCache(Asset const& buying,
                                             Asset const& selling) const
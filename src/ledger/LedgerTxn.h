@@ -164,6 +164,11 @@
 //    accesses to a parent's entries when a child is open.
 //
 
+namespace soci
+{
+class session;
+}
+
 namespace stellar
 {
 
@@ -250,6 +255,22 @@ struct InflationWinner
     int64_t votes;
 };
 
+// Lookups of one type of ledger entry that the LedgerTxnRoot entry cache
+// answered (hits) or that went to the database (misses).
+struct EntryCacheStats
+{
+    uint64_t hits{0};
+    uint64_t misses{0};
+};
+
+// Entries loaded by a LedgerTxnRoot::makeAsyncPrefetch function, to be cached
+// by LedgerTxnRoot::cachePrefetched.
+struct PrefetchedEntries
+{
+    uint64_t generation{0};
+    std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>> entries;
+};
+
 class AbstractLedgerTxn;
 
 // LedgerTxnDelta represents the difference between a LedgerTxn and its
@@ -299,6 +320,11 @@ class EntryIterator
 
     LedgerEntry const& entry() const;
 
+    // The entry is owned by the AbstractLedgerTxn being committed, which is
+    // sealed and destroyed once commitChild returns. This allows the parent
+    // to keep the entry rather than copy it, if nothing else references it.
+    std::shared_ptr<LedgerEntry> const& entryPtr() const;
+
     bool entryExists() const;
 
     LedgerKey const& key() const;
@@ -428,6 +454,12 @@ class AbstractLedgerTxnParent
     // (real or stub) root LedgerTxn.
     virtual double getPrefetchHitRate() const = 0;
 
+    // Return the entry cache hits and misses, by type of ledger entry, since
+    // the last commit or rollback of the child of the root. Will throw when
+    // called on anything other than a (real or stub) root LedgerTxn.
+    virtual std::map<LedgerEntryType, EntryCacheStats>
+    getEntryCacheStats() const = 0;
+
     // Prefetch a set of ledger entries into memory, anticipating their use.
     // This is purely advisory and can be a no-op, or do any level of actual
     // work, while still being correct. Will throw when called on anything other
@@ -545,7 +577,10 @@ class AbstractLedgerTxn : public AbstractLedgerTxnParent
     // - loadAllOffers
     //     Load every offer, grouped by account.
     // - loadBestOffer
-    //     Load the best offer with specified buying and selling assets.
+    //     Load the best offer with specified buying and selling assets. The
+    //     overload taking bestOffer loads that offer instead of looking for
+    //     the best offer again, and must only be given what getBestOffer
+    //     returned for the same assets with no change made since.
     // - loadOffersByAccountAndAsset
     //     Load every offer owned by the specified account that is either buying
     //     or selling the specified asset.
@@ -556,6 +591,9 @@ class AbstractLedgerTxn : public AbstractLedgerTxnParent
     loadAllOffers() = 0;
     virtual LedgerTxnEntry loadBestOffer(Asset const& buying,
                                          Asset const& selling) = 0;
+    virtual LedgerTxnEntry
+    loadBestOffer(Asset const& buying, Asset const& selling,
+                  std::shared_ptr<LedgerEntry const> const& bestOffer) = 0;
     virtual std::vector<LedgerTxnEntry>
     loadOffersByAccountAndAsset(AccountID const& accountID,
                                 Asset const& asset) = 0;
@@ -643,6 +681,9 @@ class LedgerTxn final : public AbstractLedgerTxn
 
     LedgerTxnEntry loadBestOffer(Asset const& buying,
                                  Asset const& selling) override;
+    LedgerTxnEntry
+    loadBestOffer(Asset const& buying, Asset const& selling,
+                  std::shared_ptr<LedgerEntry const> const& bestOffer) override;
 
     LedgerTxnHeader loadHeader() override;
 
@@ -667,6 +708,8 @@ class LedgerTxn final : public AbstractLedgerTxn
     void dropOffers() override;
     void dropTrustLines() override;
     double getPrefetchHitRate() const override;
+    std::map<LedgerEntryType, EntryCacheStats>
+    getEntryCacheStats() const override;
     uint32_t prefetch(std::unordered_set<LedgerKey> const& keys) override;
 
 #ifdef BUILD_TESTS
@@ -685,7 +728,8 @@ class LedgerTxnRoot : public AbstractLedgerTxnParent
 
   public:
     explicit LedgerTxnRoot(Database& db, size_t entryCacheSize,
-                           size_t bestOfferCacheSize, size_t prefetchBatchSize);
+                           size_t bestOfferCacheSize, size_t prefetchBatchSize,
+                           bool inMemoryOrderBook);
 
     virtual ~LedgerTxnRoot();
 
@@ -704,6 +748,29 @@ class LedgerTxnRoot : public AbstractLedgerTxnParent
     void dropOffers() override;
     void dropTrustLines() override;
 
+    // Insert `entries`, which must all have the same type and must not be in
+    // the database yet, through `session`. This is meant to load buckets into
+    // empty tables: it uses COPY on postgres, where `session` may come from
+    // the connection pool so that several tables are loaded concurrently. On
+    // sqlite, `session` must be the main session. The caches are not updated,
+    // so they must be cleared (see clearCaches) once the tables are filled.
+    void bulkInsertEntries(soci::session& session,
+                           std::vector<LedgerEntry> const& entries);
+
+    // Drop (and re-create) the indexes that are not needed to look up
+    // entries by key, which would only slow down bulk inserts.
+    void dropSecondaryIndexes();
+    void createSecondaryIndexes();
+
+    // Create the index used to find the best offers unless it exists, or drop
+    // it when `!exists`. This is the only place where the index is defined.
+    static void setBestOfferIndex(soci::session& session, bool exists);
+
+    // Forget every cached entry, best offer and the in-memory order book, as
+    // they may be stale after writing to the tables without going through
+    // commit (such as with bulkInsertEntries).
+    void clearCaches();
+
 #ifdef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
     void resetForFuzzer();
 #endif // FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
@@ -732,5 +799,21 @@ class LedgerTxnRoot : public AbstractLedgerTxnParent
 
     uint32_t prefetch(std::unordered_set<LedgerKey> const& keys) override;
     double getPrefetchHitRate() const override;
+    std::map<LedgerEntryType, EntryCacheStats>
+    getEntryCacheStats() const override;
+
+    // Prefetches the entries of `keys` that are not cached yet away from the
+    // main thread. Returns a function that loads them through a connection of
+    // the database pool, which can run on any thread while the root keeps its
+    // current child, and whose result must be passed to cachePrefetched on
+    // the main thread. Returns an empty function if there is nothing to load,
+    // if the database has no pool or if the root has no child.
+    std::function<PrefetchedEntries()>
+    makeAsyncPrefetch(std::unordered_set<LedgerKey> const& keys);
+
+    // Puts the entries loaded by a makeAsyncPrefetch function into the entry
+    // cache, unless the child of the root changed since (in which case they
+    // may be outdated). Returns the number of entries cached.
+    uint32_t cachePrefetched(PrefetchedEntries const& prefetched);
 };
 }
@@ -147,79 +147,101 @@ class BulkUpsertAccountsOperation : public DatabaseTypeSpecificOperation<void>
     std::vector<int64_t> mSellingLiabilities;
     std::vector<soci::indicator> mLiabilitiesInds;
 
+    void
+    accumulateEntry(LedgerEntry const& entry)
+    {
+        assert(entry.data.type() == ACCOUNT);
+        auto const& account = entry.data.account();
+        mAccountIDs.emplace_back(KeyUtils::toStrKey(account.accountID));
+        mBalances.emplace_back(account.balance);
+        mSeqNums.emplace_back(account.seqNum);
+        mSubEntryNums.emplace_back(unsignedToSigned(account.numSubEntries));
+
+        if (account.inflationDest)
+        {
+            mInflationDests.emplace_back(
+                KeyUtils::toStrKey(*account.inflationDest));
+            mInflationDestInds.emplace_back(soci::i_ok);
+        }
+        else
+        {
+            mInflationDests.emplace_back("");
+            mInflationDestInds.emplace_back(soci::i_null);
+        }
+        mFlags.emplace_back(unsignedToSigned(account.flags));
+        mHomeDomains.emplace_back(decoder::encode_b64(account.homeDomain));
+        mThresholds.emplace_back(decoder::encode_b64(account.thresholds));
+        if (account.signers.empty())
+        {
+            mSigners.emplace_back("");
+            mSignerInds.emplace_back(soci::i_null);
+        }
+        else
+        {
+            mSigners.emplace_back(
+                decoder::encode_b64(xdr::xdr_to_opaque(account.signers)));
+            mSignerInds.emplace_back(soci::i_ok);
+        }
+        mLastModifieds.emplace_back(
+            unsignedToSigned(entry.lastModifiedLedgerSeq));
+
+        if (account.ext.v() >= 1)
+        {
+            mBuyingLiabilities.emplace_back(
+                account.ext.v1().liabilities.buying);
+            mSellingLiabilities.emplace_back(
+                account.ext.v1().liabilities.selling);
+            mLiabilitiesInds.emplace_back(soci::i_ok);
+        }
+        else
+        {
+            mBuyingLiabilities.emplace_back(0);
+            mSellingLiabilities.emplace_back(0);
+            mLiabilitiesInds.emplace_back(soci::i_null);
+        }
+    }
+
+    void
+    reserve(size_t n)
+    {
+        mAccountIDs.reserve(n);
+        mBalances.reserve(n);
+        mSeqNums.reserve(n);
+        mSubEntryNums.reserve(n);
+        mInflationDests.reserve(n);
+        mInflationDestInds.reserve(n);
+        mFlags.reserve(n);
+        mHomeDomains.reserve(n);
+        mThresholds.reserve(n);
+        mSigners.reserve(n);
+        mSignerInds.reserve(n);
+        mLastModifieds.reserve(n);
+        mBuyingLiabilities.reserve(n);
+        mSellingLiabilities.reserve(n);
+        mLiabilitiesInds.reserve(n);
+    }
+
   public:
     BulkUpsertAccountsOperation(Database& DB,
-                                std::vector<EntryIterator> const& entries)
+                                std::vector<LedgerEntry> const& entries)
         : mDB(DB)
     {
-        mAccountIDs.reserve(entries.size());
-        mBalances.reserve(entries.size());
-        mSeqNums.reserve(entries.size());
-        mSubEntryNums.reserve(entries.size());
-        mInflationDests.reserve(entries.size());
-        mInflationDestInds.reserve(entries.size());
-        mFlags.reserve(entries.size());
-        mHomeDomains.reserve(entries.size());
-        mThresholds.reserve(entries.size());
-        mSigners.reserve(entries.size());
-        mSignerInds.reserve(entries.size());
-        mLastModifieds.reserve(entries.size());
-        mBuyingLiabilities.reserve(entries.size());
-        mSellingLiabilities.reserve(entries.size());
-        mLiabilitiesInds.reserve(entries.size());
+        reserve(entries.size());
+        for (auto const& e : entries)
+        {
+            accumulateEntry(e);
+        }
+    }
 
+    BulkUpsertAccountsOperation(Database& DB,
+                                std::vector<EntryIterator> const& entries)
+        : mDB(DB)
+    {
+        reserve(entries.size());
         for (auto const& e : entries)
         {
             assert(e.entryExists());
-            assert(e.entry().data.type() == ACCOUNT);
-            auto const& account = e.entry().data.account();
-            mAccountIDs.emplace_back(KeyUtils::toStrKey(account.accountID));
-            mBalances.emplace_back(account.balance);
-            mSeqNums.emplace_back(account.seqNum);
-            mSubEntryNums.emplace_back(unsignedToSigned(account.numSubEntries));
-
-            if (account.inflationDest)
-            {
-                mInflationDests.emplace_back(
-                    KeyUtils::toStrKey(*account.inflationDest));
-                mInflationDestInds.emplace_back(soci::i_ok);
-            }
-            else
-            {
-                mInflationDests.emplace_back("");
-                mInflationDestInds.emplace_back(soci::i_null);
-            }
-            mFlags.emplace_back(unsignedToSigned(account.flags));
-            mHomeDomains.emplace_back(decoder::encode_b64(account.homeDomain));
-            mThresholds.emplace_back(decoder::encode_b64(account.thresholds));
-            if (account.signers.empty())
-            {
-                mSigners.emplace_back("");
-                mSignerInds.emplace_back(soci::i_null);
-            }
-            else
-            {
-                mSigners.emplace_back(
-                    decoder::encode_b64(xdr::xdr_to_opaque(account.signers)));
-                mSignerInds.emplace_back(soci::i_ok);
-            }
-            mLastModifieds.emplace_back(
-                unsignedToSigned(e.entry().lastModifiedLedgerSeq));
-
-            if (account.ext.v() >= 1)
-            {
-                mBuyingLiabilities.emplace_back(
-                    account.ext.v1().liabilities.buying);
-                mSellingLiabilities.emplace_back(
-                    account.ext.v1().liabilities.selling);
-                mLiabilitiesInds.emplace_back(soci::i_ok);
-            }
-            else
-            {
-                mBuyingLiabilities.emplace_back(0);
-                mSellingLiabilities.emplace_back(0);
-                mLiabilitiesInds.emplace_back(soci::i_null);
-            }
+            accumulateEntry(e.entry());
         }
     }
 
@@ -358,6 +380,32 @@ class BulkUpsertAccountsOperation : public DatabaseTypeSpecificOperation<void>
             throw std::runtime_error("Could not update data in SQL");
         }
     }
+
+    void
+    doPostgresCopy(PGconn* conn)
+    {
+        PGCopyRows rows;
+        for (size_t i = 0; i < mAccountIDs.size(); ++i)
+        {
+            rows.add(mAccountIDs[i]);
+            rows.add(mBalances[i]);
+            rows.add(mSeqNums[i]);
+            rows.add(mSubEntryNums[i]);
+            rows.add(mInflationDests[i], mInflationDestInds[i]);
+            rows.add(mHomeDomains[i]);
+            rows.add(mThresholds[i]);
+            rows.add(mSigners[i], mSignerInds[i]);
+            rows.add(mFlags[i]);
+            rows.add(mLastModifieds[i]);
+            rows.add(mBuyingLiabilities[i], mLiabilitiesInds[i]);
+            rows.add(mSellingLiabilities[i], mLiabilitiesInds[i]);
+            rows.endRow();
+        }
+        rows.copyTo(conn, "accounts (accountid, balance, seqnum, "
+                          "numsubentries, inflationdest, homedomain, "
+                          "thresholds, signers, flags, lastmodified, "
+                          "buyingliabilities, sellingliabilities)");
+    }
 #endif
 };
 
@@ -441,6 +489,15 @@ LedgerTxnRoot::Impl::bulkUpsertAccounts(
     mDatabase.doDatabaseTypeSpecificOperation(op);
 }
 
+void
+LedgerTxnRoot::Impl::bulkInsertAccounts(
+    soci::session& session, std::vector<LedgerEntry> const& entries)
+{
+    BulkUpsertAccountsOperation op(mDatabase, entries);
+    BulkInsertOperation<BulkUpsertAccountsOperation> insertOp(op);
+    mDatabase.doDatabaseTypeSpecificOperation(session, insertOp);
+}
+
 void
 LedgerTxnRoot::Impl::bulkDeleteAccounts(
     std::vector<EntryIterator> const& entries, LedgerTxnConsistency cons)
@@ -484,6 +541,7 @@ class BulkLoadAccountsOperation
     : public DatabaseTypeSpecificOperation<std::vector<LedgerEntry>>
 {
     Database& mDb;
+    soci::session& mSession;
     std::vector<std::string> mAccountIDs;
 
     std::vector<LedgerEntry>
@@ -573,9 +631,9 @@ class BulkLoadAccountsOperation
     }
 
   public:
-    BulkLoadAccountsOperation(Database& db,
+    BulkLoadAccountsOperation(Database& db, soci::session& session,
                               std::unordered_set<LedgerKey> const& keys)
-        : mDb(db)
+        : mDb(db), mSession(session)
     {
         mAccountIDs.reserve(keys.size());
         for (auto const& k : keys)
@@ -601,7 +659,7 @@ class BulkLoadAccountsOperation
             "buyingliabilities, sellingliabilities, signers FROM accounts "
             "WHERE accountid IN carray(?, ?, 'char*')";
 
-        auto prep = mDb.getPreparedStatement(sql);
+        auto prep = mDb.getPreparedStatement(sql, mSession);
         auto be = prep.statement().get_backend();
         if (be == nullptr)
         {
@@ -632,7 +690,7 @@ class BulkLoadAccountsOperation
             "buyingliabilities, sellingliabilities, signers FROM accounts "
             "WHERE accountid IN (SELECT * FROM r)";
 
-        auto prep = mDb.getPreparedStatement(sql);
+        auto prep = mDb.getPreparedStatement(sql, mSession);
         auto& st = prep.statement();
         st.exchange(soci::use(strAccountIDs));
         return executeAndFetch(st);
@@ -642,13 +700,13 @@ class BulkLoadAccountsOperation
 
 std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
 LedgerTxnRoot::Impl::bulkLoadAccounts(
-    std::unordered_set<LedgerKey> const& keys) const
+    soci::session& session, std::unordered_set<LedgerKey> const& keys) const
 {
     if (!keys.empty())
     {
-        BulkLoadAccountsOperation op(mDatabase, keys);
+        BulkLoadAccountsOperation op(mDatabase, session, keys);
         return populateLoadedEntries(
-            keys, mDatabase.doDatabaseTypeSpecificOperation(op));
+            keys, mDatabase.doDatabaseTypeSpecificOperation(session, op));
     }
     else
     {
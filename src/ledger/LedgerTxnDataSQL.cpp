@@ -169,6 +169,22 @@ class BulkUpsertDataOperation : public DatabaseTypeSpecificOperation<void>
             throw std::runtime_error("Could not update data in SQL");
         }
     }
+
+    void
+    doPostgresCopy(PGconn* conn)
+    {
+        PGCopyRows rows;
+        for (size_t i = 0; i < mAccountIDs.size(); ++i)
+        {
+            rows.add(mAccountIDs[i]);
+            rows.add(mDataNames[i]);
+            rows.add(mDataValues[i]);
+            rows.add(mLastModifieds[i]);
+            rows.endRow();
+        }
+        rows.copyTo(conn, "accountdata (accountid, dataname, datavalue, "
+                          "lastmodified)");
+    }
 #endif
 };
 
@@ -263,6 +279,15 @@ LedgerTxnRoot::Impl::bulkUpsertAccountData(
     mDatabase.doDatabaseTypeSpecificOperation(op);
 }
 
+void
+LedgerTxnRoot::Impl::bulkInsertAccountData(
+    soci::session& session, std::vector<LedgerEntry> const& entries)
+{
+    BulkUpsertDataOperation op(mDatabase, entries);
+    BulkInsertOperation<BulkUpsertDataOperation> insertOp(op);
+    mDatabase.doDatabaseTypeSpecificOperation(session, insertOp);
+}
+
 void
 LedgerTxnRoot::Impl::bulkDeleteAccountData(
     std::vector<EntryIterator> const& entries, LedgerTxnConsistency cons)
@@ -297,6 +322,7 @@ class BulkLoadDataOperation
     : public DatabaseTypeSpecificOperation<std::vector<LedgerEntry>>
 {
     Database& mDb;
+    soci::session& mSession;
     std::vector<std::string> mAccountIDs;
     std::vector<std::string> mDataNames;
 
@@ -335,9 +361,9 @@ class BulkLoadDataOperation
     }
 
   public:
-    BulkLoadDataOperation(Database& db,
+    BulkLoadDataOperation(Database& db, soci::session& session,
                           std::unordered_set<LedgerKey> const& keys)
-        : mDb(db)
+        : mDb(db), mSession(session)
     {
         mAccountIDs.reserve(keys.size());
         mDataNames.reserve(keys.size());
@@ -375,7 +401,7 @@ class BulkLoadDataOperation
             ") SELECT accountid, dataname, datavalue, lastmodified "
             "FROM accountdata WHERE (accountid, dataname) IN r";
 
-        auto prep = mDb.getPreparedStatement(sql);
+        auto prep = mDb.getPreparedStatement(sql, mSession);
         auto be = prep.statement().get_backend();
         if (be == nullptr)
         {
@@ -409,7 +435,7 @@ class BulkLoadDataOperation
             "SELECT accountid, dataname, datavalue, lastmodified "
             "FROM accountdata WHERE (accountid, dataname) IN (SELECT * FROM r)";
 
-        auto prep = mDb.getPreparedStatement(sql);
+        auto prep = mDb.getPreparedStatement(sql, mSession);
         auto& st = prep.statement();
         st.exchange(soci::use(strAccountIDs));
         st.exchange(soci::use(strDataNames));
@@ -420,13 +446,13 @@ class BulkLoadDataOperation
 
 std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
 LedgerTxnRoot::Impl::bulkLoadData(
-    std::unordered_set<LedgerKey> const& keys) const
+    soci::session& session, std::unordered_set<LedgerKey> const& keys) const
 {
     if (!keys.empty())
     {
-        BulkLoadDataOperation op(mDatabase, keys);
+        BulkLoadDataOperation op(mDatabase, session, keys);
         return populateLoadedEntries(
-            keys, mDatabase.doDatabaseTypeSpecificOperation(op));
+            keys, mDatabase.doDatabaseTypeSpecificOperation(session, op));
     }
     else
     {
@@ -2,8 +2,11 @@
 // under the Apache License, Version 2.0. See the COPYING file at the root
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
+#include "crypto/SecretKey.h"
 #include "database/Database.h"
+#include "ledger/LedgerKeyMap.h"
 #include "ledger/LedgerTxn.h"
+#include "util/Arena.h"
 #include "util/RandomEvictionCache.h"
 #include <list>
 #ifdef USE_POSTGRES
@@ -39,6 +42,8 @@ class EntryIterator::AbstractImpl
 
     virtual LedgerEntry const& entry() const = 0;
 
+    virtual std::shared_ptr<LedgerEntry> const& entryPtr() const = 0;
+
     virtual bool entryExists() const = 0;
 
     virtual LedgerKey const& key() const = 0;
@@ -152,15 +157,18 @@ class LedgerTxn::Impl
     class EntryIteratorImpl;
     class WorstBestOfferIteratorImpl;
 
-    typedef std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry>>
-        EntryMap;
+    typedef LedgerKeyMap<std::shared_ptr<LedgerEntry>> EntryMap;
 
     AbstractLedgerTxnParent& mParent;
     AbstractLedgerTxn* mChild;
     std::unique_ptr<LedgerHeader> mHeader;
     std::shared_ptr<LedgerTxnHeader::Impl> mActiveHeader;
+    // The entries of a tree of nested LedgerTxn are allocated from the Arena
+    // of its outermost LedgerTxn, which is released once they are all
+    // destroyed.
+    std::shared_ptr<Arena> const mArena;
     EntryMap mEntry;
-    std::unordered_map<LedgerKey, std::shared_ptr<EntryImplBase>> mActive;
+    LedgerKeyMap<std::shared_ptr<EntryImplBase>> mActive;
     bool const mShouldUpdateLastModified;
     bool mIsSealed;
     LedgerTxnConsistency mConsistency;
@@ -209,15 +217,15 @@ class LedgerTxn::Impl
     // slow.
     //
     // Specifically: in the performance-critical loop of convertWithOffers in
-    // transactions/OfferExchange.cpp, an "outer" loop-spanning LedgerTxn is
-    // held open while sub-LedgerTxns are, inside the loop, repeatedly opened
-    // and committed against it, each requesting and then crossing one next-best
-    // offer. While this "outer" LedgerTxn's MultiOrderBook will be kept
-    // up-to-date with respect to the depleting supply of offers, its _parent_
-    // LedgerTxn will answer each such request starting from its own
-    // MultiOrderBook, which contains an increasingly-long sequence of offers
-    // that have already been crossed and marked dead in the loop-spanning
-    // LedgerTxn.
+    // transactions/OfferExchange.cpp, a loop-spanning LedgerTxn repeatedly
+    // loads and then crosses one next-best offer, and is then committed
+    // against the LedgerTxn of the operation, which is itself committed
+    // against the LedgerTxn of the transaction, and so on. While each
+    // LedgerTxn's MultiOrderBook will be kept up-to-date with respect to the
+    // depleting supply of offers, its _parent_ LedgerTxn will answer each
+    // request for the next-best offer starting from its own MultiOrderBook,
+    // which contains an increasingly-long sequence of offers that have already
+    // been crossed and marked dead in the child LedgerTxn.
     //
     // The WorstBestOfferMap accelerates this specific case (and cases like it),
     // but it's worth understanding how, very clearly. Here's a diagram,
@@ -362,11 +370,21 @@ class LedgerTxn::Impl
     enumerateInflationWinners(std::map<AccountID, int64_t> const& totalVotes,
                               size_t maxWinners, int64_t minVotes) const;
 
+    static std::shared_ptr<Arena> getArena(AbstractLedgerTxnParent& parent);
+
+    // makeEntry has the strong exception safety guarantee
+    std::shared_ptr<LedgerEntry> makeEntry(LedgerEntry const& entry) const;
+
+    // takeEntry has the strong exception safety guarantee
+    std::shared_ptr<LedgerEntry> takeEntry(EntryIterator const& iter) const;
+
     // getEntryIterator has the strong exception safety guarantee
     EntryIterator getEntryIterator(EntryMap const& entries) const;
 
-    // maybeUpdateLastModified has the strong exception safety guarantee
-    EntryMap maybeUpdateLastModified() const;
+    // maybeUpdateLastModified has the strong exception safety guarantee. It
+    // updates the entries in place, and returns the entries it updated with
+    // their previous lastModifiedLedgerSeq so that the update can be undone.
+    std::vector<std::pair<LedgerEntry*, uint32_t>> maybeUpdateLastModified();
 
     // maybeUpdateLastModifiedThenInvokeThenSeal has the same exception safety
     // guarantee as f
@@ -532,6 +550,9 @@ class LedgerTxn::Impl
     //   even cleared
     LedgerTxnEntry loadBestOffer(LedgerTxn& self, Asset const& buying,
                                  Asset const& selling);
+    LedgerTxnEntry
+    loadBestOffer(LedgerTxn& self, Asset const& buying, Asset const& selling,
+                  std::shared_ptr<LedgerEntry const> const& bestOffer);
 
     // loadHeader has the strong exception safety guarantee
     LedgerTxnHeader loadHeader(LedgerTxn& self);
@@ -564,8 +585,14 @@ class LedgerTxn::Impl
 
     uint32_t prefetch(std::unordered_set<LedgerKey> const& keys);
 
+    std::function<PrefetchedEntries()>
+    makeAsyncPrefetch(std::unordered_set<LedgerKey> const& keys);
+    uint32_t cachePrefetched(PrefetchedEntries const& prefetched);
+
     double getPrefetchHitRate() const;
 
+    std::map<LedgerEntryType, EntryCacheStats> getEntryCacheStats() const;
+
 #ifdef BUILD_TESTS
     MultiOrderBook const& getOrderBook();
 #endif
@@ -586,6 +613,8 @@ class LedgerTxn::Impl::EntryIteratorImpl : public EntryIterator::AbstractImpl
 
     LedgerEntry const& entry() const override;
 
+    std::shared_ptr<LedgerEntry> const& entryPtr() const override;
+
     bool entryExists() const override;
 
     LedgerKey const& key() const override;
@@ -659,17 +688,47 @@ class LedgerTxnRoot::Impl
     static size_t const MIN_BEST_OFFERS_BATCH_SIZE;
     static size_t const MAX_BEST_OFFERS_BATCH_SIZE;
 
+    // A complete image of the offers in the database, indexed by asset pair
+    // (sorted as by isBetterOffer), by key and by seller.
+    struct InMemoryOrderBook
+    {
+        typedef std::map<OfferDescriptor, std::shared_ptr<LedgerEntry const>,
+                         IsBetterOfferComparator>
+            Offers;
+
+        std::unordered_map<AssetPair, Offers, AssetPairHash> byAssets;
+        std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
+            byKey;
+        std::unordered_map<AccountID, std::unordered_set<LedgerKey>> bySeller;
+
+        void add(std::shared_ptr<LedgerEntry const> const& offer);
+        void remove(LedgerKey const& key);
+    };
+
     Database& mDatabase;
     std::unique_ptr<LedgerHeader> mHeader;
     mutable EntryCache mEntryCache;
     mutable BestOffersCache mBestOffersCache;
     mutable uint64_t mPrefetchHits{0};
     mutable uint64_t mPrefetchMisses{0};
+    mutable std::map<LedgerEntryType, EntryCacheStats> mEntryCacheStats;
+    mutable size_t mEntriesCachedSinceCommit{0};
+
+    // When mInMemoryOrderBook is set, offers are served from mOrderBook
+    // rather than from the database and mBestOffersCache. mOrderBook is
+    // loaded on first use and kept up to date by commitChild, while the other
+    // operations that modify offers in the database discard it.
+    bool const mInMemoryOrderBook;
+    mutable std::unique_ptr<InMemoryOrderBook> mOrderBook;
 
     size_t mMaxCacheSize;
     size_t mBulkLoadBatchSize;
     std::unique_ptr<soci::transaction> mTransaction;
     AbstractLedgerTxn* mChild;
+    // Counts the children added so far. The database only changes when a
+    // child commits or while there is no child, so entries loaded while the
+    // same child exists are still current.
+    uint64_t mChildGeneration{0};
 
     void throwIfChild() const;
 
@@ -709,6 +768,14 @@ class LedgerTxnRoot::Impl
     void bulkUpsertAccountData(std::vector<EntryIterator> const& entries);
     void bulkDeleteAccountData(std::vector<EntryIterator> const& entries,
                                LedgerTxnConsistency cons);
+    void bulkInsertAccounts(soci::session& session,
+                            std::vector<LedgerEntry> const& entries);
+    void bulkInsertTrustLines(soci::session& session,
+                              std::vector<LedgerEntry> const& entries);
+    void bulkInsertOffers(soci::session& session,
+                          std::vector<LedgerEntry> const& entries);
+    void bulkInsertAccountData(soci::session& session,
+                               std::vector<LedgerEntry> const& entries);
 
     static std::string tableFromLedgerEntryType(LedgerEntryType let);
 
@@ -720,7 +787,10 @@ class LedgerTxnRoot::Impl
     //    database operations are SELECTs, which only populate the cache
     //    with fresh data from the DB.
     //
-    //  - On LedgerTxnRoot::commitChild, the cache is cleared.
+    //  - On LedgerTxnRoot::commitChild, every committed entry that the
+    //    cache holds is replaced by its committed version (or by nullptr if
+    //    it was erased), after the database commit succeeded. If that fails,
+    //    the cache is cleared.
     //
     //  - It is therefore always kept in exact correspondence with the
     //    database for the keyset that it has entries for. It's a precise
@@ -734,19 +804,32 @@ class LedgerTxnRoot::Impl
     BestOffersCacheEntryPtr getFromBestOffersCache(Asset const& buying,
                                                    Asset const& selling) const;
 
+    InMemoryOrderBook& loadOrderBook() const;
+    void prefetchSellers(InMemoryOrderBook::Offers::const_iterator iter,
+                         InMemoryOrderBook::Offers::const_iterator const& end);
+
+    // The bulk loads only use `session` and const members that never change,
+    // so that they can run on other threads with a session of the pool.
+    std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
+    bulkLoadAccounts(soci::session& session,
+                     std::unordered_set<LedgerKey> const& keys) const;
     std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
-    bulkLoadAccounts(std::unordered_set<LedgerKey> const& keys) const;
+    bulkLoadTrustLines(soci::session& session,
+                       std::unordered_set<LedgerKey> const& keys) const;
     std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
-    bulkLoadTrustLines(std::unordered_set<LedgerKey> const& keys) const;
+    bulkLoadOffers(soci::session& session,
+                   std::unordered_set<LedgerKey> const& keys) const;
     std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
-    bulkLoadOffers(std::unordered_set<LedgerKey> const& keys) const;
+    bulkLoadData(soci::session& session,
+                 std::unordered_set<LedgerKey> const& keys) const;
     std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
-    bulkLoadData(std::unordered_set<LedgerKey> const& keys) const;
+    bulkLoad(soci::session& session,
+             std::unordered_set<LedgerKey> const& keys) const;
 
   public:
     // Constructor has the strong exception safety guarantee
     Impl(Database& db, size_t entryCacheSize, size_t bestOfferCacheSize,
-         size_t prefetchBatchSize);
+         size_t prefetchBatchSize, bool inMemoryOrderBook);
 
     ~Impl();
 
@@ -771,6 +854,19 @@ class LedgerTxnRoot::Impl
     void dropOffers();
     void dropTrustLines();
 
+    // bulkInsertEntries has no exception safety guarantees. It does not touch
+    // the caches, so it can be called from worker threads.
+    void bulkInsertEntries(soci::session& session,
+                           std::vector<LedgerEntry> const& entries);
+
+    // dropSecondaryIndexes and createSecondaryIndexes have no exception
+    // safety guarantees.
+    void dropSecondaryIndexes();
+    void createSecondaryIndexes();
+
+    // clearCaches does not throw.
+    void clearCaches();
+
 #ifdef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
     void resetForFuzzer();
 #endif // FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
@@ -824,11 +920,13 @@ class LedgerTxnRoot::Impl
     void rollbackChild();
 
     // Prefetch some or all of given keys in batches. Note that no prefetching
-    // could occur if the cache is at its fill ratio. Returns number of keys
-    // prefetched.
+    // could occur if the entries cached since the last commit already reach
+    // the fill ratio of the cache. Returns number of keys prefetched.
     uint32_t prefetch(std::unordered_set<LedgerKey> const& keys);
 
     double getPrefetchHitRate() const;
+
+    std::map<LedgerEntryType, EntryCacheStats> getEntryCacheStats() const;
 };
 
 #ifdef USE_POSTGRES
@@ -886,5 +984,106 @@ marshalToPGArray(PGconn* conn, std::string& out, const std::vector<T>& v,
     oss << '}';
     out = oss.str();
 }
+
+template <typename T>
+inline void
+marshalToPGCopyItem(std::ostringstream& oss, const T& item)
+{
+    // See marshalToPGArrayItem
+    oss << std::setprecision(std::numeric_limits<T>::max_digits10) << item;
+}
+
+template <>
+inline void
+marshalToPGCopyItem<std::string>(std::ostringstream& oss,
+                                 const std::string& item)
+{
+    for (char c : item)
+    {
+        switch (c)
+        {
+        case '\\':
+            oss << "\\\\";
+            break;
+        case '\t':
+            oss << "\\t";
+            break;
+        case '\n':
+            oss << "\\n";
+            break;
+        case '\r':
+            oss << "\\r";
+            break;
+        default:
+            oss << c;
+        }
+    }
+}
+
+// Accumulates rows in the text format of `COPY ... FROM STDIN`, which loads
+// rows into a table much faster than INSERT statements, and sends them.
+class PGCopyRows
+{
+    std::ostringstream mRows;
+    bool mStartOfRow{true};
+
+  public:
+    template <typename T>
+    void
+    add(const T& item, soci::indicator ind = soci::i_ok)
+    {
+        if (!mStartOfRow)
+        {
+            mRows << '\t';
+        }
+        mStartOfRow = false;
+        if (ind == soci::i_null)
+        {
+            mRows << "\\N";
+        }
+        else
+        {
+            marshalToPGCopyItem(mRows, item);
+        }
+    }
+
+    void
+    endRow()
+    {
+        mRows << '\n';
+        mStartOfRow = true;
+    }
+
+    // Copies the rows to `target`, a table name followed by its columns.
+    void copyTo(PGconn* conn, std::string const& target);
+};
 #endif
+
+// Runs the bulk upsert operation `Op` as an insert of entries that are not in
+// the database yet: through COPY on postgres, and as the upsert itself on
+// sqlite (where only the main session can be used).
+template <typename Op>
+class BulkInsertOperation : public DatabaseTypeSpecificOperation<void>
+{
+    Op& mOp;
+
+  public:
+    explicit BulkInsertOperation(Op& op) : mOp(op)
+    {
+    }
+
+    void
+    doSqliteSpecificOperation(soci::sqlite3_session_backend* sq) override
+    {
+        mOp.doSqliteSpecificOperation(sq);
+    }
+
+#ifdef USE_POSTGRES
+    void
+    doPostgresSpecificOperation(soci::postgresql_session_backend* pg) override
+    {
+        mOp.doPostgresCopy(pg->conn_);
+    }
+#endif
+};
 }
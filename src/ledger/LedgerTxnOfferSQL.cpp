@@ -513,6 +513,29 @@ class BulkUpsertOffersOperation : public DatabaseTypeSpecificOperation<void>
             throw std::runtime_error("Could not update data in SQL");
         }
     }
+
+    void
+    doPostgresCopy(PGconn* conn)
+    {
+        PGCopyRows rows;
+        for (size_t i = 0; i < mOfferIDs.size(); ++i)
+        {
+            rows.add(mSellerIDs[i]);
+            rows.add(mOfferIDs[i]);
+            rows.add(mSellingAssets[i]);
+            rows.add(mBuyingAssets[i]);
+            rows.add(mAmounts[i]);
+            rows.add(mPriceNs[i]);
+            rows.add(mPriceDs[i]);
+            rows.add(mPrices[i]);
+            rows.add(mFlags[i]);
+            rows.add(mLastModifieds[i]);
+            rows.endRow();
+        }
+        rows.copyTo(conn, "offers (sellerid, offerid, sellingasset, "
+                          "buyingasset, amount, pricen, priced, price, flags, "
+                          "lastmodified)");
+    }
 #endif
 };
 
@@ -597,6 +620,15 @@ LedgerTxnRoot::Impl::bulkUpsertOffers(std::vector<EntryIterator> const& entries)
     mDatabase.doDatabaseTypeSpecificOperation(op);
 }
 
+void
+LedgerTxnRoot::Impl::bulkInsertOffers(soci::session& session,
+                                      std::vector<LedgerEntry> const& entries)
+{
+    BulkUpsertOffersOperation op(mDatabase, entries);
+    BulkInsertOperation<BulkUpsertOffersOperation> insertOp(op);
+    mDatabase.doDatabaseTypeSpecificOperation(session, insertOp);
+}
+
 void
 LedgerTxnRoot::Impl::bulkDeleteOffers(std::vector<EntryIterator> const& entries,
                                       LedgerTxnConsistency cons)
@@ -611,6 +643,7 @@ LedgerTxnRoot::Impl::dropOffers()
     throwIfChild();
     mEntryCache.clear();
     mBestOffersCache.clear();
+    mOrderBook.reset();
 
     std::string coll = mDatabase.getSimpleCollationClause();
 
@@ -630,14 +663,28 @@ LedgerTxnRoot::Impl::dropOffers()
            "lastmodified     INT              NOT NULL,"
            "PRIMARY KEY      (offerid)"
            ");";
-    mDatabase.getSession() << "CREATE INDEX bestofferindex ON offers "
-                              "(sellingasset,buyingasset,price);";
+    LedgerTxnRoot::setBestOfferIndex(mDatabase.getSession(), true);
+}
+
+void
+LedgerTxnRoot::setBestOfferIndex(soci::session& session, bool exists)
+{
+    if (exists)
+    {
+        session << "CREATE INDEX IF NOT EXISTS bestofferindex ON offers "
+                   "(sellingasset,buyingasset,price,offerid);";
+    }
+    else
+    {
+        session << "DROP INDEX IF EXISTS bestofferindex;";
+    }
 }
 
 class BulkLoadOffersOperation
     : public DatabaseTypeSpecificOperation<std::vector<LedgerEntry>>
 {
     Database& mDb;
+    soci::session& mSession;
     std::vector<int64_t> mOfferIDs;
     std::unordered_map<int64_t, AccountID> mSellerIDsByOfferID;
 
@@ -697,9 +744,9 @@ class BulkLoadOffersOperation
     }
 
   public:
-    BulkLoadOffersOperation(Database& db,
+    BulkLoadOffersOperation(Database& db, soci::session& session,
                             std::unordered_set<LedgerKey> const& keys)
-        : mDb(db)
+        : mDb(db), mSession(session)
     {
         mOfferIDs.reserve(keys.size());
         for (auto const& k : keys)
@@ -721,7 +768,7 @@ class BulkLoadOffersOperation
             "amount, pricen, priced, flags, lastmodified "
             "FROM offers WHERE offerid IN carray(?, ?, 'int64')";
 
-        auto prep = mDb.getPreparedStatement(sql);
+        auto prep = mDb.getPreparedStatement(sql, mSession);
         auto be = prep.statement().get_backend();
         if (be == nullptr)
         {
@@ -749,7 +796,7 @@ class BulkLoadOffersOperation
             "SELECT sellerid, offerid, sellingasset, buyingasset, "
             "amount, pricen, priced, flags, lastmodified "
             "FROM offers WHERE offerid IN (SELECT * FROM r)";
-        auto prep = mDb.getPreparedStatement(sql);
+        auto prep = mDb.getPreparedStatement(sql, mSession);
         auto& st = prep.statement();
         st.exchange(soci::use(strOfferIDs));
         return executeAndFetch(st);
@@ -759,13 +806,13 @@ class BulkLoadOffersOperation
 
 std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
 LedgerTxnRoot::Impl::bulkLoadOffers(
-    std::unordered_set<LedgerKey> const& keys) const
+    soci::session& session, std::unordered_set<LedgerKey> const& keys) const
 {
     if (!keys.empty())
     {
-        BulkLoadOffersOperation op(mDatabase, keys);
+        BulkLoadOffersOperation op(mDatabase, session, keys);
         return populateLoadedEntries(
-            keys, mDatabase.doDatabaseTypeSpecificOperation(op));
+            keys, mDatabase.doDatabaseTypeSpecificOperation(session, op));
     }
     else
     {
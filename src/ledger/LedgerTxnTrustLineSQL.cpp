@@ -110,56 +110,77 @@ class BulkUpsertTrustLinesOperation : public DatabaseTypeSpecificOperation<void>
     std::vector<int64_t> mSellingLiabilities;
     std::vector<soci::indicator> mLiabilitiesInds;
 
+    void
+    accumulateEntry(LedgerEntry const& entry)
+    {
+        assert(entry.data.type() == TRUSTLINE);
+        auto const& tl = entry.data.trustLine();
+        std::string accountIDStr, issuerStr, assetCodeStr;
+        getTrustLineStrings(tl.accountID, tl.asset, accountIDStr, issuerStr,
+                            assetCodeStr);
+
+        mAccountIDs.emplace_back(accountIDStr);
+        mAssetTypes.emplace_back(
+            unsignedToSigned(static_cast<uint32_t>(tl.asset.type())));
+        mIssuers.emplace_back(issuerStr);
+        mAssetCodes.emplace_back(assetCodeStr);
+        mTlimits.emplace_back(tl.limit);
+        mBalances.emplace_back(tl.balance);
+        mFlags.emplace_back(unsignedToSigned(tl.flags));
+        mLastModifieds.emplace_back(
+            unsignedToSigned(entry.lastModifiedLedgerSeq));
+
+        if (tl.ext.v() >= 1)
+        {
+            mBuyingLiabilities.emplace_back(tl.ext.v1().liabilities.buying);
+            mSellingLiabilities.emplace_back(tl.ext.v1().liabilities.selling);
+            mLiabilitiesInds.emplace_back(soci::i_ok);
+        }
+        else
+        {
+            mBuyingLiabilities.emplace_back(0);
+            mSellingLiabilities.emplace_back(0);
+            mLiabilitiesInds.emplace_back(soci::i_null);
+        }
+    }
+
+    void
+    reserve(size_t n)
+    {
+        mAccountIDs.reserve(n);
+        mAssetTypes.reserve(n);
+        mIssuers.reserve(n);
+        mAssetCodes.reserve(n);
+        mTlimits.reserve(n);
+        mBalances.reserve(n);
+        mFlags.reserve(n);
+        mLastModifieds.reserve(n);
+        mBuyingLiabilities.reserve(n);
+        mSellingLiabilities.reserve(n);
+        mLiabilitiesInds.reserve(n);
+    }
+
   public:
     BulkUpsertTrustLinesOperation(Database& DB,
-                                  std::vector<EntryIterator> const& entries)
+                                  std::vector<LedgerEntry> const& entries)
         : mDB(DB)
     {
-        mAccountIDs.reserve(entries.size());
-        mAssetTypes.reserve(entries.size());
-        mIssuers.reserve(entries.size());
-        mAssetCodes.reserve(entries.size());
-        mTlimits.reserve(entries.size());
-        mBalances.reserve(entries.size());
-        mFlags.reserve(entries.size());
-        mLastModifieds.reserve(entries.size());
-        mBuyingLiabilities.reserve(entries.size());
-        mSellingLiabilities.reserve(entries.size());
-        mLiabilitiesInds.reserve(entries.size());
+        reserve(entries.size());
+        for (auto const& e : entries)
+        {
+            accumulateEntry(e);
+        }
+    }
 
+    BulkUpsertTrustLinesOperation(Database& DB,
+                                  std::vector<EntryIterator> const& entries)
+        : mDB(DB)
+    {
+        reserve(entries.size());
         for (auto const& e : entries)
         {
             assert(e.entryExists());
-            assert(e.entry().data.type() == TRUSTLINE);
-            auto const& tl = e.entry().data.trustLine();
-            std::string accountIDStr, issuerStr, assetCodeStr;
-            getTrustLineStrings(tl.accountID, tl.asset, accountIDStr, issuerStr,
-                                assetCodeStr);
-
-            mAccountIDs.emplace_back(accountIDStr);
-            mAssetTypes.emplace_back(
-                unsignedToSigned(static_cast<uint32_t>(tl.asset.type())));
-            mIssuers.emplace_back(issuerStr);
-            mAssetCodes.emplace_back(assetCodeStr);
-            mTlimits.emplace_back(tl.limit);
-            mBalances.emplace_back(tl.balance);
-            mFlags.emplace_back(unsignedToSigned(tl.flags));
-            mLastModifieds.emplace_back(
-                unsignedToSigned(e.entry().lastModifiedLedgerSeq));
-
-            if (tl.ext.v() >= 1)
-            {
-                mBuyingLiabilities.emplace_back(tl.ext.v1().liabilities.buying);
-                mSellingLiabilities.emplace_back(
-                    tl.ext.v1().liabilities.selling);
-                mLiabilitiesInds.emplace_back(soci::i_ok);
-            }
-            else
-            {
-                mBuyingLiabilities.emplace_back(0);
-                mSellingLiabilities.emplace_back(0);
-                mLiabilitiesInds.emplace_back(soci::i_null);
-            }
+            accumulateEntry(e.entry());
         }
     }
 
@@ -281,6 +302,29 @@ class BulkUpsertTrustLinesOperation : public DatabaseTypeSpecificOperation<void>
             throw std::runtime_error("Could not update data in SQL");
         }
     }
+
+    void
+    doPostgresCopy(PGconn* conn)
+    {
+        PGCopyRows rows;
+        for (size_t i = 0; i < mAccountIDs.size(); ++i)
+        {
+            rows.add(mAccountIDs[i]);
+            rows.add(mAssetTypes[i]);
+            rows.add(mIssuers[i]);
+            rows.add(mAssetCodes[i]);
+            rows.add(mTlimits[i]);
+            rows.add(mBalances[i]);
+            rows.add(mFlags[i]);
+            rows.add(mLastModifieds[i]);
+            rows.add(mBuyingLiabilities[i], mLiabilitiesInds[i]);
+            rows.add(mSellingLiabilities[i], mLiabilitiesInds[i]);
+            rows.endRow();
+        }
+        rows.copyTo(conn, "trustlines (accountid, assettype, issuer, "
+                          "assetcode, tlimit, balance, flags, lastmodified, "
+                          "buyingliabilities, sellingliabilities)");
+    }
 #endif
 };
 
@@ -385,6 +429,15 @@ LedgerTxnRoot::Impl::bulkUpsertTrustLines(
     mDatabase.doDatabaseTypeSpecificOperation(op);
 }
 
+void
+LedgerTxnRoot::Impl::bulkInsertTrustLines(
+    soci::session& session, std::vector<LedgerEntry> const& entries)
+{
+    BulkUpsertTrustLinesOperation op(mDatabase, entries);
+    BulkInsertOperation<BulkUpsertTrustLinesOperation> insertOp(op);
+    mDatabase.doDatabaseTypeSpecificOperation(session, insertOp);
+}
+
 void
 LedgerTxnRoot::Impl::bulkDeleteTrustLines(
     std::vector<EntryIterator> const& entries, LedgerTxnConsistency cons)
@@ -424,6 +477,7 @@ class BulkLoadTrustLinesOperation
     : public DatabaseTypeSpecificOperation<std::vector<LedgerEntry>>
 {
     Database& mDb;
+    soci::session& mSession;
     std::vector<std::string> mAccountIDs;
     std::vector<std::string> mIssuers;
     std::vector<std::string> mAssetCodes;
@@ -496,9 +550,9 @@ class BulkLoadTrustLinesOperation
     }
 
   public:
-    BulkLoadTrustLinesOperation(Database& db,
+    BulkLoadTrustLinesOperation(Database& db, soci::session& session,
                                 std::unordered_set<LedgerKey> const& keys)
-        : mDb(db)
+        : mDb(db), mSession(session)
     {
         mAccountIDs.reserve(keys.size());
         mIssuers.reserve(keys.size());
@@ -562,7 +616,7 @@ class BulkLoadTrustLinesOperation
             "sellingliabilities "
             "FROM trustlines WHERE (accountid, issuer, assetcode) IN r";
 
-        auto prep = mDb.getPreparedStatement(sql);
+        auto prep = mDb.getPreparedStatement(sql, mSession);
         auto be = prep.statement().get_backend();
         if (be == nullptr)
         {
@@ -601,7 +655,8 @@ class BulkLoadTrustLinesOperation
             "unnest(:v3::TEXT[])) SELECT accountid, assettype, assetcode, "
             "issuer, tlimit, balance, flags, lastmodified, buyingliabilities, "
             "sellingliabilities FROM trustlines "
-            "WHERE (accountid, issuer, assetcode) IN (SELECT * FROM r)");
+            "WHERE (accountid, issuer, assetcode) IN (SELECT * FROM r)",
+            mSession);
         auto& st = prep.statement();
         st.exchange(soci::use(strAccountIDs));
         st.exchange(soci::use(strIssuers));
@@ -613,13 +668,13 @@ class BulkLoadTrustLinesOperation
 
 std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry const>>
 LedgerTxnRoot::Impl::bulkLoadTrustLines(
-    std::unordered_set<LedgerKey> const& keys) const
+    soci::session& session, std::unordered_set<LedgerKey> const& keys) const
 {
     if (!keys.empty())
     {
-        BulkLoadTrustLinesOperation op(mDatabase, keys);
+        BulkLoadTrustLinesOperation op(mDatabase, session, keys);
         return populateLoadedEntries(
-            keys, mDatabase.doDatabaseTypeSpecificOperation(op));
+            keys, mDatabase.doDatabaseTypeSpecificOperation(session, op));
     }
     else
     {
@@ -0,0 +1,110 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "ledger/LookaheadPrefetcher.h"
+#include "main/Application.h"
+#include "main/Config.h"
+#include "util/Logging.h"
+
+namespace stellar
+{
+
+LookaheadPrefetcher::LookaheadPrefetcher(
+    Application& app, LedgerTxnRoot& root,
+    std::vector<TransactionFrameBasePtr> const& txs)
+    : mApp(app)
+    , mRoot(root)
+    , mTxs(txs)
+    , mGroupSize(app.getConfig().PREFETCH_LOOKAHEAD)
+{
+}
+
+LookaheadPrefetcher::~LookaheadPrefetcher()
+{
+    // A background load that started uses mRoot
+    if (mNextGroup.valid() && mNextGroupClaimed->exchange(true))
+    {
+        mNextGroup.wait();
+    }
+}
+
+std::unordered_set<LedgerKey>
+LookaheadPrefetcher::getKeys(size_t begin) const
+{
+    std::unordered_set<LedgerKey> keys;
+    auto end = std::min(begin + mGroupSize, mTxs.size());
+    for (size_t i = begin; i < end; ++i)
+    {
+        mTxs[i]->insertKeysForTxApply(keys);
+    }
+    return keys;
+}
+
+void
+LookaheadPrefetcher::beforeApply(size_t index)
+{
+    if (index % mGroupSize != 0)
+    {
+        return;
+    }
+
+    bool prefetched = false;
+    if (mNextGroup.valid())
+    {
+        // Only wait for a load that a worker already started: if none did,
+        // loading the group here is quicker than waiting for a worker
+        if (mNextGroupClaimed->exchange(true))
+        {
+            try
+            {
+                mRoot.cachePrefetched(mNextGroup.get());
+                prefetched = true;
+                ++mBackgroundLoads;
+            }
+            catch (std::exception& e)
+            {
+                CLOG(WARNING, "Ledger")
+                    << "Background prefetch failed: " << e.what();
+            }
+        }
+        mNextGroup = std::future<PrefetchedEntries>();
+        mNextGroupClaimed.reset();
+    }
+    if (!prefetched)
+    {
+        mRoot.prefetch(getKeys(index));
+        ++mSynchronousLoads;
+    }
+
+    if (index + mGroupSize < mTxs.size())
+    {
+        auto load = mRoot.makeAsyncPrefetch(getKeys(index + mGroupSize));
+#ifdef BUILD_TESTS
+        if (load && mFailBackgroundLoads)
+        {
+            load = []() -> PrefetchedEntries {
+                throw std::runtime_error("failing for testing");
+            };
+        }
+#endif
+        if (load)
+        {
+            auto task =
+                std::make_shared<std::packaged_task<PrefetchedEntries()>>(
+                    std::move(load));
+            auto claimed = std::make_shared<std::atomic<bool>>(false);
+            mNextGroup = task->get_future();
+            mNextGroupClaimed = claimed;
+            mApp.postOnBackgroundThread(
+                [task, claimed]() {
+                    if (!claimed->exchange(true))
+                    {
+                        (*task)();
+                    }
+                },
+                "LedgerManager: prefetch");
+        }
+    }
+}
+}
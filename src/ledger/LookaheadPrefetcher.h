@@ -0,0 +1,81 @@
+#pragma once
+
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "ledger/LedgerTxn.h"
+#include "transactions/TransactionFrameBase.h"
+#include "util/NonCopyable.h"
+
+#include <atomic>
+#include <future>
+#include <vector>
+
+namespace stellar
+{
+
+class Application;
+
+// Prefetches the entries used by a sequence of transactions by groups of
+// PREFETCH_LOOKAHEAD transactions: while a group applies, the entries of the
+// next one are loaded on a background thread, through a connection of the
+// database pool. A group whose background load failed, or had not started by
+// the time the group applies (when all workers are busy), is prefetched
+// synchronously instead.
+class LookaheadPrefetcher : NonMovableOrCopyable
+{
+    Application& mApp;
+    LedgerTxnRoot& mRoot;
+    std::vector<TransactionFrameBasePtr> const& mTxs;
+    size_t const mGroupSize;
+    std::future<PrefetchedEntries> mNextGroup;
+    // Set by whoever takes the background load of the next group first: the
+    // worker that runs it, or beforeApply, which then loads the group itself
+    std::shared_ptr<std::atomic<bool>> mNextGroupClaimed;
+    size_t mBackgroundLoads{0};
+    size_t mSynchronousLoads{0};
+#ifdef BUILD_TESTS
+    bool mFailBackgroundLoads{false};
+#endif
+
+    std::unordered_set<LedgerKey> getKeys(size_t begin) const;
+
+  public:
+    LookaheadPrefetcher(Application& app, LedgerTxnRoot& root,
+                        std::vector<TransactionFrameBasePtr> const& txs);
+    ~LookaheadPrefetcher();
+
+    // Must be called before applying the transaction at `index`, with the
+    // child of the root that applies the transactions
+    void beforeApply(size_t index);
+
+    // Number of groups prefetched in the background and synchronously
+    size_t
+    getBackgroundLoads() const
+    {
+        return mBackgroundLoads;
+    }
+    size_t
+    getSynchronousLoads() const
+    {
+        return mSynchronousLoads;
+    }
+
+#ifdef BUILD_TESTS
+    void
+    failBackgroundLoadsForTesting()
+    {
+        mFailBackgroundLoads = true;
+    }
+
+    // Whether the background load of the next group was posted and no worker
+    // started it yet
+    bool
+    isNextGroupPendingForTesting() const
+    {
+        return mNextGroupClaimed && !*mNextGroupClaimed;
+    }
+#endif
+};
+}
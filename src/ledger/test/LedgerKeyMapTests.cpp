@@ -0,0 +1,187 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "ledger/LedgerKeyMap.h"
+#include "ledger/test/LedgerTestUtils.h"
+#include "lib/catch.hpp"
+#include "util/Logging.h"
+#include "util/Math.h"
+#include "util/types.h"
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace stellar;
+
+namespace
+{
+std::vector<LedgerKey>
+generateKeys(size_t n)
+{
+    std::unordered_set<LedgerKey> keys;
+    while (keys.size() < n)
+    {
+        keys.emplace(
+            LedgerEntryKey(LedgerTestUtils::generateValidLedgerEntry(1)));
+    }
+    return std::vector<LedgerKey>(keys.begin(), keys.end());
+}
+
+template <typename Map>
+void
+checkSame(Map const& map, std::unordered_map<LedgerKey, int> const& expected)
+{
+    REQUIRE(map.size() == expected.size());
+    REQUIRE(map.empty() == expected.empty());
+    size_t n = 0;
+    for (auto const& kv : map)
+    {
+        auto iter = expected.find(kv.first);
+        REQUIRE(iter != expected.end());
+        REQUIRE(iter->second == kv.second);
+        ++n;
+    }
+    REQUIRE(n == expected.size());
+}
+}
+
+TEST_CASE("LedgerKeyMap behaves like std::unordered_map", "[ledgerkeymap]")
+{
+    auto keys = generateKeys(500);
+    LedgerKeyMap<int> map;
+    std::unordered_map<LedgerKey, int> expected;
+
+    REQUIRE(map.begin() == map.end());
+    REQUIRE(map.find(keys[0]) == map.end());
+    REQUIRE(map.erase(keys[0]) == 0);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        auto const& key = rand_element(keys);
+        switch (rand_uniform(0, 3))
+        {
+        case 0:
+            REQUIRE(map.erase(key) == expected.erase(key));
+            break;
+        case 1:
+        {
+            auto iter = map.find(key);
+            REQUIRE((iter != map.end()) == (expected.count(key) == 1));
+            if (iter != map.end())
+            {
+                REQUIRE(iter->first == key);
+                REQUIRE(iter->second == expected[key]);
+                map.erase(iter);
+                expected.erase(key);
+            }
+            break;
+        }
+        case 2:
+            map[key] = i;
+            expected[key] = i;
+            break;
+        case 3:
+        {
+            auto res = map.emplace(key, i);
+            auto expectedRes = expected.emplace(key, i);
+            REQUIRE(res.second == expectedRes.second);
+            REQUIRE(res.first->second == expectedRes.first->second);
+            break;
+        }
+        }
+        REQUIRE(map.size() == expected.size());
+    }
+    checkSame(map, expected);
+
+    SECTION("copy")
+    {
+        auto copy = map;
+        checkSame(copy, expected);
+        map.clear();
+        checkSame(copy, expected);
+        REQUIRE(map.empty());
+        REQUIRE(map.begin() == map.end());
+    }
+
+    SECTION("swap")
+    {
+        LedgerKeyMap<int> other;
+        other.swap(map);
+        checkSame(other, expected);
+        checkSame(map, {});
+    }
+
+    SECTION("mutate through iterator")
+    {
+        for (auto iter = map.begin(); iter != map.end(); ++iter)
+        {
+            ++iter.value();
+        }
+        for (auto& kv : expected)
+        {
+            ++kv.second;
+        }
+        checkSame(map, expected);
+    }
+
+    SECTION("erase everything")
+    {
+        for (auto const& key : keys)
+        {
+            map.erase(key);
+        }
+        checkSame(map, {});
+        for (auto const& key : keys)
+        {
+            map.emplace(key, 0);
+        }
+        REQUIRE(map.size() == keys.size());
+    }
+}
+
+TEST_CASE("LedgerKeyMap performance benchmark", "[!hide][ledgerkeymapbench]")
+{
+    // Mixes lookups, insertions and erasures over a fixed set of keys, as a
+    // LedgerTxn does when loading and recording entries.
+    auto runTest = [](auto map, std::string const& name,
+                      std::vector<LedgerKey> const& keys) {
+        size_t const numLookups = 1000000;
+
+        auto start = std::chrono::steady_clock::now();
+        size_t found = 0;
+        for (size_t i = 0; i < numLookups; ++i)
+        {
+            auto const& key = keys[i % keys.size()];
+            if (map.find(key) == map.end())
+            {
+                map.emplace(key, nullptr);
+            }
+            else
+            {
+                ++found;
+                if (i % 3 == 0)
+                {
+                    map.erase(key);
+                }
+            }
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        auto ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+
+        REQUIRE(found > 0);
+        CLOG(INFO, "Ledger") << "benchmark " << name << " with " << keys.size()
+                             << " keys: " << ns.count() / numLookups
+                             << " ns per lookup";
+    };
+
+    for (size_t size : {10, 1000, 100000})
+    {
+        auto keys = generateKeys(size);
+        runTest(std::unordered_map<LedgerKey, std::shared_ptr<LedgerEntry>>(),
+                "std::unordered_map", keys);
+        runTest(LedgerKeyMap<std::shared_ptr<LedgerEntry>>(), "LedgerKeyMap",
+                keys);
+    }
+}
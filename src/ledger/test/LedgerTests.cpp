@@ -3,13 +3,24 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "ledger/LedgerManager.h"
+#include "crypto/SecretKey.h"
+#include "herder/LedgerCloseData.h"
 #include "ledger/LedgerTxn.h"
 #include "main/Application.h"
+#include "test/TestAccount.h"
+#include "test/TestUtils.h"
+#include "test/TxTests.h"
 #include "test/test.h"
+#include "transactions/TransactionSQL.h"
+#include "util/Logging.h"
+#include "util/format.h"
 
 #include <lib/catch.hpp>
+#include <medida/metrics_registry.h>
+#include <medida/timer.h>
 
 using namespace stellar;
+using namespace stellar::txtest;
 
 TEST_CASE("cannot close ledger with unsupported ledger version", "[ledger]")
 {
@@ -43,3 +54,133 @@ TEST_CASE("cannot close ledger with unsupported ledger version", "[ledger]")
     }
     REQUIRE_THROWS_AS(applyEmptyLedger(), std::runtime_error);
 }
+
+TEST_CASE("verifying transactions on workers before apply", "[ledger]")
+{
+    struct CloseResult
+    {
+        TransactionResultSet mResults;
+        Hash mLclHash;
+        uint64_t mSigCacheHits;
+        int64_t mPreverifyCount;
+    };
+
+    // Applies the same payments with and without workers verifying their
+    // signatures first, which must not change anything about the ledger.
+    auto closeWithPayments = [](int verifyThreads) {
+        // worker threads run in real time
+        VirtualClock clock(VirtualClock::REAL_TIME);
+        auto cfg = getTestConfig(0);
+        cfg.APPLY_VERIFY_THREADS = verifyThreads;
+        auto app = createTestApplication(clock, cfg);
+
+        auto& lm = app->getLedgerManager();
+        auto root = TestAccount::createRoot(*app);
+        std::vector<TestAccount> accounts;
+        for (int i = 0; i < 10; ++i)
+        {
+            accounts.emplace_back(root.create(fmt::format("A{}", i),
+                                              lm.getLastMinBalance(2)));
+        }
+
+        // Not checking the set before closing the ledger, so that only
+        // closing it verifies the signatures
+        auto const& lcl = lm.getLastClosedLedgerHeader();
+        auto txSet = std::make_shared<TxSetFrame>(lcl.hash);
+        for (size_t i = 0; i < accounts.size(); ++i)
+        {
+            auto& to = accounts[(i + 1) % accounts.size()];
+            txSet->add(accounts[i].tx({payment(to, 100)}));
+        }
+        txSet->sortForHash();
+        StellarValue sv(txSet->getContentsHash(),
+                        lcl.header.scpValue.closeTime + 1, emptyUpgradeSteps,
+                        STELLAR_VALUE_BASIC);
+        LedgerCloseData ledgerData(lcl.header.ledgerSeq + 1, txSet, sv);
+
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        PubKeyUtils::clearVerifySigCache();
+        PubKeyUtils::flushVerifySigCacheCounts(hits, misses);
+        lm.closeLedger(ledgerData);
+        PubKeyUtils::flushVerifySigCacheCounts(hits, misses);
+
+        CloseResult res;
+        res.mResults = getTransactionHistoryResults(app->getDatabase(),
+                                                    ledgerData.getLedgerSeq());
+        for (auto const& r : res.mResults.results)
+        {
+            REQUIRE(r.result.result.code() == txSUCCESS);
+        }
+        res.mLclHash = lm.getLastClosedLedgerHeader().hash;
+        res.mSigCacheHits = hits;
+        res.mPreverifyCount =
+            app->getMetrics()
+                .NewTimer({"ledger", "transaction", "preverify"})
+                .count();
+        return res;
+    };
+
+    auto serial = closeWithPayments(0);
+    REQUIRE(serial.mResults.results.size() == 10);
+    REQUIRE(serial.mPreverifyCount == 0);
+
+    auto preverified = closeWithPayments(3);
+    REQUIRE(preverified.mResults == serial.mResults);
+    REQUIRE(preverified.mLclHash == serial.mLclHash);
+    REQUIRE(preverified.mPreverifyCount == 1);
+    // every signature checked by apply was verified beforehand
+    REQUIRE(preverified.mSigCacheHits >=
+            serial.mSigCacheHits + preverified.mResults.results.size());
+}
+
+TEST_CASE("verifying transactions on workers before apply benchmark",
+          "[!hide][preverifybench]")
+{
+    // Closes ledgers full of payments, as replaying history does, with and
+    // without workers verifying their signatures first
+    auto closeLedgers = [](int verifyThreads) {
+        VirtualClock clock(VirtualClock::REAL_TIME);
+        auto cfg = getTestConfig(0, Config::TESTDB_ON_DISK_SQLITE);
+        cfg.APPLY_VERIFY_THREADS = verifyThreads;
+        cfg.WORKER_THREADS = std::max(cfg.WORKER_THREADS, verifyThreads);
+        auto app = createTestApplication(clock, cfg);
+
+        auto& lm = app->getLedgerManager();
+        auto root = TestAccount::createRoot(*app);
+        std::vector<TestAccount> accounts;
+        for (int i = 0; i < 1000; ++i)
+        {
+            accounts.emplace_back(root.create(fmt::format("A{}", i),
+                                              lm.getLastMinBalance(2)));
+        }
+
+        auto& close = app->getMetrics().NewTimer({"ledger", "ledger", "close"});
+        close.Clear();
+        for (int ledger = 0; ledger < 10; ++ledger)
+        {
+            auto const& lcl = lm.getLastClosedLedgerHeader();
+            auto txSet = std::make_shared<TxSetFrame>(lcl.hash);
+            for (size_t i = 0; i < accounts.size(); ++i)
+            {
+                auto& to = accounts[(i + 1) % accounts.size()];
+                txSet->add(accounts[i].tx({payment(to, 100)}));
+            }
+            txSet->sortForHash();
+            StellarValue sv(txSet->getContentsHash(),
+                            lcl.header.scpValue.closeTime + 1,
+                            emptyUpgradeSteps, STELLAR_VALUE_BASIC);
+            PubKeyUtils::clearVerifySigCache();
+            lm.closeLedger(
+                LedgerCloseData(lcl.header.ledgerSeq + 1, txSet, sv));
+        }
+        CLOG(INFO, "Ledger")
+            << "APPLY_VERIFY_THREADS=" << verifyThreads
+            << ": mean ledger close " << close.mean() << "ms";
+    };
+
+    for (int verifyThreads : {0, 1, 2, 4})
+    {
+        closeLedgers(verifyThreads);
+    }
+}
@@ -5,20 +5,27 @@
 #include "ledger/LedgerTxn.h"
 #include "ledger/LedgerTxnEntry.h"
 #include "ledger/LedgerTxnHeader.h"
+#include "ledger/LookaheadPrefetcher.h"
 #include "ledger/test/LedgerTestUtils.h"
 #include "lib/catch.hpp"
 #include "main/Application.h"
+#include "test/TestAccount.h"
 #include "test/TestUtils.h"
+#include "test/TxTests.h"
 #include "test/test.h"
 #include "transactions/TransactionUtils.h"
 #include "util/Math.h"
 #include "util/XDROperators.h"
 #include <algorithm>
+#include <condition_variable>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
+#include <thread>
 #include <xdrpp/autocheck.h>
 
 using namespace stellar;
@@ -54,6 +61,16 @@ validate(
     REQUIRE(iter == delta.entry.end());
 }
 
+// The default caches, with or without the in memory order book, which serves
+// offers in place of the best offers cache
+static Config
+getCachedTestConfig(bool inMemoryOrderBook)
+{
+    auto cfg = getTestConfig();
+    cfg.IN_MEMORY_ORDER_BOOK = inMemoryOrderBook;
+    return cfg;
+}
+
 static LedgerEntry
 generateLedgerEntryWithSameKey(LedgerEntry const& leBase)
 {
@@ -385,23 +402,31 @@ TEST_CASE("LedgerTxn round trip", "[ledgertxn]")
 
     SECTION("round trip to LedgerTxn")
     {
-        VirtualClock clock;
-        auto app = createTestApplication(clock, getTestConfig());
-        app->start();
+        for (bool inMemoryOrderBook : {true, false})
+        {
+            VirtualClock clock;
+            auto app = createTestApplication(
+                clock, getCachedTestConfig(inMemoryOrderBook));
+            app->start();
 
-        LedgerTxn ltx1(app->getLedgerTxnRoot());
-        runTest(ltx1);
+            LedgerTxn ltx1(app->getLedgerTxnRoot());
+            runTest(ltx1);
+        }
     }
 
     SECTION("round trip to LedgerTxnRoot")
     {
         SECTION("with normal caching")
         {
-            VirtualClock clock;
-            auto app = createTestApplication(clock, getTestConfig());
-            app->start();
+            for (bool inMemoryOrderBook : {true, false})
+            {
+                VirtualClock clock;
+                auto app = createTestApplication(
+                    clock, getCachedTestConfig(inMemoryOrderBook));
+                app->start();
 
-            runTest(app->getLedgerTxnRoot());
+                runTest(app->getLedgerTxnRoot());
+            }
         }
 
         SECTION("with no cache")
@@ -410,6 +435,7 @@ TEST_CASE("LedgerTxn round trip", "[ledgertxn]")
             auto cfg = getTestConfig();
             cfg.ENTRY_CACHE_SIZE = 0;
             cfg.BEST_OFFERS_CACHE_SIZE = 0;
+            cfg.IN_MEMORY_ORDER_BOOK = false;
             auto app = createTestApplication(clock, cfg);
             app->start();
 
@@ -814,10 +840,14 @@ testInflationWinners(
     // first changes are in LedgerTxnRoot with cache
     if (updates.size() > 1)
     {
-        VirtualClock clock;
-        auto app = createTestApplication(clock, getTestConfig());
-        app->start();
-        testAtRoot(*app);
+        for (bool inMemoryOrderBook : {true, false})
+        {
+            VirtualClock clock;
+            auto app = createTestApplication(
+                clock, getCachedTestConfig(inMemoryOrderBook));
+            app->start();
+            testAtRoot(*app);
+        }
     }
 
     // first changes are in LedgerTxnRoot without cache
@@ -827,15 +857,18 @@ testInflationWinners(
         auto cfg = getTestConfig();
         cfg.ENTRY_CACHE_SIZE = 0;
         cfg.BEST_OFFERS_CACHE_SIZE = 0;
+        cfg.IN_MEMORY_ORDER_BOOK = false;
         auto app = createTestApplication(clock, cfg);
         app->start();
         testAtRoot(*app);
     }
 
     // first changes are in child of LedgerTxnRoot
+    for (bool inMemoryOrderBook : {true, false})
     {
         VirtualClock clock;
-        auto app = createTestApplication(clock, getTestConfig());
+        auto app = createTestApplication(
+            clock, getCachedTestConfig(inMemoryOrderBook));
         app->start();
 
         testInflationWinners(app->getLedgerTxnRoot(), maxWinners, minBalance,
@@ -1390,10 +1423,14 @@ testAllOffers(
     // first changes are in LedgerTxnRoot with cache
     if (updates.size() > 1)
     {
-        VirtualClock clock;
-        auto app = createTestApplication(clock, getTestConfig());
-        app->start();
-        testAtRoot(*app);
+        for (bool inMemoryOrderBook : {true, false})
+        {
+            VirtualClock clock;
+            auto app = createTestApplication(
+                clock, getCachedTestConfig(inMemoryOrderBook));
+            app->start();
+            testAtRoot(*app);
+        }
     }
 
     // first changes are in LedgerTxnRoot without cache
@@ -1403,15 +1440,18 @@ testAllOffers(
         auto cfg = getTestConfig();
         cfg.ENTRY_CACHE_SIZE = 0;
         cfg.BEST_OFFERS_CACHE_SIZE = 0;
+        cfg.IN_MEMORY_ORDER_BOOK = false;
         auto app = createTestApplication(clock, cfg);
         app->start();
         testAtRoot(*app);
     }
 
     // first changes are in child of LedgerTxnRoot
+    for (bool inMemoryOrderBook : {true, false})
     {
         VirtualClock clock;
-        auto app = createTestApplication(clock, getTestConfig());
+        auto app = createTestApplication(
+            clock, getCachedTestConfig(inMemoryOrderBook));
         app->start();
 
         testAllOffers(app->getLedgerTxnRoot(), expected, updates.cbegin(),
@@ -1642,10 +1682,14 @@ testBestOffer(
     // first changes are in LedgerTxnRoot with cache
     if (updates.size() > 1)
     {
-        VirtualClock clock;
-        auto app = createTestApplication(clock, getTestConfig());
-        app->start();
-        testAtRoot(*app);
+        for (bool inMemoryOrderBook : {true, false})
+        {
+            VirtualClock clock;
+            auto app = createTestApplication(
+                clock, getCachedTestConfig(inMemoryOrderBook));
+            app->start();
+            testAtRoot(*app);
+        }
     }
 
     // first changes are in LedgerTxnRoot without cache
@@ -1655,15 +1699,18 @@ testBestOffer(
         auto cfg = getTestConfig();
         cfg.ENTRY_CACHE_SIZE = 0;
         cfg.BEST_OFFERS_CACHE_SIZE = 0;
+        cfg.IN_MEMORY_ORDER_BOOK = false;
         auto app = createTestApplication(clock, cfg);
         app->start();
         testAtRoot(*app);
     }
 
     // first changes are in child of LedgerTxnRoot
+    for (bool inMemoryOrderBook : {true, false})
     {
         VirtualClock clock;
-        auto app = createTestApplication(clock, getTestConfig());
+        auto app = createTestApplication(
+            clock, getCachedTestConfig(inMemoryOrderBook));
         app->start();
 
         testBestOffer(app->getLedgerTxnRoot(), buying, selling, expected,
@@ -1720,6 +1767,42 @@ TEST_CASE("LedgerTxn loadBestOffer", "[ledgertxn]")
                           std::runtime_error);
     }
 
+    SECTION("loads the offer found by getBestOffer")
+    {
+        VirtualClock clock;
+        auto app = createTestApplication(clock, getTestConfig());
+        app->start();
+
+        LedgerTxn ltx1(app->getLedgerTxnRoot());
+        for (int64_t offerID = 1; offerID <= 2; ++offerID)
+        {
+            LedgerEntry le;
+            le.data.type(OFFER);
+            auto& oe = le.data.offer();
+            oe = LedgerTestUtils::generateValidOfferEntry();
+            oe.sellerID = a1;
+            oe.offerID = offerID;
+            oe.buying = buying;
+            oe.selling = selling;
+            oe.price = Price{static_cast<int32_t>(3 - offerID), 1};
+            REQUIRE(ltx1.create(le));
+        }
+
+        // The offers loaded are recorded, so that the next best offer is found
+        LedgerTxn ltx2(ltx1);
+        for (int64_t offerID = 2; offerID >= 1; --offerID)
+        {
+            auto best = ltx2.getBestOffer(buying, selling);
+            REQUIRE(best);
+            REQUIRE(best->data.offer().offerID == offerID);
+            auto offer = ltx2.loadBestOffer(buying, selling, best);
+            REQUIRE(offer.current() == *best);
+            offer.erase();
+        }
+        REQUIRE(!ltx2.getBestOffer(buying, selling));
+        REQUIRE(!ltx2.loadBestOffer(buying, selling, nullptr));
+    }
+
     SECTION("empty parent")
     {
         SECTION("no offers")
@@ -1901,10 +1984,14 @@ testOffersByAccountAndAsset(
     // first changes are in LedgerTxnRoot with cache
     if (updates.size() > 1)
     {
-        VirtualClock clock;
-        auto app = createTestApplication(clock, getTestConfig());
-        app->start();
-        testAtRoot(*app);
+        for (bool inMemoryOrderBook : {true, false})
+        {
+            VirtualClock clock;
+            auto app = createTestApplication(
+                clock, getCachedTestConfig(inMemoryOrderBook));
+            app->start();
+            testAtRoot(*app);
+        }
     }
 
     // first changes are in LedgerTxnRoot without cache
@@ -1914,15 +2001,18 @@ testOffersByAccountAndAsset(
         auto cfg = getTestConfig();
         cfg.ENTRY_CACHE_SIZE = 0;
         cfg.BEST_OFFERS_CACHE_SIZE = 0;
+        cfg.IN_MEMORY_ORDER_BOOK = false;
         auto app = createTestApplication(clock, cfg);
         app->start();
         testAtRoot(*app);
     }
 
     // first changes are in child of LedgerTxnRoot
+    for (bool inMemoryOrderBook : {true, false})
     {
         VirtualClock clock;
-        auto app = createTestApplication(clock, getTestConfig());
+        auto app = createTestApplication(
+            clock, getCachedTestConfig(inMemoryOrderBook));
         app->start();
 
         testOffersByAccountAndAsset(app->getLedgerTxnRoot(), accountID, asset,
@@ -2181,6 +2271,8 @@ TEST_CASE("LedgerTxnRoot prefetch", "[ledgertxn]")
     auto cfg = getTestConfig();
     cfg.ENTRY_CACHE_SIZE = 1000;
     cfg.PREFETCH_BATCH_SIZE = cfg.ENTRY_CACHE_SIZE / 10;
+    // offers are not prefetched when they are all in memory
+    cfg.IN_MEMORY_ORDER_BOOK = false;
 
     std::unordered_set<LedgerKey> keysToPrefetch;
     auto app = createTestApplication(clock, cfg);
@@ -2221,6 +2313,372 @@ TEST_CASE("LedgerTxnRoot prefetch", "[ledgertxn]")
     }
 }
 
+TEST_CASE("LedgerTxnRoot lookahead prefetch", "[ledgertxn]")
+{
+    auto runTest = [](Config::TestDbMode mode) {
+        VirtualClock clock;
+        Config cfg(getTestConfig(0, mode));
+        cfg.PREFETCH_LOOKAHEAD = 2;
+        auto app = createTestApplication(clock, cfg);
+        app->start();
+        auto& ltxRoot = dynamic_cast<LedgerTxnRoot&>(app->getLedgerTxnRoot());
+        REQUIRE(app->getDatabase().canUsePool());
+
+        auto root = TestAccount::createRoot(*app);
+        auto minBalance = app->getLedgerManager().getLastMinBalance(0);
+        std::vector<TestAccount> accounts;
+        std::unordered_set<LedgerKey> keys;
+        std::vector<TransactionFrameBasePtr> txs;
+        for (size_t i = 0; i < 10; ++i)
+        {
+            accounts.emplace_back(
+                root.create("a" + std::to_string(i), minBalance + 1000));
+            keys.emplace(accountKey(accounts.back().getPublicKey()));
+        }
+        for (auto& a : accounts)
+        {
+            txs.emplace_back(a.tx({txtest::payment(root, 1)}));
+        }
+        ltxRoot.clearCaches();
+
+        // Loads `keys` through ltx, returning how many come from the cache
+        auto loadCached = [&](AbstractLedgerTxn& ltx) {
+            auto hits = ltxRoot.getEntryCacheStats()[ACCOUNT].hits;
+            for (auto const& key : keys)
+            {
+                REQUIRE(ltx.loadWithoutRecord(key));
+            }
+            return ltxRoot.getEntryCacheStats()[ACCOUNT].hits - hits;
+        };
+
+        SECTION("needs a child")
+        {
+            REQUIRE(!ltxRoot.makeAsyncPrefetch(keys));
+        }
+
+        SECTION("loads on another thread")
+        {
+            LedgerTxn ltx(ltxRoot);
+            auto load = ltxRoot.makeAsyncPrefetch(keys);
+            REQUIRE(load);
+            auto prefetched = std::async(std::launch::async, load).get();
+            REQUIRE(prefetched.entries.size() == keys.size());
+            REQUIRE(ltxRoot.cachePrefetched(prefetched) == keys.size());
+            REQUIRE(loadCached(ltx) == keys.size());
+
+            // Nothing left to load
+            REQUIRE(!ltxRoot.makeAsyncPrefetch(keys));
+        }
+
+        SECTION("discards results loaded for an earlier child")
+        {
+            auto key = *keys.begin();
+            PrefetchedEntries prefetched;
+            {
+                LedgerTxn ltx(ltxRoot);
+                auto load = ltxRoot.makeAsyncPrefetch({key});
+                REQUIRE(load);
+                prefetched = std::async(std::launch::async, load).get();
+                REQUIRE(prefetched.entries.size() == 1);
+                auto entry = ltx.load(key);
+                entry.current().data.account().balance += 1;
+                ltx.commit();
+            }
+            // As if the committed entry had been evicted since
+            ltxRoot.clearCaches();
+
+            LedgerTxn ltx(ltxRoot);
+            REQUIRE(ltxRoot.cachePrefetched(prefetched) == 0);
+            auto balance = prefetched.entries.at(key)->data.account().balance;
+            REQUIRE(ltx.loadWithoutRecord(key)
+                        .current()
+                        .data.account()
+                        .balance == balance + 1);
+        }
+
+        SECTION("prefetches the next group in the background")
+        {
+            LedgerTxn ltx(ltxRoot);
+            LookaheadPrefetcher prefetcher(*app, ltxRoot, txs);
+            for (size_t i = 0; i < txs.size(); ++i)
+            {
+                prefetcher.beforeApply(i);
+                // Let a worker start the load, as it would while the
+                // transaction applies
+                while (prefetcher.isNextGroupPendingForTesting())
+                {
+                    std::this_thread::yield();
+                }
+            }
+            REQUIRE(prefetcher.getSynchronousLoads() == 1);
+            REQUIRE(prefetcher.getBackgroundLoads() == 4);
+            REQUIRE(loadCached(ltx) == keys.size());
+        }
+
+        SECTION("prefetches synchronously when all workers are busy")
+        {
+            // Keep every worker busy until the end of the section
+            size_t n = static_cast<size_t>(app->getConfig().WORKER_THREADS);
+            std::mutex mutex;
+            std::condition_variable cv;
+            size_t busy = 0;
+            bool release = false;
+            for (size_t i = 0; i < n; ++i)
+            {
+                app->postOnBackgroundThread(
+                    [&] {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        ++busy;
+                        cv.notify_all();
+                        cv.wait(lock, [&] { return release; });
+                        --busy;
+                        cv.notify_all();
+                    },
+                    "LedgerTxnTests: busy worker");
+            }
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return busy == n; });
+            }
+
+            {
+                LedgerTxn ltx(ltxRoot);
+                LookaheadPrefetcher prefetcher(*app, ltxRoot, txs);
+                for (size_t i = 0; i < txs.size(); ++i)
+                {
+                    prefetcher.beforeApply(i);
+                }
+                // The main thread never waited for the busy workers
+                REQUIRE(prefetcher.getSynchronousLoads() == 5);
+                REQUIRE(prefetcher.getBackgroundLoads() == 0);
+                REQUIRE(loadCached(ltx) == keys.size());
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            release = true;
+            cv.notify_all();
+            cv.wait(lock, [&] { return busy == 0; });
+        }
+
+        SECTION("prefetches synchronously when a background load fails")
+        {
+            LedgerTxn ltx(ltxRoot);
+            LookaheadPrefetcher prefetcher(*app, ltxRoot, txs);
+            prefetcher.failBackgroundLoadsForTesting();
+            for (size_t i = 0; i < txs.size(); ++i)
+            {
+                prefetcher.beforeApply(i);
+            }
+            REQUIRE(prefetcher.getSynchronousLoads() == 5);
+            REQUIRE(prefetcher.getBackgroundLoads() == 0);
+            REQUIRE(loadCached(ltx) == keys.size());
+        }
+    };
+
+    SECTION("sqlite")
+    {
+        runTest(Config::TESTDB_ON_DISK_SQLITE);
+    }
+
+#ifdef USE_POSTGRES
+    SECTION("postgresql")
+    {
+        runTest(Config::TESTDB_POSTGRESQL);
+    }
+#endif
+}
+
+TEST_CASE("LedgerTxnRoot entry cache survives commit", "[ledgertxn]")
+{
+    VirtualClock clock;
+    auto cfg = getTestConfig();
+    auto app = createTestApplication(clock, cfg);
+    app->start();
+    auto& root = app->getLedgerTxnRoot();
+
+    LedgerEntry le;
+    le.lastModifiedLedgerSeq = 1;
+    le.data.type(ACCOUNT);
+    le.data.account() = LedgerTestUtils::generateValidAccountEntry();
+    le.data.account().balance = 100;
+    auto key = LedgerEntryKey(le);
+
+    auto stats = [&]() { return root.getEntryCacheStats()[ACCOUNT]; };
+
+    // Loads the entry from the database, bypassing the cache of root
+    auto loadFromDatabase = [&]() {
+        LedgerTxnRoot uncached(app->getDatabase(), cfg.ENTRY_CACHE_SIZE,
+                               cfg.BEST_OFFERS_CACHE_SIZE,
+                               cfg.PREFETCH_BATCH_SIZE, false);
+        return uncached.getNewestVersion(key);
+    };
+
+    {
+        LedgerTxn ltx(root);
+        REQUIRE(ltx.create(le));
+        REQUIRE(stats().hits == 0);
+        REQUIRE(stats().misses > 0);
+        ltx.commit();
+    }
+    REQUIRE(root.getEntryCacheStats().empty());
+
+    SECTION("created entry")
+    {
+        LedgerTxn ltx(root);
+        auto entry = ltx.load(key);
+        REQUIRE(entry);
+        REQUIRE(entry.current() == *loadFromDatabase());
+        REQUIRE(stats().hits == 1);
+        REQUIRE(stats().misses == 0);
+    }
+
+    SECTION("modified entry")
+    {
+        {
+            LedgerTxn ltx(root);
+            ltx.load(key).current().data.account().balance = 200;
+            ltx.commit();
+        }
+
+        LedgerTxn ltx(root);
+        auto entry = ltx.load(key);
+        REQUIRE(entry.current().data.account().balance == 200);
+        REQUIRE(entry.current() == *loadFromDatabase());
+        REQUIRE(stats().hits == 1);
+        REQUIRE(stats().misses == 0);
+    }
+
+    SECTION("erased entry")
+    {
+        {
+            LedgerTxn ltx(root);
+            ltx.erase(key);
+            ltx.commit();
+        }
+
+        LedgerTxn ltx(root);
+        REQUIRE(!ltx.load(key));
+        REQUIRE(!loadFromDatabase());
+        REQUIRE(stats().hits == 1);
+        REQUIRE(stats().misses == 0);
+    }
+}
+
+TEST_CASE("LedgerTxnRoot in memory order book", "[ledgertxn]")
+{
+    VirtualClock clock;
+    auto cfg = getTestConfig();
+    cfg.IN_MEMORY_ORDER_BOOK = true;
+    auto app = createTestApplication(clock, cfg);
+    app->start();
+    auto& root = app->getLedgerTxnRoot();
+
+    auto issuer = autocheck::generator<AccountID>()(5);
+    std::vector<Asset> assets;
+    assets.emplace_back(ASSET_TYPE_NATIVE);
+    for (size_t i = 1; i < 3; ++i)
+    {
+        Asset a(ASSET_TYPE_CREDIT_ALPHANUM4);
+        strToAssetCode(a.alphaNum4().assetCode, "A" + std::to_string(i));
+        a.alphaNum4().issuer = issuer;
+        assets.emplace_back(a);
+    }
+    std::vector<AccountID> sellers;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        sellers.emplace_back(autocheck::generator<AccountID>()(5));
+    }
+
+    std::vector<LedgerEntry> offers;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        LedgerEntry le;
+        le.data.type(OFFER);
+        auto& oe = le.data.offer();
+        oe = LedgerTestUtils::generateValidOfferEntry();
+        oe.offerID = i + 1;
+        oe.sellerID = sellers[i % sellers.size()];
+        oe.selling = assets[i % assets.size()];
+        oe.buying = assets[(i + 1 + (i / assets.size()) % 2) % assets.size()];
+        // few distinct prices, so that offers are also ordered by id
+        oe.price = Price{static_cast<int32_t>(i % 3 + 1), 1};
+        offers.emplace_back(le);
+    }
+
+    // Compares what root returns to what a LedgerTxnRoot without the order
+    // book loads from the database
+    auto check = [&]() {
+        LedgerTxnRoot sql(app->getDatabase(), 0, 0, cfg.PREFETCH_BATCH_SIZE,
+                          false);
+        REQUIRE(root.getAllOffers() == sql.getAllOffers());
+        for (auto const& buying : assets)
+        {
+            for (auto const& selling : assets)
+            {
+                auto expected = sql.getBestOffer(buying, selling);
+                auto actual = root.getBestOffer(buying, selling);
+                while (expected)
+                {
+                    REQUIRE(actual);
+                    REQUIRE(*actual == *expected);
+                    auto const& oe = expected->data.offer();
+                    OfferDescriptor desc{oe.price, oe.offerID};
+                    expected = sql.getBestOffer(buying, selling, desc);
+                    actual = root.getBestOffer(buying, selling, desc);
+                }
+                REQUIRE(!actual);
+            }
+            for (auto const& seller : sellers)
+            {
+                REQUIRE(root.getOffersByAccountAndAsset(seller, buying) ==
+                        sql.getOffersByAccountAndAsset(seller, buying));
+            }
+        }
+        for (auto const& offer : offers)
+        {
+            auto key = LedgerEntryKey(offer);
+            auto expected = sql.getNewestVersion(key);
+            auto actual = root.getNewestVersion(key);
+            REQUIRE(!actual == !expected);
+            REQUIRE((!actual || *actual == *expected));
+        }
+    };
+
+    {
+        LedgerTxn ltx(root);
+        for (auto const& offer : offers)
+        {
+            ltx.create(offer);
+        }
+        ltx.commit();
+    }
+    check();
+
+    {
+        LedgerTxn ltx(root);
+        for (size_t i = 0; i < offers.size(); i += 3)
+        {
+            auto offer = ltx.load(LedgerEntryKey(offers[i]));
+            auto& oe = offer.current().data.offer();
+            oe.price.n = static_cast<int32_t>((i + 1) % 3 + 1);
+            std::swap(oe.buying, oe.selling);
+        }
+        for (size_t i = 1; i < offers.size(); i += 5)
+        {
+            ltx.erase(LedgerEntryKey(offers[i]));
+        }
+        ltx.commit();
+    }
+    check();
+
+    {
+        LedgerTxn ltx(root);
+        ltx.erase(LedgerEntryKey(offers[2]));
+        // changes that are rolled back do not reach the order book
+    }
+    check();
+}
+
 TEST_CASE("Create performance benchmark", "[!hide][createbench]")
 {
     auto runTest = [&](Config::TestDbMode mode, bool loading) {
@@ -2350,6 +2808,68 @@ TEST_CASE("Erase performance benchmark", "[!hide][erasebench]")
 #endif
 }
 
+TEST_CASE("Nested commit performance benchmark", "[!hide][nestedcommitbench]")
+{
+    // Models the LedgerTxn nesting of transaction apply: one LedgerTxn per
+    // ledger, per transaction and per operation, where each operation
+    // modifies a few accounts that then get committed twice.
+    auto runTest = [&](size_t entrySize, size_t opsPerTx) {
+        VirtualClock clock;
+        Application::pointer app =
+            createTestApplication(clock, getTestConfig());
+        app->start();
+        size_t const numAccounts = 1000, numTxs = 1000, accountsPerOp = 3;
+
+        // entrySize bounds the number of signers of the accounts
+        std::vector<LedgerKey> keys;
+        LedgerTxn ltxLedger(app->getLedgerTxnRoot());
+        for (size_t i = 0; i < numAccounts; ++i)
+        {
+            LedgerEntry le;
+            le.data.type(ACCOUNT);
+            le.data.account() =
+                LedgerTestUtils::generateValidAccountEntry(entrySize);
+            le.data.account().balance = 0;
+            ltxLedger.create(le);
+            keys.emplace_back(LedgerEntryKey(le));
+        }
+
+        auto& timer = app->getMetrics().NewTimer(
+            {"ledger", "nested-commit",
+             "benchmark-" + std::to_string(entrySize) + "-" +
+                 std::to_string(opsPerTx)});
+        size_t next = 0;
+        for (size_t tx = 0; tx < numTxs; ++tx)
+        {
+            auto scope = timer.TimeScope();
+            LedgerTxn ltxTx(ltxLedger);
+            for (size_t op = 0; op < opsPerTx; ++op)
+            {
+                LedgerTxn ltxOp(ltxTx);
+                for (size_t i = 0; i < accountsPerOp; ++i)
+                {
+                    auto account = ltxOp.load(keys[next++ % keys.size()]);
+                    ++account.current().data.account().balance;
+                }
+                ltxOp.commit();
+            }
+            ltxTx.commit();
+        }
+
+        CLOG(INFO, "Ledger")
+            << "benchmark nested commit with entry size " << entrySize << ", "
+            << opsPerTx << " ops per tx: " << timer.mean() << " ms per tx";
+    };
+
+    for (size_t entrySize : {3, 20})
+    {
+        for (size_t opsPerTx : {1, 10, 100})
+        {
+            runTest(entrySize, opsPerTx);
+        }
+    }
+}
+
 TEST_CASE("Bulk load batch size benchmark", "[!hide][bulkbatchsizebench]")
 {
     size_t floor = 1000;
@@ -151,7 +151,8 @@ ApplicationImpl::initialize(bool createNewDB)
     {
         mLedgerTxnRoot = std::make_unique<LedgerTxnRoot>(
             *mDatabase, mConfig.ENTRY_CACHE_SIZE,
-            mConfig.BEST_OFFERS_CACHE_SIZE, mConfig.PREFETCH_BATCH_SIZE);
+            mConfig.BEST_OFFERS_CACHE_SIZE, mConfig.PREFETCH_BATCH_SIZE,
+            mConfig.IN_MEMORY_ORDER_BOOK);
     }
 
     BucketListIsConsistentWithDatabase::registerInvariant(*this);
@@ -563,7 +563,34 @@ CommandHandler::tx(std::string const& params, std::string& retStr)
 
         auto transaction = TransactionFrameBase::makeTransactionFromWire(
             mApp.getNetworkID(), envelope);
-        if (transaction)
+        if (transaction && mApp.getConfig().TRANSACTION_ADMISSION_SHARDS > 0)
+        {
+            // verify the signatures on a worker thread like for transactions
+            // from peers: the transaction is only added to our current set
+            // (and broadcast) once it is checked, so all we can report is
+            // that it is pending
+            auto& app = mApp;
+            mApp.getHerder().recvTransactionAsync(
+                transaction,
+                [&app, envelope](TransactionQueue::AddResult status) {
+                    if (status ==
+                        TransactionQueue::AddResult::ADD_STATUS_PENDING)
+                    {
+                        StellarMessage msg;
+                        msg.type(TRANSACTION);
+                        msg.transaction() = envelope;
+                        app.getOverlayManager().broadcastMessage(msg);
+                    }
+                });
+
+            output << "{"
+                   << "\"status\": "
+                   << "\""
+                   << TX_STATUS_STRING[static_cast<int>(
+                          TransactionQueue::AddResult::ADD_STATUS_PENDING)]
+                   << "\"}";
+        }
+        else if (transaction)
         {
             // add it to our current set
             // and make sure it is valid
@@ -5,6 +5,7 @@
 #include "main/CommandLine.h"
 #include "catchup/CatchupConfiguration.h"
 #include "history/HistoryArchiveManager.h"
+#include "history/HistoryManager.h"
 #include "history/InferredQuorumUtils.h"
 #include "ledger/LedgerManager.h"
 #include "main/Application.h"
@@ -28,10 +29,16 @@
 #include "test/test.h"
 #endif
 
+#include <cstring>
 #include <iostream>
 #include <lib/clara.hpp>
 #include <lib/util/format.h>
 
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 namespace stellar
 {
 
@@ -465,6 +472,62 @@ CommandLine::writeToStream(std::string const& exeName, std::ostream& os) const
 }
 }
 
+#ifndef _WIN32
+// Runs each of `catchups` in its own child process, with `runOne`, and waits
+// for all of them. Returns 0 if they all succeeded.
+static int
+runCatchupsInParallel(
+    std::vector<CatchupConfiguration> const& catchups,
+    std::function<int(size_t, CatchupConfiguration const&)> const& runOne)
+{
+    std::vector<pid_t> children;
+    std::fflush(nullptr);
+    for (size_t i = 0; i < catchups.size(); ++i)
+    {
+        auto pid = fork();
+        if (pid < 0)
+        {
+            LOG(FATAL) << "Could not start replay process: "
+                       << std::strerror(errno);
+            break;
+        }
+        if (pid == 0)
+        {
+            int result = 1;
+            try
+            {
+                result = runOne(i, catchups[i]);
+            }
+            catch (std::exception& e)
+            {
+                LOG(FATAL) << "Replay to ledger " << catchups[i].toLedger()
+                           << " failed: " << e.what();
+            }
+            std::exit(result);
+        }
+        children.emplace_back(pid);
+    }
+
+    int result = children.size() == catchups.size() ? 0 : 1;
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+        int status = 0;
+        while (waitpid(children[i], &status, 0) < 0 && errno == EINTR)
+        {
+        }
+        bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        LOG(INFO) << "Replay to ledger " << catchups[i].toLedger() << " ("
+                  << catchups[i].count() << " ledgers) "
+                  << (ok ? "succeeded" : "failed");
+        if (!ok)
+        {
+            result = 3;
+        }
+    }
+    return result;
+}
+#endif
+
 int
 runCatchup(CommandLineArgs const& args)
 {
@@ -474,6 +537,7 @@ runCatchup(CommandLineArgs const& args)
     std::string archive;
     bool completeValidation = false;
     bool replayInMemory = false;
+    uint32_t parallelism = 1;
 
     auto validateCatchupString = [&] {
         try
@@ -518,13 +582,53 @@ runCatchup(CommandLineArgs const& args)
             "don't use a database, just replay ledgers in memory");
     };
 
+    auto validateParallelism = [&] {
+        if (parallelism == 0)
+        {
+            return std::string{"Catchup error: bad parallelism"};
+        }
+        if (parallelism == 1)
+        {
+            return std::string{};
+        }
+#ifdef _WIN32
+        return std::string{"Catchup error: --parallel is not supported on "
+                           "this platform"};
+#else
+        try
+        {
+            if (parseCatchup(catchupString, completeValidation).toLedger() ==
+                CatchupConfiguration::CURRENT)
+            {
+                return std::string{
+                    "Catchup error: --parallel needs a destination ledger"};
+            }
+        }
+        catch (std::runtime_error&)
+        {
+            // reported by the catchup string validation
+        }
+        if (!outputFile.empty())
+        {
+            return std::string{
+                "Catchup error: --parallel does not write catchup info"};
+        }
+        return std::string{};
+#endif
+    };
+    auto parallelismParser = ParserWithValidation{
+        clara::Opt{parallelism, "N"}["--parallel"](
+            "split the range into N parts replayed in memory, concurrently, "
+            "each from the buckets at its first checkpoint"),
+        validateParallelism};
+
     return runWithHelp(
         args,
         {configurationParser(configOption), catchupStringParser,
          catchupArchiveParser, outputFileParser(outputFile),
          disableBucketGCParser(disableBucketGC),
          validationParser(completeValidation),
-         replayInMemoryParser(replayInMemory)},
+         replayInMemoryParser(replayInMemory), parallelismParser},
         [&] {
             auto config = configOption.getConfig();
             config.setNoListen();
@@ -541,6 +645,13 @@ runCatchup(CommandLineArgs const& args)
                 config.AUTOMATIC_MAINTENANCE_COUNT = 1000000;
             }
 
+            if (parallelism > 1)
+            {
+                // Each part of a parallel replay gets its own ledger, which
+                // has to be in memory
+                replayInMemory = true;
+            }
+
             if (replayInMemory)
             {
                 // Adjust configs for in-memory-replay mode
@@ -553,35 +664,60 @@ runCatchup(CommandLineArgs const& args)
                 config.DISABLE_XDR_FSYNC = true;
             }
 
-            VirtualClock clock(VirtualClock::REAL_TIME);
-            int result;
-            {
-                auto app = Application::create(clock, config, replayInMemory);
-                auto const& ham = app->getHistoryArchiveManager();
-                auto archivePtr = ham.getHistoryArchive(archive);
-                if (iequals(archive, "any"))
+            auto runOne = [&](Config const& config,
+                              CatchupConfiguration const& cc) {
+                VirtualClock clock(VirtualClock::REAL_TIME);
+                int result;
                 {
-                    archivePtr = ham.selectRandomReadableHistoryArchive();
+                    auto app =
+                        Application::create(clock, config, replayInMemory);
+                    auto const& ham = app->getHistoryArchiveManager();
+                    auto archivePtr = ham.getHistoryArchive(archive);
+                    if (iequals(archive, "any"))
+                    {
+                        archivePtr = ham.selectRandomReadableHistoryArchive();
+                    }
+
+                    Json::Value catchupInfo;
+                    result = catchup(app, cc, catchupInfo, archivePtr);
+                    if (!catchupInfo.isNull())
+                    {
+                        writeCatchupInfo(catchupInfo, outputFile);
+                    }
                 }
 
-                Json::Value catchupInfo;
-                result = catchup(
-                    app, parseCatchup(catchupString, completeValidation),
-                    catchupInfo, archivePtr);
-                if (!catchupInfo.isNull())
+                if (replayInMemory)
                 {
-                    writeCatchupInfo(catchupInfo, outputFile);
+                    // Clean up `buckets` folder when in in-memory-replay mode
+                    VirtualClock clockBuckets(VirtualClock::REAL_TIME);
+                    auto app = Application::create(clockBuckets, config, true);
                 }
-            }
 
-            if (replayInMemory)
+                return result;
+            };
+
+            auto cc = parseCatchup(catchupString, completeValidation);
+#ifndef _WIN32
+            if (parallelism > 1)
             {
-                // Clean up `buckets` folder when in in-memory-replay mode
-                VirtualClock clockBuckets(VirtualClock::REAL_TIME);
-                auto app = Application::create(clockBuckets, config, true);
+                // Every ledger replayed by a part is checked against the
+                // (verified) archive headers, and each part starts from
+                // buckets matching the header of the checkpoint the previous
+                // part ends on, so together the parts verify the whole range.
+                auto parts = splitCatchupConfiguration(
+                    cc, parallelism,
+                    HistoryManager::getCheckpointFrequency(config));
+                LOG(INFO) << "Replaying in " << parts.size() << " parts";
+                return runCatchupsInParallel(
+                    parts, [&](size_t i, CatchupConfiguration const& part) {
+                        // Parts must not share a bucket directory
+                        auto partConfig = config;
+                        partConfig.BUCKET_DIR_PATH += fmt::format("-{}", i);
+                        return runOne(partConfig, part);
+                    });
             }
-
-            return result;
+#endif
+            return runOne(config, cc);
         });
 }
 
@@ -127,6 +127,7 @@ Config::Config() : NODE_SEED(SecretKey::random())
 
     LOG_FILE_PATH = "stellar-core.%datetime{%Y.%M.%d-%H:%m:%s}.log";
     BUCKET_DIR_PATH = "buckets";
+    HISTORY_CACHE_DIR = "";
 
     TESTING_UPGRADE_DESIRED_FEE = LedgerManager::GENESIS_LEDGER_BASE_FEE;
     TESTING_UPGRADE_RESERVE = LedgerManager::GENESIS_LEDGER_BASE_RESERVE;
@@ -163,14 +164,20 @@ Config::Config() : NODE_SEED(SecretKey::random())
     //
     // Worst case = 10 concurrent merges + 1 quorum intersection calculation.
     WORKER_THREADS = 11;
+    TRANSACTION_ADMISSION_SHARDS = 0;
+    APPLY_VERIFY_THREADS = 0;
     MAX_CONCURRENT_SUBPROCESSES = 16;
+    CATCHUP_PREFETCH_CHECKPOINTS = 16;
+    CATCHUP_PREFETCH_MEMORY_MB = 256;
     NODE_IS_VALIDATOR = false;
     QUORUM_INTERSECTION_CHECKER = true;
     DATABASE = SecretValue{"sqlite3://:memory:"};
 
     ENTRY_CACHE_SIZE = 100000;
     BEST_OFFERS_CACHE_SIZE = 64;
+    IN_MEMORY_ORDER_BOOK = true;
     PREFETCH_BATCH_SIZE = 1000;
+    PREFETCH_LOOKAHEAD = 100;
 
     SUPPORTED_META_VERSION = 1;
 
@@ -778,6 +785,10 @@ Config::processConfig(std::shared_ptr<cpptoml::table> t)
             {
                 BUCKET_DIR_PATH = readString(item);
             }
+            else if (item.first == "HISTORY_CACHE_DIR")
+            {
+                HISTORY_CACHE_DIR = readString(item);
+            }
             else if (item.first == "NODE_NAMES")
             {
                 auto names = readStringArray(item);
@@ -876,10 +887,26 @@ Config::processConfig(std::shared_ptr<cpptoml::table> t)
             {
                 WORKER_THREADS = readInt<int>(item, 1, 1000);
             }
+            else if (item.first == "TRANSACTION_ADMISSION_SHARDS")
+            {
+                TRANSACTION_ADMISSION_SHARDS = readInt<int>(item, 0, 1000);
+            }
+            else if (item.first == "APPLY_VERIFY_THREADS")
+            {
+                APPLY_VERIFY_THREADS = readInt<int>(item, 0, 1000);
+            }
             else if (item.first == "MAX_CONCURRENT_SUBPROCESSES")
             {
                 MAX_CONCURRENT_SUBPROCESSES = readInt<int>(item, 1);
             }
+            else if (item.first == "CATCHUP_PREFETCH_CHECKPOINTS")
+            {
+                CATCHUP_PREFETCH_CHECKPOINTS = readInt<int>(item, 1);
+            }
+            else if (item.first == "CATCHUP_PREFETCH_MEMORY_MB")
+            {
+                CATCHUP_PREFETCH_MEMORY_MB = readInt<int>(item, 0);
+            }
             else if (item.first == "MINIMUM_IDLE_PERCENT")
             {
                 MINIMUM_IDLE_PERCENT = readInt<uint32_t>(item, 0, 100);
@@ -955,10 +982,18 @@ Config::processConfig(std::shared_ptr<cpptoml::table> t)
             {
                 BEST_OFFERS_CACHE_SIZE = readInt<uint32_t>(item);
             }
+            else if (item.first == "IN_MEMORY_ORDER_BOOK")
+            {
+                IN_MEMORY_ORDER_BOOK = readBool(item);
+            }
             else if (item.first == "PREFETCH_BATCH_SIZE")
             {
                 PREFETCH_BATCH_SIZE = readInt<uint32_t>(item);
             }
+            else if (item.first == "PREFETCH_LOOKAHEAD")
+            {
+                PREFETCH_LOOKAHEAD = readInt<uint32_t>(item);
+            }
             else if (item.first == "MAXIMUM_LEDGER_CLOSETIME_DRIFT")
             {
                 MAXIMUM_LEDGER_CLOSETIME_DRIFT = readInt<int64_t>(item, 0);
@@ -280,6 +280,8 @@ class Config : public std::enable_shared_from_this<Config>
     std::string VERSION_STR;
     std::string LOG_FILE_PATH;
     std::string BUCKET_DIR_PATH;
+    // directory of downloaded history files shared by catchups, "" for none
+    std::string HISTORY_CACHE_DIR;
     uint32_t TESTING_UPGRADE_DESIRED_FEE; // in stroops
     uint32_t TESTING_UPGRADE_RESERVE;     // in stroops
     uint32_t TESTING_UPGRADE_MAX_TX_SET_SIZE;
@@ -329,9 +331,30 @@ class Config : public std::enable_shared_from_this<Config>
     // thread-management config
     int WORKER_THREADS;
 
+    // Number of shards (serialized by source account) used to verify
+    // transactions received from the overlay or the `tx` command on worker
+    // threads before adding them to the transaction queue on the main
+    // thread. 0 disables this and transactions are fully checked on the main
+    // thread.
+    int TRANSACTION_ADMISSION_SHARDS;
+
+    // Number of worker threads that help the main thread hash transactions
+    // and verify their signatures before a ledger closes, so that applying
+    // them in order on the main thread hits the signature cache. This is
+    // mostly useful when replaying history, as transactions received from
+    // peers are usually verified on arrival. 0 means that transactions are
+    // only verified as they apply.
+    int APPLY_VERIFY_THREADS;
+
     // process-management config
     int MAX_CONCURRENT_SUBPROCESSES;
 
+    // Catchup replay: number of checkpoints downloaded ahead of the one being
+    // applied, and memory (in MB) that checkpoints decoded ahead of apply may
+    // hold.
+    int CATCHUP_PREFETCH_CHECKPOINTS;
+    int CATCHUP_PREFETCH_MEMORY_MB;
+
     // SCP config
     SecretKey NODE_SEED;
     bool NODE_IS_VALIDATOR;
@@ -362,14 +385,23 @@ class Config : public std::enable_shared_from_this<Config>
     // - BEST_OFFERS_CACHE_SIZE controls the maximum number of Asset pairs that
     //   will be stored in the cache, although many LedgerEntry objects may be
     //   associated with a single Asset pair
+    // - IN_MEMORY_ORDER_BOOK keeps all offers in memory, updated as ledgers
+    //   close, rather than loading them from the database (in which case
+    //   BEST_OFFERS_CACHE_SIZE is unused)
     size_t ENTRY_CACHE_SIZE;
     size_t BEST_OFFERS_CACHE_SIZE;
+    bool IN_MEMORY_ORDER_BOOK;
 
     // Data layer prefetcher configuration
     // - PREFETCH_BATCH_SIZE determines how many records we'll prefetch per
     // SQL load. Note that it should be significantly smaller than size of
     // the entry cache
+    // - PREFETCH_LOOKAHEAD, when not 0 and the database has a connection
+    // pool, makes ledger close prefetch the entries of the transactions of a
+    // ledger by groups of that many transactions, loading each group on a
+    // connection of the pool while the previous group applies
     size_t PREFETCH_BATCH_SIZE;
+    size_t PREFETCH_LOOKAHEAD;
 
     // The version of TransactionMeta that will be generated. Acceptable values
     // are 1 (default) and 2. Set to 2 only if downstream systems have been
@@ -2,6 +2,7 @@
 // under the Apache License, Version 2.0. See the COPYING file at the root
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
+#include "herder/HerderImpl.h"
 #include "lib/catch.hpp"
 #include "main/Application.h"
 #include "main/CommandHandler.h"
@@ -10,6 +11,7 @@
 #include "test/TxTests.h"
 #include "test/test.h"
 #include "transactions/SignatureUtils.h"
+#include "transactions/TransactionBridge.h"
 #include "util/Decoder.h"
 #include "xdrpp/marshal.h"
 
@@ -136,3 +138,46 @@ TEST_CASE("transaction envelope bridge", "[commandhandler]")
         });
     }
 }
+
+TEST_CASE("submitting a transaction with admission shards", "[commandhandler]")
+{
+    // worker threads run in real time
+    VirtualClock clock(VirtualClock::REAL_TIME);
+    auto cfg = getTestConfig();
+    cfg.TRANSACTION_ADMISSION_SHARDS = 2;
+    auto app = createTestApplication(clock, cfg);
+    auto& ch = app->getCommandHandler();
+    auto& herder = static_cast<HerderImpl&>(app->getHerder());
+    auto& tq = herder.getTransactionQueue();
+
+    auto root = TestAccount::createRoot(*app);
+    auto tx = root.tx({payment(root, 1)});
+    auto good = tx->getEnvelope();
+    auto bad = good;
+    txbridge::getSignatures(bad).clear();
+
+    auto submit = [&](TransactionEnvelope const& env) {
+        std::string ret;
+        ch.tx("?blob=" + decoder::encode_b64(xdr::xdr_to_opaque(env)), ret);
+        return ret;
+    };
+
+    // both are only checked on a worker, then added on the main thread
+    std::string const PENDING_RESULT = "{\"status\": \"PENDING\"}";
+    REQUIRE(submit(bad) == PENDING_RESULT);
+    REQUIRE(submit(good) == PENDING_RESULT);
+    auto queuedOps = [&]() {
+        return tq.getAccountTransactionQueueInfo(root).mQueueSizeOps;
+    };
+    REQUIRE(queuedOps() == 0);
+
+    // transactions from the same account are added in order, so the bad one
+    // was rejected by the time the good one is queued
+    for (int i = 0; i < 1000 && queuedOps() == 0; ++i)
+    {
+        clock.crank(true);
+    }
+    auto info = tq.getAccountTransactionQueueInfo(root);
+    REQUIRE(info.mQueueSizeOps == 1);
+    REQUIRE(info.mMaxSeq == tx->getSeqNum());
+}
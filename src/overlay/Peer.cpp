@@ -689,6 +689,24 @@ Peer::recvTxSet(StellarMessage const& msg)
     mApp.getHerder().recvTxSet(frame.getContentsHash(), frame);
 }
 
+static void
+transactionReceived(Application& app, StellarMessage const& msg,
+                    Peer::pointer peer, TransactionQueue::AddResult recvRes)
+{
+    if (recvRes == TransactionQueue::AddResult::ADD_STATUS_PENDING ||
+        recvRes == TransactionQueue::AddResult::ADD_STATUS_DUPLICATE)
+    {
+        // record that this peer sent us this transaction
+        app.getOverlayManager().recvFloodedMsg(msg, peer);
+
+        if (recvRes == TransactionQueue::AddResult::ADD_STATUS_PENDING)
+        {
+            // if it's a new transaction, broadcast it
+            app.getOverlayManager().broadcastMessage(msg);
+        }
+    }
+}
+
 void
 Peer::recvTransaction(StellarMessage const& msg)
 {
@@ -698,19 +716,26 @@ Peer::recvTransaction(StellarMessage const& msg)
     {
         // add it to our current set
         // and make sure it is valid
-        auto recvRes = mApp.getHerder().recvTransaction(transaction);
-
-        if (recvRes == TransactionQueue::AddResult::ADD_STATUS_PENDING ||
-            recvRes == TransactionQueue::AddResult::ADD_STATUS_DUPLICATE)
+        if (mApp.getConfig().TRANSACTION_ADMISSION_SHARDS > 0)
+        {
+            // the peer may be gone by the time the transaction is added, in
+            // which case it will only be flooded on the next rebroadcast
+            auto& app = mApp;
+            std::weak_ptr<Peer> weak(shared_from_this());
+            mApp.getHerder().recvTransactionAsync(
+                transaction,
+                [&app, msg, weak](TransactionQueue::AddResult recvRes) {
+                    auto self = weak.lock();
+                    if (self)
+                    {
+                        transactionReceived(app, msg, self, recvRes);
+                    }
+                });
+        }
+        else
         {
-            // record that this peer sent us this transaction
-            mApp.getOverlayManager().recvFloodedMsg(msg, shared_from_this());
-
-            if (recvRes == TransactionQueue::AddResult::ADD_STATUS_PENDING)
-            {
-                // if it's a new transaction, broadcast it
-                mApp.getOverlayManager().broadcastMessage(msg);
-            }
+            transactionReceived(mApp, msg, shared_from_this(),
+                                mApp.getHerder().recvTransaction(transaction));
         }
     }
 }
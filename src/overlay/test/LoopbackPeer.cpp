@@ -23,7 +23,8 @@ using namespace std;
 // LoopbackPeer
 ///////////////////////////////////////////////////////////////////////
 
-LoopbackPeer::LoopbackPeer(Application& app, PeerRole role) : Peer(app, role)
+LoopbackPeer::LoopbackPeer(Application& app, PeerRole role)
+    : Peer(app, role), mDelayedInTimer(app)
 {
 }
 
@@ -179,6 +180,64 @@ LoopbackPeer::processInQueue()
     }
 }
 
+VirtualClock::duration
+LoopbackPeer::getRetransmitDelay() const
+{
+    // a retransmission costs at least a round trip, and no less than the
+    // usual minimum TCP retransmission timeout
+    return std::max<VirtualClock::duration>(std::chrono::milliseconds(200),
+                                            2 * mDelay);
+}
+
+void
+LoopbackPeer::recvDelayed(xdr::msg_ptr&& msg, VirtualClock::time_point when)
+{
+    mDelayedInQueue.emplace_back(when, std::move(msg));
+    if (mDelayedInQueue.size() == 1)
+    {
+        processDelayedInQueue();
+    }
+}
+
+void
+LoopbackPeer::processDelayedInQueue()
+{
+    if (mState == CLOSING)
+    {
+        mDelayedInQueue.clear();
+        return;
+    }
+
+    auto now = mApp.getClock().now();
+    bool received = false;
+    while (!mDelayedInQueue.empty() && mDelayedInQueue.front().first <= now)
+    {
+        mInQueue.emplace(std::move(mDelayedInQueue.front().second));
+        mDelayedInQueue.pop_front();
+        received = true;
+    }
+    if (received)
+    {
+        processInQueue();
+    }
+
+    if (!mDelayedInQueue.empty())
+    {
+        std::weak_ptr<LoopbackPeer> self =
+            static_pointer_cast<LoopbackPeer>(shared_from_this());
+        mDelayedInTimer.expires_at(mDelayedInQueue.front().first);
+        mDelayedInTimer.async_wait(
+            [self]() {
+                auto s = self.lock();
+                if (s)
+                {
+                    s->processDelayedInQueue();
+                }
+            },
+            &VirtualTimer::onFailureNoop);
+    }
+}
+
 void
 LoopbackPeer::deliverOne()
 {
@@ -239,17 +298,42 @@ LoopbackPeer::deliverOne()
         auto remote = mRemote.lock();
         if (remote)
         {
-            // move msg to remote's in queue
-            remote->mInQueue.emplace(std::move(msg.mMessage));
-            remote->getApp().postOnMainThread(
-                [remW = mRemote]() {
-                    auto remS = remW.lock();
-                    if (remS)
-                    {
-                        remS->processInQueue();
-                    }
-                },
-                "LoopbackPeer: processInQueue in deliverOne");
+            // only draw from gRandomEngine for links that were set up to be
+            // imperfect, so that other tests stay reproducible
+            auto now = remote->getApp().getClock().now();
+            auto when = now + mDelay;
+            if (mDelayJitter.b() > 0)
+            {
+                when += std::chrono::milliseconds(mDelayJitter(gRandomEngine));
+            }
+            if (mLossProb.p() > 0.0 && mLossProb(gRandomEngine))
+            {
+                mStats.messagesLost++;
+                when += getRetransmitDelay();
+            }
+            // messages can't overtake each other on the link
+            when = std::max(when, mLastDeliveryTime);
+            mLastDeliveryTime = when;
+
+            if (when > now)
+            {
+                mStats.messagesDelayed++;
+                remote->recvDelayed(std::move(msg.mMessage), when);
+            }
+            else
+            {
+                // move msg to remote's in queue
+                remote->mInQueue.emplace(std::move(msg.mMessage));
+                remote->getApp().postOnMainThread(
+                    [remW = mRemote]() {
+                        auto remS = remW.lock();
+                        if (remS)
+                        {
+                            remS->processInQueue();
+                        }
+                    },
+                    "LoopbackPeer: processInQueue in deliverOne");
+            }
         }
         LoadManager::PeerContext loadCtx(mApp, mPeerID);
         mLastWrite = mApp.getClock().now();
@@ -317,6 +401,8 @@ LoopbackPeer::clearInAndOutQueues()
 {
     mOutQueue.clear();
     mInQueue = std::queue<xdr::msg_ptr>();
+    mDelayedInQueue.clear();
+    mDelayedInTimer.cancel();
 }
 
 bool
@@ -428,6 +514,44 @@ LoopbackPeer::setReorderProbability(double d)
     mReorderProb = bernoulli_distribution(d);
 }
 
+std::chrono::milliseconds
+LoopbackPeer::getDelay() const
+{
+    return mDelay;
+}
+
+std::chrono::milliseconds
+LoopbackPeer::getDelayJitter() const
+{
+    return std::chrono::milliseconds(mDelayJitter.b());
+}
+
+void
+LoopbackPeer::setDelay(std::chrono::milliseconds delay,
+                       std::chrono::milliseconds jitter)
+{
+    if (delay.count() < 0 || jitter.count() < 0)
+    {
+        throw std::runtime_error("delay out of range");
+    }
+    mDelay = delay;
+    mDelayJitter =
+        uniform_int_distribution<int>(0, static_cast<int>(jitter.count()));
+}
+
+double
+LoopbackPeer::getLossProbability() const
+{
+    return mLossProb.p();
+}
+
+void
+LoopbackPeer::setLossProbability(double d)
+{
+    checkProbRange(d);
+    mLossProb = bernoulli_distribution(d);
+}
+
 LoopbackPeerConnection::LoopbackPeerConnection(Application& initiator,
                                                Application& acceptor)
     : mInitiator(make_shared<LoopbackPeer>(initiator, Peer::WE_CALLED_REMOTE))
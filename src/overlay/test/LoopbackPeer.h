@@ -5,6 +5,7 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "overlay/Peer.h"
+#include <chrono>
 #include <deque>
 #include <random>
 
@@ -39,12 +40,27 @@ class LoopbackPeer : public Peer
     std::bernoulli_distribution mDamageProb{0.0};
     std::bernoulli_distribution mDropProb{0.0};
 
+    // Simulated link: messages reach the remote after mDelay plus up to
+    // mDelayJitter, in order. A lost message is retransmitted after
+    // mRetransmitDelay, holding back the ones queued behind it as TCP would.
+    std::chrono::milliseconds mDelay{0};
+    std::uniform_int_distribution<int> mDelayJitter{0, 0};
+    std::bernoulli_distribution mLossProb{0.0};
+    VirtualClock::time_point mLastDeliveryTime;
+
+    // messages sent to us on a delayed link, by delivery time
+    std::deque<std::pair<VirtualClock::time_point, xdr::msg_ptr>>
+        mDelayedInQueue;
+    VirtualTimer mDelayedInTimer;
+
     struct Stats
     {
         size_t messagesDuplicated{0};
         size_t messagesReordered{0};
         size_t messagesDamaged{0};
         size_t messagesDropped{0};
+        size_t messagesDelayed{0};
+        size_t messagesLost{0};
 
         size_t bytesDelivered{0};
         size_t messagesDelivered{0};
@@ -57,6 +73,10 @@ class LoopbackPeer : public Peer
 
     void processInQueue();
 
+    VirtualClock::duration getRetransmitDelay() const;
+    void recvDelayed(xdr::msg_ptr&& msg, VirtualClock::time_point when);
+    void processDelayedInQueue();
+
     std::string mDropReason;
 
   public:
@@ -102,6 +122,14 @@ class LoopbackPeer : public Peer
     double getReorderProbability() const;
     void setReorderProbability(double d);
 
+    std::chrono::milliseconds getDelay() const;
+    std::chrono::milliseconds getDelayJitter() const;
+    void setDelay(std::chrono::milliseconds delay,
+                  std::chrono::milliseconds jitter);
+
+    double getLossProbability() const;
+    void setLossProbability(double d);
+
     void clearInAndOutQueues();
 
     std::string
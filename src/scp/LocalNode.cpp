@@ -122,6 +122,39 @@ LocalNode::getNodeWeight(NodeID const& nodeID, SCPQuorumSet const& qset)
     return 0;
 }
 
+std::map<NodeID, uint64>
+LocalNode::getNodeWeights(SCPQuorumSet const& qset)
+{
+    uint64 n = qset.threshold;
+    uint64 d = qset.innerSets.size() + qset.validators.size();
+    std::map<NodeID, uint64> res;
+
+    // mirrors the search order of getNodeWeight: validators first, then
+    // inner sets in order, the first occurrence of a node wins
+    for (auto const& qsetNode : qset.validators)
+    {
+        res.emplace(qsetNode, computeWeight(UINT64_MAX, d, n));
+    }
+
+    for (auto const& q : qset.innerSets)
+    {
+        for (auto const& leaf : getNodeWeights(q))
+        {
+            if (leaf.second && res.find(leaf.first) == res.end())
+            {
+                res.emplace(leaf.first, computeWeight(leaf.second, d, n));
+            }
+        }
+    }
+
+    // getNodeWeight returns 0 for nodes absent from qset
+    for (auto it = res.begin(); it != res.end();)
+    {
+        it = it->second ? std::next(it) : res.erase(it);
+    }
+    return res;
+}
+
 bool
 LocalNode::isQuorumSliceInternal(SCPQuorumSet const& qset,
                                  std::vector<NodeID> const& nodeSet)
@@ -4,6 +4,7 @@
 // under the Apache License, Version 2.0. See the COPYING file at the root
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
+#include <map>
 #include <memory>
 #include <set>
 #include <vector>
@@ -53,6 +54,10 @@ class LocalNode
     // normalized between 0-UINT64_MAX
     static uint64 getNodeWeight(NodeID const& nodeID, SCPQuorumSet const& qset);
 
+    // returns the weight of all nodes with a non zero weight within the qset,
+    // in a single pass over qset (same values as getNodeWeight)
+    static std::map<NodeID, uint64> getNodeWeights(SCPQuorumSet const& qset);
+
     // Tests this node against nodeSet for the specified qSethash.
     static bool isQuorumSlice(SCPQuorumSet const& qSet,
                               std::vector<NodeID> const& nodeSet);
@@ -22,7 +22,10 @@ namespace stellar
 using namespace std::placeholders;
 
 NominationProtocol::NominationProtocol(Slot& slot)
-    : mSlot(slot), mRoundNumber(0), mNominationStarted(false)
+    : mSlot(slot)
+    , mRoundNumber(0)
+    , mLeadersRoundNumber(-1)
+    , mNominationStarted(false)
 {
 }
 
@@ -213,21 +216,48 @@ NominationProtocol::applyAll(SCPNomination const& nom,
     }
 }
 
+bool
+NominationProtocol::updateNodeWeights()
+{
+    auto const& qSetHash = mSlot.getLocalNode()->getQuorumSetHash();
+    if (mNodeWeightsQSetHash == qSetHash)
+    {
+        return false;
+    }
+
+    SCPQuorumSet myQSet = mSlot.getLocalNode()->getQuorumSet();
+    auto localID = mSlot.getLocalNode()->getNodeID();
+    normalizeQSet(myQSet, &localID);
+
+    mNodeWeights = LocalNode::getNodeWeights(myQSet);
+    mNodeWeightsQSetHash = qSetHash;
+    return true;
+}
+
 void
 NominationProtocol::updateRoundLeaders()
 {
-    SCPQuorumSet myQSet = mSlot.getLocalNode()->getQuorumSet();
+    bool weightsChanged = updateNodeWeights();
+    if (!weightsChanged && mLeadersRoundNumber == mRoundNumber &&
+        mLeadersPreviousValue == mPreviousValue)
+    {
+        // leaders for this round were already computed
+        return;
+    }
+    mLeadersRoundNumber = mRoundNumber;
+    mLeadersPreviousValue = mPreviousValue;
 
     // initialize priority with value derived from self
     std::set<NodeID> newRoundLeaders;
     auto localID = mSlot.getLocalNode()->getNodeID();
-    normalizeQSet(myQSet, &localID);
 
     newRoundLeaders.insert(localID);
-    uint64 topPriority = getNodePriority(localID, myQSet);
+    // local node is in all quorum sets
+    uint64 topPriority = getNodePriority(localID, UINT64_MAX);
 
-    LocalNode::forAllNodes(myQSet, [&](NodeID const& cur) {
-        uint64 w = getNodePriority(cur, myQSet);
+    for (auto const& nw : mNodeWeights)
+    {
+        uint64 w = getNodePriority(nw.first, nw.second);
         if (w > topPriority)
         {
             topPriority = w;
@@ -235,9 +265,9 @@ NominationProtocol::updateRoundLeaders()
         }
         if (w == topPriority && w > 0)
         {
-            newRoundLeaders.insert(cur);
+            newRoundLeaders.insert(nw.first);
         }
-    });
+    }
     // expand mRoundLeaders with the newly computed leaders
     mRoundLeaders.insert(newRoundLeaders.begin(), newRoundLeaders.end());
     if (Logging::logDebug("SCP"))
@@ -272,7 +302,6 @@ uint64
 NominationProtocol::getNodePriority(NodeID const& nodeID,
                                     SCPQuorumSet const& qset)
 {
-    uint64 res;
     uint64 w;
 
     if (nodeID == mSlot.getLocalNode()->getNodeID())
@@ -285,9 +314,17 @@ NominationProtocol::getNodePriority(NodeID const& nodeID,
         w = LocalNode::getNodeWeight(nodeID, qset);
     }
 
-    // if w > 0; w is inclusive here as
+    return getNodePriority(nodeID, w);
+}
+
+uint64
+NominationProtocol::getNodePriority(NodeID const& nodeID, uint64 weight)
+{
+    uint64 res;
+
+    // if weight > 0; weight is inclusive here as
     // 0 <= hashNode <= UINT64_MAX
-    if (w > 0 && hashNode(false, nodeID) <= w)
+    if (weight > 0 && hashNode(false, nodeID) <= weight)
     {
         res = hashNode(true, nodeID);
     }
@@ -31,6 +31,15 @@ class NominationProtocol
     // nodes from quorum set that have the highest priority this round
     std::set<NodeID> mRoundLeaders;
 
+    // weights of the nodes of the normalized local quorum set, computed once
+    // per quorum set rather than for every node on every round
+    Hash mNodeWeightsQSetHash;
+    std::map<NodeID, uint64> mNodeWeights;
+
+    // round and previous value that mRoundLeaders was last updated for
+    int32 mLeadersRoundNumber;
+    Value mLeadersPreviousValue;
+
     // true if 'nominate' was called
     bool mNominationStarted;
 
@@ -69,6 +78,10 @@ class NominationProtocol
     // updates the set of nodes that have priority over the others
     void updateRoundLeaders();
 
+    // recomputes mNodeWeights if the local quorum set changed,
+    // returns true if it did
+    bool updateNodeWeights();
+
     // computes Gi(isPriority?P:N, prevValue, mRoundNumber, nodeID)
     // from the paper
     uint64 hashNode(bool isPriority, NodeID const& nodeID);
@@ -77,6 +90,7 @@ class NominationProtocol
     uint64 hashValue(Value const& value);
 
     uint64 getNodePriority(NodeID const& nodeID, SCPQuorumSet const& qset);
+    uint64 getNodePriority(NodeID const& nodeID, uint64 weight);
 
     // returns the highest value that we don't have yet, that we should
     // vote for, extracted from a nomination.
@@ -5,6 +5,7 @@
 #include "simulation/Simulation.h"
 #include "util/Logging.h"
 #include "xdrpp/marshal.h"
+#include <chrono>
 
 namespace stellar
 {
@@ -47,6 +48,21 @@ TEST_CASE("nomination weight", "[scp]")
     result = LocalNode::getNodeWeight(v4NodeID, qSet);
 
     REQUIRE(isNear(result, .6 * .5));
+
+    SECTION("all weights at once")
+    {
+        // v2 also appears in the inner set: the first occurrence wins
+        qSet.innerSets[0].validators.push_back(v2NodeID);
+
+        auto weights = LocalNode::getNodeWeights(qSet);
+        REQUIRE(weights.size() == 6);
+        for (auto const& id :
+             {v0NodeID, v1NodeID, v2NodeID, v3NodeID, v4NodeID, v5NodeID})
+        {
+            REQUIRE(weights[id] == LocalNode::getNodeWeight(id, qSet));
+        }
+        REQUIRE(isNear(weights[v2NodeID], .6));
+    }
 }
 
 class TestNominationSCP : public SCPDriver
@@ -418,4 +434,60 @@ TEST_CASE("nomination two nodes win stats", "[scp][!hide]")
         }
     }
 }
+
+// measures the cost of computing round leaders as the local quorum set grows
+TEST_CASE("nomination leader selection bench", "[scp][bench][!hide]")
+{
+    int const nbRounds = 100;
+
+    auto runBench = [&](SCPQuorumSet const& qSet, NodeID const& localID) {
+        TestNominationSCP nomSCP(localID, qSet);
+        Slot slot(0, nomSCP.mSCP);
+        NominationTestHandler nom(slot);
+
+        Value v;
+        v.emplace_back(uint8_t(1));
+        nom.setPreviousValue(v);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < nbRounds; r++)
+        {
+            nom.setRoundNumber(r);
+            nom.updateRoundLeaders();
+            REQUIRE(!nom.getRoundLeaders().empty());
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        auto us =
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+        return us.count() / nbRounds;
+    };
+
+    for (int size : {10, 50, 100, 500, 1000})
+    {
+        std::vector<NodeID> nodeIDs;
+        for (int i = 0; i < size; i++)
+        {
+            auto seed = sha256("NODE_SEED_" + std::to_string(i));
+            nodeIDs.emplace_back(SecretKey::fromSeed(seed).getPublicKey());
+        }
+
+        // flat quorum set, 2/3 threshold
+        auto flat = makeQSet(nodeIDs, (size * 2 + 2) / 3, size, 0);
+        auto flatTime = runBench(flat, nodeIDs[0]);
+
+        // same validators split into organizations of 5
+        SCPQuorumSet orgs;
+        int nbOrgs = size / 5;
+        for (int o = 0; o < nbOrgs; o++)
+        {
+            orgs.innerSets.emplace_back(makeQSet(nodeIDs, 3, 5, o * 5));
+        }
+        orgs.threshold = (nbOrgs * 2 + 2) / 3;
+        auto orgsTime = runBench(orgs, nodeIDs[0]);
+
+        CLOG(INFO, "SCP") << "qset size " << size << ": flat " << flatTime
+                          << "us/round, organizations " << orgsTime
+                          << "us/round";
+    }
+}
 }
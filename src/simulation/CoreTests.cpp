@@ -25,6 +25,9 @@
 #include "util/format.h"
 #include "util/types.h"
 #include "xdrpp/autocheck.h"
+#include <algorithm>
+#include <ctime>
+#include <map>
 #include <sstream>
 
 using namespace stellar;
@@ -657,3 +660,198 @@ TEST_CASE("Bucket list entries vs write throughput", "[scalability][!hide]")
         }
     }
 }
+
+// Consensus latency benchmark. Runs SCP over a virtual time simulation with
+// the given link conditions and reports, per network size:
+//   * percentiles of the time between two ledgers externalized by a node and
+//     of the time between the first and the last node externalizing a ledger
+//   * the worst per node 99th percentile of the nomination and ballot phases
+//   * messages sent and CPU time spent by the whole simulation per ledger
+static void
+scpBenchmark(std::string const& name,
+             std::function<Simulation::pointer(int numNodes)> mkSim,
+             std::vector<int> const& sizes)
+{
+    int const nLedgers = 20;
+
+    std::vector<std::pair<std::string, Simulation::LinkConditions>> links;
+    links.emplace_back("perfect", Simulation::LinkConditions{});
+    links.emplace_back(
+        "delay", Simulation::LinkConditions{std::chrono::milliseconds(100),
+                                            std::chrono::milliseconds(50),
+                                            0.0});
+    links.emplace_back(
+        "lossy", Simulation::LinkConditions{std::chrono::milliseconds(100),
+                                            std::chrono::milliseconds(50),
+                                            0.01});
+
+    auto percentile = [](std::vector<double> v, double q) {
+        if (v.empty())
+        {
+            return 0.0;
+        }
+        std::sort(v.begin(), v.end());
+        auto i = static_cast<size_t>(q * (v.size() - 1));
+        return v[i];
+    };
+    auto toMs = [](VirtualClock::duration d) {
+        return static_cast<double>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(d).count());
+    };
+
+    for (auto const& link : links)
+    {
+        ScaleReporter r({name + link.first + "nodes", "interval50",
+                         "interval99", "spread50", "spread99", "nominate99",
+                         "ballot99", "msgsperledger", "cpumsperledger"});
+
+        for (int numNodes : sizes)
+        {
+            auto sim = mkSim(numNodes);
+            sim->setLinkConditions(link.second);
+            sim->startAllNodes();
+
+            // let all nodes connect and get past the first ledger
+            sim->crankUntil([&]() { return sim->haveAllExternalized(3, 2); },
+                            20 * Herder::EXP_LEDGER_TIMESPAN_SECONDS, false);
+
+            auto nodes = sim->getNodes();
+            std::vector<uint32_t> lastSeq;
+            std::vector<VirtualClock::time_point> lastTime;
+            int64_t msgs = 0;
+            for (auto const& app : nodes)
+            {
+                lastSeq.emplace_back(
+                    app->getLedgerManager().getLastClosedLedgerNum());
+                lastTime.emplace_back(app->getClock().now());
+                msgs -= app->getMetrics()
+                            .NewMeter({"overlay", "message", "write"},
+                                      "message")
+                            .count();
+            }
+            uint32_t startSeq =
+                *std::max_element(lastSeq.begin(), lastSeq.end());
+            uint32_t endSeq = startSeq + nLedgers;
+
+            std::vector<double> intervals;
+            std::map<uint32_t, std::pair<VirtualClock::time_point,
+                                         VirtualClock::time_point>>
+                firstLast;
+            auto cpuStart = std::clock();
+
+            auto checkNodes = [&]() {
+                bool done = true;
+                for (size_t i = 0; i < nodes.size(); i++)
+                {
+                    auto& app = *nodes[i];
+                    auto seq = app.getLedgerManager().getLastClosedLedgerNum();
+                    if (seq > lastSeq[i])
+                    {
+                        auto now = app.getClock().now();
+                        if (lastSeq[i] >= startSeq)
+                        {
+                            intervals.emplace_back(toMs(now - lastTime[i]));
+                        }
+                        auto it =
+                            firstLast.emplace(seq, std::make_pair(now, now));
+                        it.first->second.second = now;
+                        lastSeq[i] = seq;
+                        lastTime[i] = now;
+                    }
+                    done = done && seq >= endSeq;
+                }
+                return done;
+            };
+            sim->crankUntil(checkNodes,
+                            4 * nLedgers * Herder::EXP_LEDGER_TIMESPAN_SECONDS,
+                            false);
+            double cpuMs = 1000.0 * (std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+            std::vector<double> spreads;
+            for (auto const& fl : firstLast)
+            {
+                if (fl.first > startSeq && fl.first <= endSeq)
+                {
+                    spreads.emplace_back(
+                        toMs(fl.second.second - fl.second.first));
+                }
+            }
+
+            double nominate99 = 0.0;
+            double ballot99 = 0.0;
+            for (auto const& app : nodes)
+            {
+                auto& metrics = app->getMetrics();
+                msgs += metrics
+                            .NewMeter({"overlay", "message", "write"},
+                                      "message")
+                            .count();
+                auto& nominated =
+                    metrics.NewTimer({"scp", "timing", "nominated"});
+                auto& externalized =
+                    metrics.NewTimer({"scp", "timing", "externalized"});
+                nominate99 = std::max(
+                    nominate99, nominated.GetSnapshot().get99thPercentile());
+                ballot99 = std::max(
+                    ballot99, externalized.GetSnapshot().get99thPercentile());
+            }
+
+            r.write({(double)numNodes, percentile(intervals, 0.5),
+                     percentile(intervals, 0.99), percentile(spreads, 0.5),
+                     percentile(spreads, 0.99), nominate99, ballot99,
+                     (double)msgs / nLedgers, cpuMs / nLedgers});
+            sim->stopAllNodes();
+        }
+    }
+}
+
+static Config
+scpBenchmarkConfig(int cfgNum)
+{
+    Config res = getTestConfig(cfgNum);
+    res.TARGET_PEER_CONNECTIONS = 1000;
+    res.MAX_ADDITIONAL_PEER_CONNECTIONS = 1000;
+    return res;
+}
+
+TEST_CASE("SCP consensus latency benchmark", "[scalability][scpbench][!hide]")
+{
+    SECTION("core")
+    {
+        scpBenchmark(
+            "core",
+            [](int numNodes) {
+                return Topologies::core(
+                    numNodes, 0.67, Simulation::OVER_LOOPBACK,
+                    sha256(fmt::format("nodes-{:d}", numNodes)),
+                    scpBenchmarkConfig);
+            },
+            {10, 25, 50});
+    }
+    SECTION("tier1")
+    {
+        // organizations of 3 validators
+        scpBenchmark(
+            "tier1",
+            [](int numNodes) {
+                return Topologies::tier1(
+                    numNodes / 3, 3, Simulation::OVER_LOOPBACK,
+                    sha256(fmt::format("nodes-{:d}", numNodes)),
+                    scpBenchmarkConfig);
+            },
+            {12, 21, 30, 51});
+    }
+    SECTION("hierarchical")
+    {
+        // a core of 10 validators and watchers connected to 2 of them
+        scpBenchmark(
+            "hierarchical",
+            [](int numNodes) {
+                return Topologies::hierarchicalQuorumSimplified(
+                    10, numNodes - 10, Simulation::OVER_LOOPBACK,
+                    sha256(fmt::format("nodes-{:d}", numNodes)),
+                    scpBenchmarkConfig, 2);
+            },
+            {50, 100, 250, 500});
+    }
+}
@@ -217,10 +217,31 @@ Simulation::addLoopbackConnection(NodeID initiator, NodeID acceptor)
     {
         auto conn = std::make_shared<LoopbackPeerConnection>(
             *getNode(initiator), *getNode(acceptor));
+        applyLinkConditions(*conn);
         mLoopbackConnections.push_back(conn);
     }
 }
 
+void
+Simulation::setLinkConditions(LinkConditions const& conditions)
+{
+    mLinkConditions = conditions;
+    for (auto const& conn : mLoopbackConnections)
+    {
+        applyLinkConditions(*conn);
+    }
+}
+
+void
+Simulation::applyLinkConditions(LoopbackPeerConnection& conn) const
+{
+    for (auto const& peer : {conn.getInitiator(), conn.getAcceptor()})
+    {
+        peer->setDelay(mLinkConditions.mDelay, mLinkConditions.mDelayJitter);
+        peer->setLossProbability(mLinkConditions.mLossProbability);
+    }
+}
+
 std::shared_ptr<LoopbackPeerConnection>
 Simulation::getLoopbackConnection(NodeID const& initiator,
                                   NodeID const& acceptor)
@@ -37,6 +37,14 @@ class Simulation
     using ConfigGen = std::function<Config(int i)>;
     using QuorumSetAdjuster = std::function<SCPQuorumSet(SCPQuorumSet const&)>;
 
+    // conditions simulated on loopback connections, see LoopbackPeer
+    struct LinkConditions
+    {
+        std::chrono::milliseconds mDelay{0};
+        std::chrono::milliseconds mDelayJitter{0};
+        double mLossProbability{0.0};
+    };
+
     Simulation(Mode mode, Hash const& networkID, ConfigGen = nullptr,
                QuorumSetAdjuster = nullptr);
     ~Simulation();
@@ -72,6 +80,10 @@ class Simulation
     void crankUntil(VirtualClock::time_point timePoint, bool finalCrank);
     std::string metricsSummary(std::string domain = "");
 
+    // applies to both directions of all current and future loopback
+    // connections
+    void setLinkConditions(LinkConditions const& conditions);
+
     void addConnection(NodeID initiator, NodeID acceptor);
     void dropConnection(NodeID initiator, NodeID acceptor);
     Config newConfig(); // generates a new config
@@ -102,6 +114,9 @@ class Simulation
     std::map<NodeID, Node> mNodes;
     std::vector<std::pair<NodeID, NodeID>> mPendingConnections;
     std::vector<std::shared_ptr<LoopbackPeerConnection>> mLoopbackConnections;
+    LinkConditions mLinkConditions;
+
+    void applyLinkConditions(LoopbackPeerConnection& conn) const;
 
     ConfigGen mConfigGen; // config generator
 
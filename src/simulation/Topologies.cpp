@@ -289,6 +289,47 @@ Topologies::hierarchicalQuorumSimplified(
     return sim;
 }
 
+Simulation::pointer
+Topologies::tier1(int nOrgs, int nodesPerOrg, Simulation::Mode mode,
+                  Hash const& networkID, Simulation::ConfigGen confGen,
+                  Simulation::QuorumSetAdjuster qSetAdjust)
+{
+    Simulation::pointer simulation =
+        make_shared<Simulation>(mode, networkID, confGen, qSetAdjust);
+
+    vector<SecretKey> keys;
+    SCPQuorumSet qSet;
+    qSet.threshold = nOrgs - (nOrgs - 1) / 3;
+    for (int i = 0; i < nOrgs; i++)
+    {
+        SCPQuorumSet orgQSet;
+        orgQSet.threshold = nodesPerOrg - (nodesPerOrg - 1) / 3;
+        for (int j = 0; j < nodesPerOrg; j++)
+        {
+            keys.push_back(SecretKey::fromSeed(sha256(
+                "ORG_" + to_string(i) + "_NODE_SEED_" + to_string(j))));
+            orgQSet.validators.push_back(keys.back().getPublicKey());
+        }
+        qSet.innerSets.push_back(orgQSet);
+    }
+
+    for (auto const& k : keys)
+    {
+        simulation->addNode(k, qSet);
+    }
+
+    for (size_t from = 0; from + 1 < keys.size(); from++)
+    {
+        for (size_t to = from + 1; to < keys.size(); to++)
+        {
+            simulation->addPendingConnection(keys[from].getPublicKey(),
+                                             keys[to].getPublicKey());
+        }
+    }
+
+    return simulation;
+}
+
 Simulation::pointer
 Topologies::customA(Simulation::Mode mode, Hash const& networkID,
                     Simulation::ConfigGen confGen, int connections,
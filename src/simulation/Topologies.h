@@ -64,6 +64,14 @@ class Topologies
         int connectionsToCore = 1,
         Simulation::QuorumSetAdjuster qSetAdjust = nullptr);
 
+    // nOrgs organizations of nodesPerOrg validators each - mesh network
+    // every validator uses the same 2 level qset: a 2/3 majority of
+    // organizations, each of them being a 2/3 majority of its validators
+    static Simulation::pointer
+    tier1(int nOrgs, int nodesPerOrg, Simulation::Mode mode,
+          Hash const& networkID, Simulation::ConfigGen confGen = nullptr,
+          Simulation::QuorumSetAdjuster qSetAdjust = nullptr);
+
     // custom-A
     static Simulation::pointer
     customA(Simulation::Mode mode, Hash const& networkID,
@@ -289,6 +289,22 @@ FeeBumpTransactionFrame::getInnerFullHash() const
     return mInnerTx->getFullHash();
 }
 
+void
+FeeBumpTransactionFrame::preverifySignatures() const
+{
+    getFullHash();
+    auto const& contentsHash = getContentsHash();
+
+    auto feeSource = KeyUtils::convertKey<SignerKey>(getFeeSourceID());
+    for (auto const& sig : mEnvelope.feeBump().signatures)
+    {
+        // the result is cached by PubKeyUtils::verifySig
+        SignatureUtils::verify(sig, feeSource, contentsHash);
+    }
+
+    mInnerTx->preverifySignatures();
+}
+
 uint32_t
 FeeBumpTransactionFrame::getNumOperations() const
 {
@@ -69,6 +69,8 @@ class FeeBumpTransactionFrame : public TransactionFrameBase
     Hash const& getFullHash() const override;
     Hash const& getInnerFullHash() const;
 
+    void preverifySignatures() const override;
+
     uint32_t getNumOperations() const override;
 
     TransactionResult& getResult() override;
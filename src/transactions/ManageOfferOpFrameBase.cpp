@@ -282,8 +282,7 @@ ManageOfferOpFrameBase::doApply(AbstractLedgerTxn& ltxOuter)
         ConvertResult r = convertWithOffers(
             ltx, mSheep, maxSheepSend, sheepSent, mWheat, maxWheatReceive,
             wheatReceived, RoundingType::NORMAL,
-            [this, passive, &maxWheatPrice](LedgerTxnEntry const& entry) {
-                auto const& o = entry.current().data.offer();
+            [this, passive, &maxWheatPrice](OfferEntry const& o) {
                 assert(o.offerID != mOfferID);
                 if ((passive && (o.price >= maxWheatPrice)) ||
                     (o.price > maxWheatPrice))
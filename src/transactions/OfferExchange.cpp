@@ -1208,7 +1208,7 @@ convertWithOffers(
     AbstractLedgerTxn& ltxOuter, Asset const& sheep, int64_t maxSheepSend,
     int64_t& sheepSend, Asset const& wheat, int64_t maxWheatReceive,
     int64_t& wheatReceived, RoundingType round,
-    std::function<OfferFilterResult(LedgerTxnEntry const&)> filter,
+    std::function<OfferFilterResult(OfferEntry const&)> filter,
     std::vector<ClaimOfferAtom>& offerTrail, int64_t maxOffersToCross)
 {
     // If offerTrail is not empty at the start, then the limit maxOffersToCross
@@ -1218,31 +1218,44 @@ convertWithOffers(
     sheepSend = 0;
     wheatReceived = 0;
 
+    // All the offers are crossed in this LedgerTxn, which is committed once
+    // whatever the result: an offer is only recorded in it (by loadBestOffer,
+    // which also lets the next call skip the offers crossed so far) when it is
+    // about to be crossed, so stopping before crossing it leaves no trace.
+    // loadBestOffer is given the offer found by getBestOffer, so that the
+    // order book is only searched once per offer.
+    LedgerTxn ltx(ltxOuter);
+    auto ledgerVersion = ltx.loadHeader().current().ledgerVersion;
+    auto result = ConvertResult::eOK;
+
     bool needMore = (maxWheatReceive > 0 && maxSheepSend > 0);
     while (needMore)
     {
-        LedgerTxn ltx(ltxOuter);
-        auto wheatOffer = ltx.loadBestOffer(sheep, wheat);
-        if (!wheatOffer)
+        auto bestOffer = ltx.getBestOffer(sheep, wheat);
+        if (!bestOffer)
         {
             break;
         }
-        if (filter && filter(wheatOffer) == OfferFilterResult::eStop)
+        if (filter &&
+            filter(bestOffer->data.offer()) == OfferFilterResult::eStop)
         {
-            return ConvertResult::eFilterStop;
+            result = ConvertResult::eFilterStop;
+            break;
         }
 
         // Note: maxOffersToCross == INT64_MAX before protocol version 11
         if (offerTrail.size() >= static_cast<uint64_t>(maxOffersToCross))
         {
-            return ConvertResult::eCrossedTooMany;
+            result = ConvertResult::eCrossedTooMany;
+            break;
         }
 
         int64_t numWheatReceived;
         int64_t numSheepSend;
         CrossOfferResult cor;
-        if (ltx.loadHeader().current().ledgerVersion >= 10)
+        if (ledgerVersion >= 10)
         {
+            auto wheatOffer = ltx.loadBestOffer(sheep, wheat, bestOffer);
             bool wheatStays;
             cor = crossOfferV10(ltx, wheatOffer, maxWheatReceive,
                                 numWheatReceived, maxSheepSend, numSheepSend,
@@ -1251,8 +1264,17 @@ convertWithOffers(
         }
         else
         {
-            cor = crossOffer(ltx, wheatOffer, maxWheatReceive, numWheatReceived,
-                             maxSheepSend, numSheepSend, offerTrail);
+            // crossOffer can fail after modifying the ledger, in which case
+            // the changes made to cross this offer must be rolled back
+            LedgerTxn ltxOffer(ltx);
+            auto wheatOffer = ltxOffer.loadBestOffer(sheep, wheat, bestOffer);
+            cor = crossOffer(ltxOffer, wheatOffer, maxWheatReceive,
+                             numWheatReceived, maxSheepSend, numSheepSend,
+                             offerTrail);
+            if (cor != CrossOfferResult::eOfferCantConvert)
+            {
+                ltxOffer.commit();
+            }
             needMore = true;
         }
 
@@ -1263,9 +1285,9 @@ convertWithOffers(
 
         if (cor == CrossOfferResult::eOfferCantConvert)
         {
-            return ConvertResult::ePartial;
+            result = ConvertResult::ePartial;
+            break;
         }
-        ltx.commit();
 
         sheepSend += numSheepSend;
         maxSheepSend -= numSheepSend;
@@ -1276,20 +1298,21 @@ convertWithOffers(
         needMore = needMore && (maxWheatReceive > 0 && maxSheepSend > 0);
         if (!needMore)
         {
-            return ConvertResult::eOK;
+            break;
         }
         else if (cor == CrossOfferResult::eOfferPartial)
         {
-            return ConvertResult::ePartial;
+            result = ConvertResult::ePartial;
+            needMore = false;
+            break;
         }
     }
-    if ((ltxOuter.loadHeader().current().ledgerVersion < 10) || !needMore)
-    {
-        return ConvertResult::eOK;
-    }
-    else
+    ltx.commit();
+
+    if (result == ConvertResult::eOK && ledgerVersion >= 10 && needMore)
     {
         return ConvertResult::ePartial;
     }
+    return result;
 }
 }
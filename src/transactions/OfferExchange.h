@@ -311,6 +311,6 @@ ConvertResult convertWithOffers(
     AbstractLedgerTxn& ltx, Asset const& sheep, int64_t maxSheepSent,
     int64_t& sheepSend, Asset const& wheat, int64_t maxWheatReceive,
     int64_t& wheatReceived, RoundingType round,
-    std::function<OfferFilterResult(LedgerTxnEntry const&)> filter,
+    std::function<OfferFilterResult(OfferEntry const&)> filter,
     std::vector<ClaimOfferAtom>& offerTrail, int64_t maxOffersToCross);
 }
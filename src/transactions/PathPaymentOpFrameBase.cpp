@@ -67,9 +67,7 @@ PathPaymentOpFrameBase::convert(AbstractLedgerTxn& ltx,
     // sendAsset -> recvAsset
     ConvertResult r = convertWithOffers(ltx, sendAsset, maxSend, amountSend,
                                         recvAsset, maxRecv, amountRecv, round,
-                                        [this](LedgerTxnEntry const& o) {
-                                            auto const& offer =
-                                                o.current().data.offer();
+                                        [this](OfferEntry const& offer) {
                                             if (offer.sellerID == getSourceID())
                                             {
                                                 // we are crossing our own offer
@@ -38,6 +38,11 @@ PaymentOpFrame::doApply(AbstractLedgerTxn& ltx)
         return true;
     }
 
+    if (mPayment.asset.type() == ASSET_TYPE_NATIVE)
+    {
+        return doApplyNative(ltx, ledgerVersion);
+    }
+
     // build a pathPaymentOp
     Operation op;
     op.sourceAccount = mOperation.sourceAccount;
@@ -108,6 +113,83 @@ PaymentOpFrame::doApply(AbstractLedgerTxn& ltx)
     return true;
 }
 
+// Applies a native payment exactly like the equivalent
+// PathPaymentStrictReceiveOp built by doApply would (loading and updating the
+// same entries in the same order, and failing in the same cases) without
+// building it.
+bool
+PaymentOpFrame::doApplyNative(AbstractLedgerTxn& ltx, uint32_t ledgerVersion)
+{
+    // results of the path payment that doApply does not expect
+    auto unexpected = []() {
+        return std::runtime_error(
+            "Unexpected error code from pathPaymentStrictReceive");
+    };
+
+    if (mPayment.amount <= 0)
+    {
+        throw unexpected();
+    }
+
+    bool doesSourceAccountExist = true;
+    if (ledgerVersion < 8)
+    {
+        doesSourceAccountExist =
+            (bool)stellar::loadAccountWithoutRecord(ltx, getSourceID());
+    }
+
+    if (!stellar::loadAccountWithoutRecord(ltx, mPayment.destination))
+    {
+        innerResult().code(PAYMENT_NO_DESTINATION);
+        return false;
+    }
+
+    {
+        auto destination = stellar::loadAccount(ltx, mPayment.destination);
+        if (!addBalance(ltx.loadHeader(), destination, mPayment.amount))
+        {
+            if (ledgerVersion < 11)
+            {
+                throw unexpected();
+            }
+            innerResult().code(PAYMENT_LINE_FULL);
+            return false;
+        }
+    }
+
+    auto header = ltx.loadHeader();
+    LedgerTxnEntry sourceAccount;
+    if (ledgerVersion > 7)
+    {
+        sourceAccount = stellar::loadAccount(ltx, getSourceID());
+        if (!sourceAccount)
+        {
+            throw unexpected();
+        }
+    }
+    else
+    {
+        sourceAccount = loadSourceAccount(ltx, header);
+    }
+
+    if (mPayment.amount > getAvailableBalance(header, sourceAccount))
+    {
+        innerResult().code(PAYMENT_UNDERFUNDED);
+        return false;
+    }
+
+    if (!doesSourceAccountExist)
+    {
+        throw std::runtime_error("modifying account that does not exist");
+    }
+
+    auto ok = addBalance(header, sourceAccount, -mPayment.amount);
+    assert(ok);
+
+    innerResult().code(PAYMENT_SUCCESS);
+    return true;
+}
+
 bool
 PaymentOpFrame::doCheckValid(uint32_t ledgerVersion)
 {
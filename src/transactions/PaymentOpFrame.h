@@ -19,6 +19,8 @@ class PaymentOpFrame : public OperationFrame
     }
     PaymentOp const& mPayment;
 
+    bool doApplyNative(AbstractLedgerTxn& ltx, uint32_t ledgerVersion);
+
   public:
     PaymentOpFrame(Operation const& op, OperationResult& res,
                    TransactionFrame& parentTx);
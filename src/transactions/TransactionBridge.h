@@ -18,6 +18,8 @@ namespace txbridge
 TransactionEnvelope convertForV13(TransactionEnvelope const& input);
 
 xdr::xvector<DecoratedSignature, 20>& getSignatures(TransactionEnvelope& env);
+xdr::xvector<DecoratedSignature, 20> const&
+getSignatures(TransactionEnvelope const& env);
 
 #ifdef BUILD_TESTS
 xdr::xvector<DecoratedSignature, 20>& getSignatures(TransactionFramePtr tx);
@@ -79,6 +79,31 @@ TransactionFrame::getContentsHash() const
     return (mContentsHash);
 }
 
+void
+TransactionFrame::preverifySignatures() const
+{
+    getFullHash();
+    auto const& contentsHash = getContentsHash();
+
+    // other signers can only be known by loading the accounts
+    std::set<AccountID> accounts;
+    accounts.emplace(getSourceID());
+    for (auto const& op : mOperations)
+    {
+        accounts.emplace(op->getSourceID());
+    }
+
+    for (auto const& sig : getSignatures(mEnvelope))
+    {
+        for (auto const& accountID : accounts)
+        {
+            // the result is cached by PubKeyUtils::verifySig
+            SignatureUtils::verify(
+                sig, KeyUtils::convertKey<SignerKey>(accountID), contentsHash);
+        }
+    }
+}
+
 void
 TransactionFrame::clearCached()
 {
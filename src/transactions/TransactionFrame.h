@@ -116,6 +116,8 @@ class TransactionFrame : public TransactionFrameBase
     Hash const& getFullHash() const override;
     Hash const& getContentsHash() const override;
 
+    void preverifySignatures() const override;
+
     std::vector<std::shared_ptr<OperationFrame>> const&
     getOperations() const
     {
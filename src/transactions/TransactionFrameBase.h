@@ -41,6 +41,12 @@ class TransactionFrameBase
     virtual Hash const& getContentsHash() const = 0;
     virtual Hash const& getFullHash() const = 0;
 
+    // Computes the hashes of this transaction and verifies the signatures
+    // made by the master keys of the accounts it uses. This does not need the
+    // ledger, so it can be done on a worker thread before checkValid (which
+    // then finds the results in the signature verification cache).
+    virtual void preverifySignatures() const = 0;
+
     virtual uint32_t getNumOperations() const = 0;
 
     virtual TransactionResult& getResult() = 0;
@@ -3040,3 +3040,61 @@ TEST_CASE("liabilities match created offer", "[tx][offers]")
     // NOTE: Starting in version 10, it is not possible to create an offer that
     // initially exceeds limits.
 }
+
+TEST_CASE("convertWithOffers only records crossed offers", "[tx][offers]")
+{
+    VirtualClock clock;
+    auto app = createTestApplication(clock, getTestConfig());
+    auto const minBalance = app->getLedgerManager().getLastMinBalance(5);
+
+    auto root = TestAccount::createRoot(*app);
+    auto issuer = root.create("issuer", minBalance);
+    auto seller = root.create("seller", minBalance);
+    auto usd = makeAsset(issuer, "USD");
+    auto native = makeNativeAsset();
+    seller.changeTrust(usd, INT64_MAX);
+    issuer.pay(seller, usd, 1000);
+
+    // offers selling 100 USD each, for 1, 2 and 3 XLM per USD
+    std::vector<int64_t> offerIDs;
+    for (int32_t n = 1; n <= 3; ++n)
+    {
+        offerIDs.emplace_back(
+            seller.manageOffer(0, usd, native, Price{n, 1}, 100));
+    }
+
+    LedgerTxn ltx(app->getLedgerTxnRoot());
+    int64_t sheepSend;
+    int64_t wheatReceived;
+    std::vector<ClaimOfferAtom> offerTrail;
+    auto res = convertWithOffers(
+        ltx, native, INT64_MAX, sheepSend, usd, INT64_MAX, wheatReceived,
+        RoundingType::NORMAL,
+        [](OfferEntry const& o) {
+            return o.price.n >= 3 ? OfferFilterResult::eStop
+                                  : OfferFilterResult::eKeep;
+        },
+        offerTrail, INT64_MAX);
+
+    REQUIRE(res == ConvertResult::eFilterStop);
+    REQUIRE(offerTrail.size() == 2);
+    REQUIRE(wheatReceived == 200);
+    REQUIRE(sheepSend == 300);
+
+    // the offers that were crossed are erased, and the one that stopped the
+    // conversion is left untouched
+    auto delta = ltx.getDelta();
+    for (size_t i = 0; i < offerIDs.size(); ++i)
+    {
+        auto iter = delta.entry.find(offerKey(seller, offerIDs[i]));
+        if (i < 2)
+        {
+            REQUIRE(iter != delta.entry.end());
+            REQUIRE(!iter->second.current);
+        }
+        else
+        {
+            REQUIRE(iter == delta.entry.end());
+        }
+    }
+}
@@ -2,6 +2,8 @@
 // under the Apache License, Version 2.0. See the COPYING file at the root
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
+#include "database/Database.h"
+#include "ledger/LedgerManager.h"
 #include "ledger/LedgerTxn.h"
 #include "ledger/LedgerTxnEntry.h"
 #include "ledger/LedgerTxnHeader.h"
@@ -13,8 +15,13 @@
 #include "test/TxTests.h"
 #include "test/test.h"
 #include "transactions/TransactionUtils.h"
+#include "util/Logging.h"
 #include "util/Timer.h"
+#include "util/format.h"
 
+#include "medida/meter.h"
+
+#include <chrono>
 #include <deque>
 #include <limits>
 
@@ -4366,3 +4373,143 @@ TEST_CASE("pathpayment", "[tx][pathpayment]")
         }
     }
 }
+
+TEST_CASE("path payment apply benchmark", "[!hide][pathpaymentbench]")
+{
+    // Builds markets A0 -> A1 -> ... -> An where A0 is XLM and market i holds
+    // `depth` offers selling A(i+1) for A(i), then measures applying
+    // operations that cross `crossed` offers in each of the first `pathLength`
+    // markets (only the first one for ManageSellOffer). Every operation is
+    // rolled back, so that they all see the same order books.
+    struct Params
+    {
+        size_t depth;
+        size_t numMarkets;
+        size_t pathLength;
+        size_t crossed;
+    };
+    std::vector<Params> const allParams = {
+        {10, 1, 1, 1},    {100, 1, 1, 10},  {500, 1, 1, 100},
+        {100, 4, 1, 10},  {100, 4, 2, 10},  {100, 4, 4, 10},
+        {500, 4, 4, 100}, {100, 16, 4, 10}, {100, 16, 4, 100}};
+    int64_t const offerAmount = 1000;
+    size_t const numIterations = 100;
+
+    auto runTest = [&](Config cfg, std::string const& rootName) {
+        // invariants would dominate the time spent crossing offers
+        cfg.INVARIANT_CHECKS = {};
+
+        for (auto const& p : allParams)
+        {
+            REQUIRE(p.pathLength >= 1);
+            REQUIRE(p.pathLength <= p.numMarkets);
+            REQUIRE(p.crossed <= p.depth);
+            // sellers hold up to 2 trustlines on top of their offers
+            REQUIRE(p.depth + 2 <= ACCOUNT_SUBENTRY_LIMIT);
+
+            VirtualClock clock;
+            auto app = createTestApplication(clock, cfg);
+            auto& lm = app->getLedgerManager();
+
+            auto root = TestAccount::createRoot(*app);
+            auto issuer = root.create("issuer", lm.getLastMinBalance(100));
+            std::vector<Asset> assets{makeNativeAsset()};
+            for (size_t i = 1; i <= p.numMarkets; ++i)
+            {
+                assets.emplace_back(makeAsset(issuer, fmt::format("A{}", i)));
+            }
+
+            // offers are all at the same price, so they are crossed in the
+            // order they were created
+            for (size_t i = 0; i < p.numMarkets; ++i)
+            {
+                auto seller = root.create(fmt::format("seller{}", i),
+                                          lm.getLastMinBalance(p.depth + 100));
+                if (i > 0)
+                {
+                    seller.changeTrust(assets[i], INT64_MAX);
+                }
+                seller.changeTrust(assets[i + 1], INT64_MAX);
+                issuer.pay(seller, assets[i + 1], p.depth * offerAmount);
+                for (size_t k = 0; k < p.depth; ++k)
+                {
+                    seller.manageOffer(0, assets[i + 1], assets[i],
+                                       Price{1, 1}, offerAmount);
+                }
+            }
+
+            auto amount = static_cast<int64_t>(p.crossed) * offerAmount;
+            auto sender = root.create(
+                "sender", lm.getLastMinBalance(100) + 1000 * amount);
+            sender.changeTrust(assets[1], INT64_MAX);
+            auto dest = root.create("dest", lm.getLastMinBalance(100));
+            dest.changeTrust(assets[p.pathLength], INT64_MAX);
+
+            std::vector<Asset> path(assets.begin() + 1,
+                                    assets.begin() + p.pathLength);
+            auto const& destAsset = assets[p.pathLength];
+            std::vector<std::pair<std::string, Operation>> const ops = {
+                {"PathPaymentStrictReceive",
+                 pathPayment(dest, assets[0], amount, destAsset, amount,
+                             path)},
+                {"PathPaymentStrictSend",
+                 pathPaymentStrictSend(dest, assets[0], amount, destAsset,
+                                       amount, path)},
+                {"ManageSellOffer",
+                 manageOffer(0, assets[0], assets[1], Price{1, 1}, amount)}};
+
+            auto& queryMeter = app->getDatabase().getQueryMeter();
+            for (auto const& op : ops)
+            {
+                std::chrono::nanoseconds applyTime{0};
+                uint64_t numQueries = 0;
+                for (size_t i = 0; i < numIterations; ++i)
+                {
+                    auto tx = sender.tx({op.second},
+                                        sender.getLastSequenceNumber() + 1);
+                    LedgerTxn ltx(app->getLedgerTxnRoot());
+                    tx->processFeeSeqNum(ltx,
+                                         ltx.loadHeader().current().baseFee);
+
+                    TransactionMeta meta(2);
+                    auto queriesBefore = queryMeter.count();
+                    auto start = std::chrono::steady_clock::now();
+                    REQUIRE(tx->apply(*app, ltx, meta));
+                    applyTime += std::chrono::steady_clock::now() - start;
+                    numQueries += queryMeter.count() - queriesBefore;
+                }
+
+                auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    applyTime);
+                CLOG(INFO, "Tx") << fmt::format(
+                    "{} on {} root, depth {}, {} markets, path length {}, {} "
+                    "offers crossed per market: {} us and {} queries per op",
+                    op.first, rootName, p.depth, p.numMarkets, p.pathLength,
+                    p.crossed, us.count() / numIterations,
+                    static_cast<double>(numQueries) / numIterations);
+            }
+        }
+    };
+
+    SECTION("in-memory")
+    {
+        auto cfg = getTestConfig();
+        cfg.NODE_IS_VALIDATOR = false;
+        cfg.FORCE_SCP = false;
+        cfg.MODE_USES_IN_MEMORY_LEDGER = true;
+        cfg.MODE_STORES_HISTORY = false;
+        runTest(cfg, "in-memory");
+    }
+
+    SECTION("sqlite")
+    {
+        runTest(getTestConfig(0, Config::TESTDB_ON_DISK_SQLITE), "sqlite");
+    }
+
+#ifdef USE_POSTGRES
+    SECTION("postgresql")
+    {
+        runTest(getTestConfig(0, Config::TESTDB_POSTGRESQL), "postgresql");
+    }
+#endif
+}
@@ -19,9 +19,11 @@
 #include "test/test.h"
 #include "transactions/ChangeTrustOpFrame.h"
 #include "transactions/MergeOpFrame.h"
+#include "transactions/PathPaymentStrictReceiveOpFrame.h"
 #include "transactions/PaymentOpFrame.h"
 #include "transactions/TransactionUtils.h"
 #include "util/Logging.h"
+#include "util/Math.h"
 #include "util/Timer.h"
 
 using namespace stellar;
@@ -2216,3 +2218,126 @@ TEST_CASE("payment fees", "[tx][payment]")
         }
     }
 }
+
+TEST_CASE("native payment matches path payment", "[tx][payment]")
+{
+    // Native payments are applied without building the equivalent path
+    // payment, which must not change their results nor their meta.
+    VirtualClock clock;
+    auto cfg = getTestConfig();
+    // random liabilities do not match any offer
+    cfg.INVARIANT_CHECKS = {};
+    auto app = createTestApplication(clock, cfg);
+
+    auto source = getAccount("source");
+    auto dest = getAccount("dest");
+    auto native = makeNativeAsset();
+
+    auto randomAmount = []() {
+        switch (rand_uniform(0, 2))
+        {
+        case 0:
+            return rand_uniform<int64_t>(0, 1000000000);
+        case 1:
+            return rand_uniform<int64_t>(0, INT64_MAX);
+        default:
+            return INT64_MAX - rand_uniform<int64_t>(0, 1000000000);
+        }
+    };
+
+    auto createAccount = [&](AbstractLedgerTxn& ltx, SecretKey const& key) {
+        LedgerEntry le;
+        le.data.type(ACCOUNT);
+        auto& acc = le.data.account();
+        acc.accountID = key.getPublicKey();
+        acc.balance = randomAmount();
+        acc.seqNum = 1;
+        acc.numSubEntries = rand_uniform<uint32_t>(0, 5);
+        acc.thresholds[0] = 1;
+        if (rand_flip())
+        {
+            acc.ext.v(1);
+            acc.ext.v1().liabilities.buying =
+                rand_flip() ? 0 : rand_uniform<int64_t>(0, INT64_MAX);
+            acc.ext.v1().liabilities.selling =
+                rand_flip() ? 0 : rand_uniform<int64_t>(0, acc.balance);
+        }
+        ltx.create(le);
+    };
+
+    auto pathPaymentToPaymentCode = [](PathPaymentStrictReceiveResultCode c) {
+        switch (c)
+        {
+        case PATH_PAYMENT_STRICT_RECEIVE_SUCCESS:
+            return PAYMENT_SUCCESS;
+        case PATH_PAYMENT_STRICT_RECEIVE_MALFORMED:
+            return PAYMENT_MALFORMED;
+        case PATH_PAYMENT_STRICT_RECEIVE_UNDERFUNDED:
+            return PAYMENT_UNDERFUNDED;
+        case PATH_PAYMENT_STRICT_RECEIVE_NO_DESTINATION:
+            return PAYMENT_NO_DESTINATION;
+        case PATH_PAYMENT_STRICT_RECEIVE_LINE_FULL:
+            return PAYMENT_LINE_FULL;
+        default:
+            FAIL("unexpected path payment result " << c);
+            return PAYMENT_MALFORMED;
+        }
+    };
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        LedgerTxn ltx(app->getLedgerTxnRoot());
+        ltx.loadHeader().current().ledgerVersion = rand_uniform<uint32_t>(
+            1, Config::CURRENT_LEDGER_PROTOCOL_VERSION);
+        createAccount(ltx, source);
+        if (rand_uniform(0, 3) != 0)
+        {
+            createAccount(ltx, dest);
+        }
+        auto amount = rand_uniform(0, 5) == 0 ? 0 : randomAmount();
+
+        auto apply = [&](Operation const& op) {
+            auto tx = transactionFromOperationsV0(*app, source, 2, {op}, 100);
+            LedgerTxn ltxTx(ltx);
+            tx->processFeeSeqNum(ltxTx, ltxTx.loadHeader().current().baseFee);
+            TransactionMeta meta(2);
+            tx->apply(*app, ltxTx, meta);
+            return std::make_pair(tx->getResult(), meta);
+        };
+        auto paid = apply(payment(dest.getPublicKey(), amount));
+        auto expected = apply(pathPayment(dest.getPublicKey(), native, amount,
+                                          native, amount, {}));
+
+        REQUIRE(paid.second == expected.second);
+        REQUIRE(paid.first.feeCharged == expected.first.feeCharged);
+
+        auto code = expected.first.result.code();
+        if (amount > 0 && code == txFAILED &&
+            expected.first.result.results()[0].code() == opINNER &&
+            PathPaymentStrictReceiveOpFrame::getInnerCode(
+                expected.first.result.results()[0]) ==
+                PATH_PAYMENT_STRICT_RECEIVE_MALFORMED)
+        {
+            // payments report path payment failures that cannot happen to
+            // valid payments as internal errors
+            REQUIRE(paid.first.result.code() == txINTERNAL_ERROR);
+            continue;
+        }
+
+        REQUIRE(paid.first.result.code() == code);
+        if (code != txSUCCESS && code != txFAILED)
+        {
+            continue;
+        }
+        auto const& paidOp = paid.first.result.results()[0];
+        auto const& expectedOp = expected.first.result.results()[0];
+        REQUIRE(paidOp.code() == expectedOp.code());
+        if (expectedOp.code() == opINNER)
+        {
+            REQUIRE(PaymentOpFrame::getInnerCode(paidOp) ==
+                    pathPaymentToPaymentCode(
+                        PathPaymentStrictReceiveOpFrame::getInnerCode(
+                            expectedOp)));
+        }
+    }
+}
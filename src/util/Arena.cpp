@@ -0,0 +1,98 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/Arena.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace stellar
+{
+
+namespace
+{
+size_t const ALIGNMENT = alignof(std::max_align_t);
+size_t const MIN_CHUNK_SIZE = 4 * 1024;
+size_t const MAX_CHUNK_SIZE = 1024 * 1024;
+
+size_t
+roundUp(size_t size)
+{
+    size = std::max(size, sizeof(void*));
+    return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+}
+
+size_t const Arena::MAX_BLOCK_SIZE = 1024;
+
+Arena::Arena() : mNextChunkSize(MIN_CHUNK_SIZE)
+{
+}
+
+Arena::SizeClass&
+Arena::getSizeClass(size_t size)
+{
+    // There are only a handful of distinct sizes, so a linear search is
+    // faster than any map
+    for (auto& sc : mSizeClasses)
+    {
+        if (sc.mSize == size)
+        {
+            return sc;
+        }
+    }
+    mSizeClasses.push_back({size, nullptr});
+    return mSizeClasses.back();
+}
+
+void*
+Arena::allocate(size_t size)
+{
+    size = roundUp(size);
+    assert(size <= MAX_BLOCK_SIZE);
+
+    auto& sc = getSizeClass(size);
+    if (sc.mFree)
+    {
+        auto block = sc.mFree;
+        sc.mFree = block->mNext;
+        return block;
+    }
+
+    if (static_cast<size_t>(mEnd - mNext) < size)
+    {
+        // Whatever is left of the current chunk is wasted, which is at most
+        // MAX_BLOCK_SIZE per chunk
+        mChunks.emplace_back(new unsigned char[mNextChunkSize]);
+        mNext = mChunks.back().get();
+        mEnd = mNext + mNextChunkSize;
+        mNextChunkSize = std::min(mNextChunkSize * 2, MAX_CHUNK_SIZE);
+    }
+    auto res = mNext;
+    mNext += size;
+    return res;
+}
+
+void
+Arena::deallocate(void* p, size_t size)
+{
+    auto& sc = getSizeClass(roundUp(size));
+    auto block = static_cast<FreeBlock*>(p);
+    block->mNext = sc.mFree;
+    sc.mFree = block;
+}
+
+size_t
+Arena::reservedBytes() const
+{
+    size_t total = 0;
+    size_t chunkSize = MIN_CHUNK_SIZE;
+    for (size_t i = 0; i < mChunks.size(); ++i)
+    {
+        total += chunkSize;
+        chunkSize = std::min(chunkSize * 2, MAX_CHUNK_SIZE);
+    }
+    return total;
+}
+}
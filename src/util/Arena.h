@@ -0,0 +1,128 @@
+#pragma once
+
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/NonCopyable.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace stellar
+{
+
+// Hands out small blocks of memory by bumping a pointer through chunks that
+// grow geometrically, and recycles freed blocks through a free list per block
+// size. The chunks are only released, all at once, when the Arena is
+// destroyed. This suits trees of short-lived objects of a few distinct sizes
+// (such as the entries of a LedgerTxn tree), which otherwise pay for a heap
+// allocation each and fragment the heap.
+//
+// An Arena is not thread-safe.
+class Arena : public NonMovableOrCopyable
+{
+    struct FreeBlock
+    {
+        FreeBlock* mNext;
+    };
+
+    struct SizeClass
+    {
+        size_t mSize;
+        FreeBlock* mFree;
+    };
+
+    std::vector<SizeClass> mSizeClasses;
+    std::vector<std::unique_ptr<unsigned char[]>> mChunks;
+    unsigned char* mNext{nullptr};
+    unsigned char* mEnd{nullptr};
+    size_t mNextChunkSize;
+
+    SizeClass& getSizeClass(size_t size);
+
+  public:
+    // Blocks larger than this are allocated on the heap.
+    static size_t const MAX_BLOCK_SIZE;
+
+    Arena();
+
+    void* allocate(size_t size);
+    void deallocate(void* p, size_t size);
+
+    // Total size of the chunks allocated so far.
+    size_t reservedBytes() const;
+};
+
+// Standard allocator allocating single objects from an Arena, for use with
+// std::allocate_shared and node-based containers. Arrays (such as the buckets
+// of a hash map) and allocators without an Arena use the heap. Every
+// allocation keeps the Arena alive, so objects may outlive the code that
+// created the Arena, at the price of keeping all of its chunks alive.
+template <typename T> class ArenaAllocator
+{
+    template <typename U> friend class ArenaAllocator;
+
+    std::shared_ptr<Arena> mArena;
+
+    bool
+    useArena(size_t n) const
+    {
+        return mArena && n == 1 && sizeof(T) <= Arena::MAX_BLOCK_SIZE;
+    }
+
+  public:
+    typedef T value_type;
+
+    ArenaAllocator() = default;
+
+    explicit ArenaAllocator(std::shared_ptr<Arena> arena)
+        : mArena(std::move(arena))
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(ArenaAllocator<U> const& other) : mArena(other.mArena)
+    {
+    }
+
+    T*
+    allocate(size_t n)
+    {
+        if (useArena(n))
+        {
+            return static_cast<T*>(mArena->allocate(sizeof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T* p, size_t n)
+    {
+        if (useArena(n))
+        {
+            mArena->deallocate(p, sizeof(T));
+        }
+        else
+        {
+            ::operator delete(p);
+        }
+    }
+
+    template <typename U>
+    bool
+    operator==(ArenaAllocator<U> const& other) const
+    {
+        return mArena == other.mArena;
+    }
+
+    template <typename U>
+    bool
+    operator!=(ArenaAllocator<U> const& other) const
+    {
+        return mArena != other.mArena;
+    }
+};
+}
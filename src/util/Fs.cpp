@@ -8,6 +8,7 @@
 #include "util/FileSystemException.h"
 #include "util/Logging.h"
 
+#include <fstream>
 #include <map>
 #include <regex>
 #include <sstream>
@@ -146,6 +147,12 @@ mkdir(std::string const& name)
     return b;
 }
 
+bool
+hardLink(std::string const& from, std::string const& to)
+{
+    return CreateHardLinkA(to.c_str(), from.c_str(), NULL) != 0;
+}
+
 void
 deltree(std::string const& d)
 {
@@ -303,6 +310,12 @@ mkdir(std::string const& name)
     return b;
 }
 
+bool
+hardLink(std::string const& from, std::string const& to)
+{
+    return link(from.c_str(), to.c_str()) == 0;
+}
+
 namespace
 {
 
@@ -416,6 +429,43 @@ mkpath(const std::string& path)
     return true;
 }
 
+void
+linkOrCopyFile(std::string const& from, std::string const& to)
+{
+    std::remove(to.c_str());
+    if (hardLink(from, to))
+    {
+        return;
+    }
+
+    std::ifstream in(from, std::ifstream::binary);
+    if (!in)
+    {
+        throw FileSystemException("failed to open " + from);
+    }
+    std::ofstream out(to, std::ofstream::binary | std::ofstream::trunc);
+    if (!out)
+    {
+        throw FileSystemException("failed to open " + to);
+    }
+    std::vector<char> buf(256 * 1024);
+    while (in)
+    {
+        in.read(buf.data(), buf.size());
+        if (in.bad())
+        {
+            throw FileSystemException("failed to read " + from);
+        }
+        out.write(buf.data(), in.gcount());
+    }
+    out.close();
+    if (!out)
+    {
+        std::remove(to.c_str());
+        throw FileSystemException("failed to write " + to);
+    }
+}
+
 std::string
 hexStr(uint32_t checkpointNum)
 {
@@ -43,6 +43,14 @@ bool mkdir(std::string const& path);
 // Make a dir path like mkdir -p, i.e. recursive, uses '/' as dir separator
 bool mkpath(std::string const& path);
 
+// Make `to` a hard link to the file `from`. Returns false if that is not
+// possible, e.g. when they are on different filesystems.
+bool hardLink(std::string const& from, std::string const& to);
+
+// Replace `to` with a hard link to `from`, falling back to a copy of it when
+// linking is not possible. Throws FileSystemException on failure.
+void linkOrCopyFile(std::string const& from, std::string const& to);
+
 // Get list of all files with names matching predicate
 // Returned names are relative to path
 std::vector<std::string>
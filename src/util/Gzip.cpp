@@ -0,0 +1,276 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/Gzip.h"
+#include "crypto/ByteSlice.h"
+#include "crypto/SHA.h"
+#include "util/format.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <zlib.h>
+
+namespace stellar
+{
+namespace gzip
+{
+
+namespace
+{
+size_t const BUFFER_SIZE = 256 * 1024;
+
+// zlib's window bits: 15 is the maximum window size, +16 selects the gzip
+// format (rather than raw zlib) both when compressing and decompressing
+int const GZIP_WINDOW_BITS = 15 + 16;
+
+void
+fail(std::string const& what, std::string const& file, int ret,
+     z_stream const* strm = nullptr)
+{
+    throw std::runtime_error(fmt::format(
+        "{} {}: {}", what, file,
+        (strm && strm->msg) ? strm->msg : std::to_string(ret)));
+}
+
+class Files
+{
+    std::string const& mInName;
+    std::string const& mOutName;
+    bool mDone{false};
+
+  public:
+    std::ifstream mIn;
+    std::ofstream mOut;
+
+    Files(std::string const& in, std::string const& out)
+        : mInName(in), mOutName(out)
+    {
+        mIn.open(in, std::ifstream::binary);
+        if (!mIn)
+        {
+            throw std::runtime_error("failed to open " + in);
+        }
+        mOut.open(out, std::ofstream::binary | std::ofstream::trunc);
+        if (!mOut)
+        {
+            throw std::runtime_error("failed to open " + out);
+        }
+    }
+
+    ~Files()
+    {
+        if (!mDone)
+        {
+            mOut.close();
+            std::remove(mOutName.c_str());
+        }
+    }
+
+    size_t
+    read(std::vector<unsigned char>& buf)
+    {
+        mIn.read(reinterpret_cast<char*>(buf.data()), buf.size());
+        if (mIn.bad())
+        {
+            throw std::runtime_error("failed to read " + mInName);
+        }
+        return static_cast<size_t>(mIn.gcount());
+    }
+
+    void
+    write(unsigned char const* data, size_t size)
+    {
+        mOut.write(reinterpret_cast<char const*>(data), size);
+        if (!mOut)
+        {
+            throw std::runtime_error("failed to write " + mOutName);
+        }
+    }
+
+    void
+    finish()
+    {
+        mOut.close();
+        if (!mOut)
+        {
+            throw std::runtime_error("failed to close " + mOutName);
+        }
+        mDone = true;
+    }
+};
+}
+
+void
+compressFile(std::string const& in, std::string const& out)
+{
+    Files files(in, out);
+    std::vector<unsigned char> inBuf(BUFFER_SIZE);
+    std::vector<unsigned char> outBuf(BUFFER_SIZE);
+
+    z_stream strm{};
+    int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                           GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK)
+    {
+        fail("failed to initialize compression of", in, ret, &strm);
+    }
+
+    try
+    {
+        int flush;
+        do
+        {
+            strm.avail_in = static_cast<uInt>(files.read(inBuf));
+            strm.next_in = inBuf.data();
+            flush = files.mIn.eof() ? Z_FINISH : Z_NO_FLUSH;
+            do
+            {
+                strm.avail_out = static_cast<uInt>(outBuf.size());
+                strm.next_out = outBuf.data();
+                ret = deflate(&strm, flush);
+                if (ret == Z_STREAM_ERROR)
+                {
+                    fail("failed to compress", in, ret, &strm);
+                }
+                files.write(outBuf.data(), outBuf.size() - strm.avail_out);
+            } while (strm.avail_out == 0);
+        } while (flush != Z_FINISH);
+        files.finish();
+    }
+    catch (...)
+    {
+        deflateEnd(&strm);
+        throw;
+    }
+    deflateEnd(&strm);
+}
+
+Compressor::Compressor(FILE* out, std::string const& name)
+    : mStream(std::make_unique<z_stream>())
+    , mOut(out)
+    , mName(name)
+    , mBuf(BUFFER_SIZE)
+{
+    int ret = deflateInit2(mStream.get(), Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                           GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK)
+    {
+        fail("failed to initialize compression of", mName, ret,
+             mStream.get());
+    }
+}
+
+Compressor::~Compressor()
+{
+    deflateEnd(mStream.get());
+}
+
+void
+Compressor::deflateTo(int flush)
+{
+    do
+    {
+        mStream->avail_out = static_cast<uInt>(mBuf.size());
+        mStream->next_out = mBuf.data();
+        int ret = deflate(mStream.get(), flush);
+        if (ret == Z_STREAM_ERROR)
+        {
+            fail("failed to compress", mName, ret, mStream.get());
+        }
+        size_t have = mBuf.size() - mStream->avail_out;
+        if (fwrite(mBuf.data(), 1, have, mOut) != have)
+        {
+            throw std::runtime_error("failed to write " + mName);
+        }
+    } while (mStream->avail_out == 0);
+}
+
+void
+Compressor::write(void const* data, size_t size)
+{
+    mStream->next_in =
+        const_cast<unsigned char*>(static_cast<unsigned char const*>(data));
+    mStream->avail_in = static_cast<uInt>(size);
+    deflateTo(Z_NO_FLUSH);
+}
+
+void
+Compressor::finish()
+{
+    mStream->avail_in = 0;
+    deflateTo(Z_FINISH);
+}
+
+void
+decompressFile(std::string const& in, std::string const& out, SHA256* hasher)
+{
+    Files files(in, out);
+    std::vector<unsigned char> inBuf(BUFFER_SIZE);
+    std::vector<unsigned char> outBuf(BUFFER_SIZE);
+
+    z_stream strm{};
+    int ret = inflateInit2(&strm, GZIP_WINDOW_BITS);
+    if (ret != Z_OK)
+    {
+        fail("failed to initialize decompression of", in, ret, &strm);
+    }
+
+    try
+    {
+        // like gzip, accept files made of several concatenated gzip members
+        bool inMember = false;
+        bool sawMember = false;
+        size_t n;
+        while ((n = files.read(inBuf)) != 0)
+        {
+            strm.avail_in = static_cast<uInt>(n);
+            strm.next_in = inBuf.data();
+            do
+            {
+                if (!inMember)
+                {
+                    if (strm.avail_in == 0)
+                    {
+                        break;
+                    }
+                    inflateReset(&strm);
+                    inMember = true;
+                    sawMember = true;
+                }
+                strm.avail_out = static_cast<uInt>(outBuf.size());
+                strm.next_out = outBuf.data();
+                ret = inflate(&strm, Z_NO_FLUSH);
+                if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+                {
+                    fail("failed to decompress", in, ret, &strm);
+                }
+                size_t have = outBuf.size() - strm.avail_out;
+                files.write(outBuf.data(), have);
+                if (hasher)
+                {
+                    hasher->add(ByteSlice(outBuf.data(), have));
+                }
+                if (ret == Z_STREAM_END)
+                {
+                    inMember = false;
+                }
+            } while (strm.avail_in != 0 || strm.avail_out == 0);
+        }
+        if (inMember || !sawMember)
+        {
+            fail("truncated gzip file", in, Z_DATA_ERROR);
+        }
+        files.finish();
+    }
+    catch (...)
+    {
+        inflateEnd(&strm);
+        throw;
+    }
+    inflateEnd(&strm);
+}
+}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct z_stream_s;
+
+namespace stellar
+{
+
+class SHA256;
+
+// In-process replacements for `gzip -c` and `gzip -dc`, streaming through
+// fixed size buffers. They throw std::runtime_error on I/O or format errors,
+// in which case the (partial) output file is removed.
+namespace gzip
+{
+
+// Writes the gzip compressed content of `in` to `out`.
+void compressFile(std::string const& in, std::string const& out);
+
+// Writes the decompressed content of the gzip file `in` to `out`. If
+// `hasher` is not null, the decompressed content is also added to it, so
+// that callers can verify it without reading `out` again.
+void decompressFile(std::string const& in, std::string const& out,
+                    SHA256* hasher = nullptr);
+
+// Gzip compresses data as it is written, appending the compressed stream to
+// `out` (which remains owned by the caller), so that producers can write
+// a .gz file directly rather than compressing a plain file afterwards.
+// `name` is only used in error messages.
+class Compressor
+{
+    std::unique_ptr<z_stream_s> mStream;
+    FILE* mOut;
+    std::string const mName;
+    std::vector<unsigned char> mBuf;
+
+    void deflateTo(int flush);
+
+  public:
+    Compressor(FILE* out, std::string const& name);
+    ~Compressor();
+
+    void write(void const* data, size_t size);
+
+    // Writes the end of the gzip stream, after which nothing can be written.
+    void finish();
+};
+}
+}
@@ -8,6 +8,7 @@
 #include "crypto/SHA.h"
 #include "util/FileSystemException.h"
 #include "util/Fs.h"
+#include "util/Gzip.h"
 #include "util/Logging.h"
 #include "xdrpp/marshal.h"
 
@@ -121,14 +122,18 @@ class XDRInputFileStream
 
 // XDROutputStream needs access to a file descriptor to do
 // fsync, so we use cstdio here rather than fstreams.
+// If constructed with `gzip`, the file is written gzip compressed.
 class XDROutputFileStream
 {
     FILE* mOut{nullptr};
     std::vector<char> mBuf;
     const bool mFsyncOnClose;
+    const bool mGzip;
+    std::unique_ptr<gzip::Compressor> mCompressor;
 
   public:
-    XDROutputFileStream(bool fsyncOnClose) : mFsyncOnClose(fsyncOnClose)
+    XDROutputFileStream(bool fsyncOnClose, bool gzip = false)
+        : mFsyncOnClose(fsyncOnClose), mGzip(gzip)
     {
     }
 
@@ -148,6 +153,11 @@ class XDROutputFileStream
             FileSystemException::failWith(
                 "XDROutputFileStream::close() on non-open FILE*");
         }
+        if (mCompressor)
+        {
+            mCompressor->finish();
+            mCompressor.reset();
+        }
         if (fflush(mOut) != 0)
         {
             FileSystemException::failWithErrno(
@@ -179,6 +189,11 @@ class XDROutputFileStream
             FileSystemException::failWithErrno(
                 "XDROutputFileStream::fdopen() failed");
         }
+        if (mGzip)
+        {
+            mCompressor = std::make_unique<gzip::Compressor>(
+                mOut, "fd " + std::to_string(fd));
+        }
     }
 
     void
@@ -211,6 +226,10 @@ class XDROutputFileStream
                 std::string("XDROutputFileStream::open(\"") + filename +
                 "\") failed: ");
         }
+        if (mGzip)
+        {
+            mCompressor = std::make_unique<gzip::Compressor>(mOut, filename);
+        }
     }
 
     operator bool() const
@@ -247,7 +266,11 @@ class XDROutputFileStream
         xdr::xdr_put p(mBuf.data() + 4, mBuf.data() + 4 + sz);
         xdr_argpack_archive(p, t);
 
-        if (fwrite(mBuf.data(), 1, sz + 4, mOut) != sz + 4)
+        if (mCompressor)
+        {
+            mCompressor->write(mBuf.data(), sz + 4);
+        }
+        else if (fwrite(mBuf.data(), 1, sz + 4, mOut) != sz + 4)
         {
             FileSystemException::failWithErrno(
                 "XDROutputFileStream::writeOne() failed:");
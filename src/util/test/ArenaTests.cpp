@@ -0,0 +1,90 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "lib/catch.hpp"
+#include "util/Arena.h"
+
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace stellar;
+
+TEST_CASE("arena reuses freed blocks", "[arena]")
+{
+    Arena arena;
+    auto a = arena.allocate(40);
+    auto b = arena.allocate(40);
+    REQUIRE(a != b);
+    auto reserved = arena.reservedBytes();
+    REQUIRE(reserved > 0);
+
+    arena.deallocate(a, 40);
+    REQUIRE(arena.allocate(40) == a);
+
+    // a block of another size class is not reused
+    arena.deallocate(b, 40);
+    REQUIRE(arena.allocate(200) != b);
+    REQUIRE(arena.allocate(40) == b);
+    REQUIRE(arena.reservedBytes() == reserved);
+}
+
+TEST_CASE("arena grows by chunks", "[arena]")
+{
+    Arena arena;
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        blocks.emplace_back(arena.allocate(Arena::MAX_BLOCK_SIZE));
+    }
+    REQUIRE(arena.reservedBytes() >= 10000 * Arena::MAX_BLOCK_SIZE);
+    REQUIRE(arena.reservedBytes() < 11000 * Arena::MAX_BLOCK_SIZE);
+}
+
+TEST_CASE("arena allocator", "[arena]")
+{
+    auto arena = std::make_shared<Arena>();
+
+    SECTION("node based container")
+    {
+        ArenaAllocator<int> alloc(arena);
+        std::list<int, ArenaAllocator<int>> l(alloc);
+        for (int i = 0; i < 1000; ++i)
+        {
+            l.push_back(i);
+        }
+        auto reserved = arena->reservedBytes();
+        REQUIRE(reserved > 0);
+        l.clear();
+        for (int i = 0; i < 1000; ++i)
+        {
+            l.push_back(i);
+        }
+        REQUIRE(arena->reservedBytes() == reserved);
+    }
+
+    SECTION("objects outlive the allocator")
+    {
+        std::weak_ptr<Arena> weak = arena;
+        auto s = std::allocate_shared<std::string>(
+            ArenaAllocator<std::string>(arena), "outlives");
+        arena.reset();
+        REQUIRE(!weak.expired());
+        REQUIRE(*s == "outlives");
+        s.reset();
+        REQUIRE(weak.expired());
+    }
+
+    SECTION("large objects use the heap")
+    {
+        struct Large
+        {
+            char mData[2 * 1024];
+        };
+        ArenaAllocator<Large> alloc(arena);
+        auto p = alloc.allocate(1);
+        alloc.deallocate(p, 1);
+        REQUIRE(arena->reservedBytes() == 0);
+    }
+}
@@ -0,0 +1,139 @@
+// Copyright 2020 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "crypto/Hex.h"
+#include "crypto/Random.h"
+#include "crypto/SHA.h"
+#include "lib/catch.hpp"
+#include "util/Fs.h"
+#include "util/Gzip.h"
+#include "util/TmpDir.h"
+#include "util/XDRStream.h"
+#include "xdr/Stellar-types.h"
+
+#include <fstream>
+#include <iterator>
+
+using namespace stellar;
+
+namespace
+{
+void
+writeFile(std::string const& name, std::vector<uint8_t> const& content,
+          std::ios_base::openmode mode = std::ofstream::trunc)
+{
+    std::ofstream out(name, std::ofstream::binary | mode);
+    out.write(reinterpret_cast<char const*>(content.data()), content.size());
+}
+
+std::vector<uint8_t>
+readFile(std::string const& name)
+{
+    std::ifstream in(name, std::ifstream::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                                std::istreambuf_iterator<char>());
+}
+}
+
+TEST_CASE("gzip round trip", "[gzip]")
+{
+    TmpDirManager tdm(std::string("gzip-test-") + binToHex(randomBytes(8)));
+    TmpDir dir = tdm.tmpDir("gzip");
+    auto plain = dir.getName() + "/file.xdr";
+    auto compressed = plain + ".gz";
+    auto decompressed = dir.getName() + "/out.xdr";
+
+    // larger than the internal buffers, and compressible
+    auto content = randomBytes(1000000);
+    content.insert(content.end(), 1000000, 'x');
+    writeFile(plain, content);
+
+    SECTION("compress then decompress")
+    {
+        gzip::compressFile(plain, compressed);
+        REQUIRE(fs::size(compressed) < content.size());
+
+        auto hasher = SHA256::create();
+        gzip::decompressFile(compressed, decompressed, hasher.get());
+        REQUIRE(readFile(decompressed) == content);
+        REQUIRE(hasher->finish() == sha256(content));
+    }
+
+    SECTION("concatenated members")
+    {
+        gzip::compressFile(plain, compressed);
+        writeFile(compressed, readFile(compressed), std::ofstream::app);
+        gzip::decompressFile(compressed, decompressed);
+
+        auto twice = content;
+        twice.insert(twice.end(), content.begin(), content.end());
+        REQUIRE(readFile(decompressed) == twice);
+    }
+
+    SECTION("empty file")
+    {
+        writeFile(plain, {});
+        gzip::compressFile(plain, compressed);
+        gzip::decompressFile(compressed, decompressed);
+        REQUIRE(readFile(decompressed).empty());
+    }
+
+    SECTION("corrupt input fails and leaves no output")
+    {
+        gzip::compressFile(plain, compressed);
+        auto gz = readFile(compressed);
+
+        SECTION("truncated")
+        {
+            gz.resize(gz.size() / 2);
+        }
+        SECTION("not gzip")
+        {
+            gz = content;
+        }
+        writeFile(compressed, gz);
+        REQUIRE_THROWS_AS(gzip::decompressFile(compressed, decompressed),
+                          std::runtime_error);
+        REQUIRE(!fs::exists(decompressed));
+    }
+
+    SECTION("missing input")
+    {
+        REQUIRE_THROWS_AS(gzip::compressFile(plain + ".nope", compressed),
+                          std::runtime_error);
+        REQUIRE_THROWS_AS(gzip::decompressFile(compressed, decompressed),
+                          std::runtime_error);
+    }
+}
+
+TEST_CASE("gzip compressed XDR output stream", "[gzip]")
+{
+    TmpDirManager tdm(std::string("gzip-test-") + binToHex(randomBytes(8)));
+    TmpDir dir = tdm.tmpDir("gzip");
+    auto plain = dir.getName() + "/file.xdr";
+    auto compressed = dir.getName() + "/stream.xdr.gz";
+    auto decompressed = dir.getName() + "/out.xdr";
+
+    std::vector<Hash> entries(100000);
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        // half random, half compressible
+        entries[i] = i % 2 ? sha256(std::to_string(i)) : Hash{};
+    }
+
+    {
+        XDROutputFileStream plainOut(false), gzOut(false, true);
+        plainOut.open(plain);
+        gzOut.open(compressed);
+        for (auto const& e : entries)
+        {
+            plainOut.writeOne(e);
+            gzOut.writeOne(e);
+        }
+    }
+
+    REQUIRE(fs::size(compressed) < fs::size(plain));
+    gzip::decompressFile(compressed, decompressed);
+    REQUIRE(readFile(decompressed) == readFile(plain));
+}
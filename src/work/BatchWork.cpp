@@ -67,7 +67,7 @@ BatchWork::addMoreWorkIfNeeded()
         throw std::runtime_error(getName() + " is being aborted!");
     }
 
-    int nChildren = mApp.getConfig().MAX_CONCURRENT_SUBPROCESSES;
+    size_t nChildren = getMaxBatchSize();
     while (mBatch.size() < nChildren && hasNext())
     {
         auto w = yieldMoreWork();
@@ -80,4 +80,10 @@ BatchWork::addMoreWorkIfNeeded()
         mBatch.insert(std::make_pair(w->getName(), w));
     }
 }
+
+size_t
+BatchWork::getMaxBatchSize() const
+{
+    return static_cast<size_t>(mApp.getConfig().MAX_CONCURRENT_SUBPROCESSES);
+}
 }